@@ -3,43 +3,889 @@
 #include <unordered_set>  // std::unordered_set
 #include <string_view>  // std::string_view
 #include <stdlib.h> // EXIT_SUCCESS, EXIT_FAILURE
-#include <algorithm>    // std::min
+#include <algorithm>    // std::min, std::any_of, std::sort, std::unique
+#include <cmath>    // std::abs, std::pow
+#include <cstdint>  // std::uint64_t
+#include <functional>   // std::function
+#include <fstream>
+#include <map>
+#include <numeric>  // std::iota
+#include <sstream>  // std::ostringstream
+#include <utility>  // std::move
+#include <vector>
 
 #include <boost/program_options.hpp>    // boost::program_options
 #include <opencv2/imgproc.hpp>  // CV_RGB
 
 #include "math/mathlib.hpp"
 #include "graph/graphlib.hpp"
+#include "graph/displaylistlib.hpp"
+#include "graph/svglib.hpp"
+#include "graph/tilelib.hpp"
+#include "coordinate/dlalib.hpp"
+#include "coordinate/reiterlib.hpp"
 #include "coordinate/generatorlib.hpp"
 #include "coordinate/vectorlib.hpp"
 #include "helper/fmtlib.hpp"
 #include "helper/consolelib.hpp"
+#include "helper/threadlib.hpp"
+#include "helper/pipelinelib.hpp"
+#include "helper/filelib.hpp"
+#include "helper/poollib.hpp"
+#include "helper/packlib.hpp"
+#include "helper/jsonlib.hpp"
+#include "helper/profilelib.hpp"
+#include "helper/cachelib.hpp"
+#include "helper/streamlib.hpp"
 
 namespace po = boost::program_options;
 
-#define ROWS 1024
-#define COLS 1024
-#define CENTER (ROWS/2)
+// the largest image rendered on a single canvas (larger ones are rendered strip by strip)
+#define MAX_CANVAS_SIZE 8192
 
 #define PI 3.14159265
 #define DEG_TO_RAD(deg) ((deg) * PI / 180.0 )
 
+// random streams of every image
+#define PARAMETER_STREAM 0
+#define GEOMETRY_STREAM 1
+
+// the version of the rendered images in the render cache keys (bump it whenever the output of a snowflake changes)
+#define RENDER_VERSION 1
+
+// the default size limit of the render cache in MB
+#define DEFAULT_CACHE_SIZE 1024
+
+// the largest relative difference between a replayed parameter and the manifest (which keeps JSON_PRECISION digits)
+#define REPLAY_TOLERANCE 1e-9
+
+// the largest distance between a particle of a DLA snowflake and the center in world units
+#define DLA_MAX_RADIUS (0.45 * WORLD_SIZE)
+
+// the distance between the edge of the lattice of a Reiter snowflake and the center in world units
+#define REITER_MAX_RADIUS (0.45 * WORLD_SIZE)
+
+// a Reiter snowflake is mature once it reaches this fraction of its lattice, or after this many steps
+#define REITER_MATURITY 0.9
+#define REITER_MAX_STEPS 20000
+
 #define DEBUG_MODE 0
 
+/// @brief Named numbers, e.g. the parameters of a snowflake or the settings of their distributions
+using NamedValues = std::vector<std::pair<std::string, double>>;
+
+/// @brief The parameters a snowflake has been drawn with
+struct Parameters
+{
+    std::string label;      // the text put on the image
+    NamedValues values;     // the exact values (for the manifest)
+};
+
+/// @brief The arm of a Crystal snowflake, which a growth animation draws a few circles at a time
+struct Growth
+{
+    std::vector<Circle> arm;    // the circles in the order they grow
+    Vector mirror;
+};
+
+/// @brief A type of snowflake selected by the user
+struct SnowflakeType
+{
+    std::string option;     // the name on the command line
+    std::string name;       // the prefix of the filenames
+    NamedValues settings;   // the distributions of the parameters (for the manifest)
+    std::function<Parameters(Rasterizer&, unsigned int)> draw;      // records the i-th snowflake and returns its parameters
+    std::function<Parameters(unsigned int, Growth&)> grow = nullptr;    // samples the i-th snowflake for a growth animation (empty if it cannot grow)
+};
+
+/// @brief An image of a manifest
+struct ManifestEntry
+{
+    unsigned int index = 0;     // the index of the image (which keys its random streams)
+    std::string filename;       // the file (or the entry of the pack file) without the output directory
+    NamedValues parameters;
+};
+
+/// @brief Everything needed to render any image of a batch again: the settings of the run and the parameters of every image
+struct Manifest
+{
+    std::uint64_t seed = 0;
+    std::string type;           // the option of the snowflake type
+    int size = WORLD_SIZE;
+    std::string format;
+    std::string backend;
+    bool mask = false;
+    bool symmetric = false;
+    NamedValues settings;       // see SnowflakeType
+    std::vector<ManifestEntry> entries;
+};
+
+/// @brief Writes named values as the members of a JSON object
+void WriteNamedValues(JsonWriter& json, const NamedValues& values)
+{
+    json.BeginObject();
+    for (const auto& [name, value] : values)
+    {
+        json.Key(name).Value(value);
+    }
+    json.EndObject();
+}
+
+/// @brief Reads the members of a JSON object as named values
+bool ReadNamedValues(const JsonValue* object, NamedValues& values)
+{
+    if (!object || object->type != JsonValue::Type::Object)
+        return false;
+
+    values.clear();
+    for (const auto& [name, value] : object->members)
+    {
+        if (value.type != JsonValue::Type::Number)
+            return false;
+        values.emplace_back(name, value.number);
+    }
+
+    return true;
+}
+
+/// @brief Overrides a setting with its value in a manifest (if it is there)
+/// @param settings the settings of the manifest
+/// @param name the name of the setting
+/// @param value the setting
+template<typename T>
+void LoadSetting(const NamedValues& settings, const std::string& name, T& value)
+{
+    for (const auto& [key, setting] : settings)
+    {
+        if (key == name)
+            value = static_cast<T>(setting);
+    }
+}
+
+/// @brief Formats named values as a JSON object
+std::string ToJson(const NamedValues& values)
+{
+    std::ostringstream text;
+    JsonWriter json(text);
+    WriteNamedValues(json, values);
+    return text.str();
+}
+
+/// @brief The prefix of the render cache keys of a batch, which is followed by the index of an image
+///
+/// The parameters of an image are a function of the type, its settings, the seed and the index (which keys its random
+/// streams), so the key is made of those and a hit costs no sampling at all.
+/// @param type the type of snowflake
+/// @param seed the seed
+/// @param symmetric whether only one wedge is drawn
+/// @param size the number of rows and columns of the images
+/// @param format the output format
+/// @param backend the raster backend
+/// @param mask whether the images are masks
+/// @return the prefix
+std::string CacheKeyPrefix(const SnowflakeType& type, const std::uint64_t seed, const bool symmetric, const int size, const std::string& format, const std::string& backend, const bool mask)
+{
+    std::ostringstream key;
+    key.precision(17);
+    key << "snowflakes " << RENDER_VERSION << " " << type.option;
+    for (const auto& [name, value] : type.settings)
+    {
+        key << " " << name << "=" << value;
+    }
+    key << " seed=" << seed << " symmetric=" << symmetric << " size=" << size << " format=" << format << " raster=" << backend << " mask=" << mask << " index=";
+    return key.str();
+}
+
+/// @brief Checks if two images have been drawn with the same parameters (up to the precision of the manifest)
+/// @param a the parameters of image A
+/// @param b the parameters of image B
+/// @return true if the names and values are the same
+bool IsSameParameters(const NamedValues& a, const NamedValues& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].first != b[i].first || std::abs(a[i].second - b[i].second) > REPLAY_TOLERANCE * std::max(1.0, std::abs(a[i].second)))
+            return false;
+    }
+
+    return true;
+}
+
+/// @brief Saves a manifest as JSON Lines: the settings of the run on the first line and then one image per line
+/// @param filename the filename
+/// @param manifest the manifest
+/// @param error the reason if the file could not be written
+/// @return true if the file has been written successfully
+bool WriteManifest(const std::string& filename, const Manifest& manifest, std::string& error)
+{
+    std::ostringstream text;
+    JsonWriter header(text);
+    header.BeginObject().Key("seed").Value(manifest.seed).Key("type").Value(manifest.type).Key("size").Value(manifest.size);
+    header.Key("format").Value(manifest.format).Key("raster").Value(manifest.backend).Key("mask").Value(manifest.mask);
+    header.Key("symmetric").Value(manifest.symmetric).Key("settings");
+    WriteNamedValues(header, manifest.settings);
+    header.EndObject();
+    text << '\n';
+
+    for (const ManifestEntry& entry : manifest.entries)
+    {
+        JsonWriter json(text);
+        json.BeginObject().Key("index").Value(entry.index).Key("file").Value(entry.filename).Key("parameters");
+        WriteNamedValues(json, entry.parameters);
+        json.EndObject();
+        text << '\n';
+    }
+
+    const std::string bytes = text.str();
+    return WriteFile(filename, std::vector<unsigned char>(bytes.begin(), bytes.end()), error);
+}
+
+/// @brief Loads a manifest saved by WriteManifest
+/// @param filename the filename
+/// @param manifest the manifest
+/// @param error the reason if the file could not be read
+/// @return true if the file has been read successfully
+bool ReadManifest(const std::string& filename, Manifest& manifest, std::string& error)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    std::string line;
+    JsonValue value;
+    for (unsigned int lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        if (!ParseJson(line, value, error))
+        {
+            error = filename + ":" + std::to_string(lineNumber) + ": " + error;
+            return false;
+        }
+
+        const std::string where = filename + ":" + std::to_string(lineNumber) + ": ";
+        auto find = [&value](const std::string& key, const JsonValue::Type type)
+        {
+            const JsonValue* member = value.Find(key);
+            return (member && member->type == type) ? member : nullptr;
+        };
+
+        // the settings of the run
+        if (lineNumber == 1)
+        {
+            const JsonValue* seed = find("seed", JsonValue::Type::Number);
+            const JsonValue* type = find("type", JsonValue::Type::String);
+            const JsonValue* size = find("size", JsonValue::Type::Number);
+            const JsonValue* format = find("format", JsonValue::Type::String);
+            const JsonValue* backend = find("raster", JsonValue::Type::String);
+            const JsonValue* mask = find("mask", JsonValue::Type::Bool);
+            const JsonValue* symmetric = find("symmetric", JsonValue::Type::Bool);
+            if (!seed || seed->text.find_first_not_of("0123456789") != std::string::npos || !type || !size || !format || !backend || !mask || !symmetric || !ReadNamedValues(value.Find("settings"), manifest.settings))
+            {
+                error = where + "not the header of a manifest";
+                return false;
+            }
+
+            // NOTE: the seed is read from its literal since a double cannot hold every 64-bit integer
+            manifest.seed = std::stoull(seed->text);
+            manifest.type = type->text;
+            manifest.size = static_cast<int>(size->number);
+            manifest.format = format->text;
+            manifest.backend = backend->text;
+            manifest.mask = mask->boolean;
+            manifest.symmetric = symmetric->boolean;
+            continue;
+        }
+
+        ManifestEntry entry;
+        const JsonValue* index = find("index", JsonValue::Type::Number);
+        const JsonValue* name = find("file", JsonValue::Type::String);
+        if (!index || !name || !ReadNamedValues(value.Find("parameters"), entry.parameters))
+        {
+            error = where + "not an image of a manifest";
+            return false;
+        }
+
+        entry.index = static_cast<unsigned int>(index->number);
+        entry.filename = name->text;
+        manifest.entries.push_back(std::move(entry));
+    }
+
+    if (manifest.type.empty())
+    {
+        error = filename + ": empty manifest";
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief A file on its way through the output pipeline: a canvas to encode or bytes that are ready to be written
+struct OutputFile
+{
+    unsigned int index = 0;     // the position of the image in the batch
+    std::string filename;
+    BufferPool::Handle canvas;  // the pixels of img
+    cv::Mat img;
+    std::vector<unsigned char> bytes;
+    std::int64_t started = 0;   // the time the image was started (see PROFILE_LATENCY)
+    std::string cacheKey;       // the key in the render cache (empty if the file is not to be cached)
+    std::string parameters;     // the parameters of the image for the render cache
+};
+
+/// @brief Encodes the canvas of a file for the writer and gives the canvas back to the pool (see Pipeline)
+/// @param file the file with a canvas (or the bytes that are ready to be written)
+/// @param encoded the file with the encoded bytes
+/// @param format the output format ("jpg" or "png")
+/// @param stream the stream of the files (nullptr for none), which takes the canvases of a raw stream as they are
+/// @param error the error message
+/// @return true if the canvas has been encoded
+bool EncodeOutputFile(OutputFile& file, OutputFile& encoded, const std::string& format, const FrameStream* stream, std::string& error)
+{
+    encoded.index = file.index;
+    encoded.started = file.started;
+    encoded.cacheKey = std::move(file.cacheKey);
+    encoded.parameters = std::move(file.parameters);
+    encoded.filename = std::move(file.filename);
+    encoded.bytes = std::move(file.bytes);
+    if (stream && stream->IsRaw())
+    {
+        encoded.img = file.img;
+        encoded.canvas = std::move(file.canvas);
+        return true;
+    }
+
+    const bool isEncoded = file.img.empty() || EncodeImage(file.img, "." + format, encoded.bytes, error);
+
+    // gives the canvas back to the pool
+    file.img.release();
+    file.canvas.Reset();
+
+    if (!isEncoded)
+        error = encoded.filename + ": " + error;
+
+    return isEncoded;
+}
+
+/// @brief Writes a file to a stream
+/// @param stream the stream
+/// @param file the file (the canvas of a raw stream or the encoded bytes)
+/// @param error the error message
+/// @return true if the file has been written
+bool WriteToStream(FrameStream& stream, const OutputFile& file, std::string& error)
+{
+    if (stream.IsRaw())
+        return stream.WriteFrame(file.img.data, file.img.rows, file.img.cols, file.img.channels(), file.img.step, error);
+
+    return stream.WriteEncoded(file.bytes, error);
+}
+
+/// @brief Renders, labels and saves a batch of snowflakes on up to numJobs threads (plus as many encoder threads and one writer thread)
+/// @param snowflakeName the name of the snowflake (prefix of the filenames)
+/// @param outputDir the output directory
+/// @param indices the indices of the images
+/// @param numJobs the number of threads
+/// @param format the output format ("jpg", "png" or "svg")
+/// @param backend the raster backend (see MakeRasterizer)
+/// @param mask renders into a single-channel canvas and saves grayscale images
+/// @param size the number of rows and columns of the images
+/// @param pack appends the images to a single pack file instead of writing one file per image
+/// @param draw records the i-th snowflake on the given canvas and returns its parameters
+/// @param entries the images for the manifest (in the order of the indices)
+/// @param cache the render cache (nullptr for none)
+/// @param cacheKey the prefix of the keys of the images in the cache (see CacheKeyPrefix)
+/// @param stream writes the images to the stream in their order instead of writing files (nullptr for files)
+/// @return true if all files have been saved successfully
+bool RenderBatch(const std::string& snowflakeName, const std::string& outputDir, const std::vector<unsigned int>& indices, const unsigned int numJobs, const std::string& format, const std::string& backend, const bool mask, const int size, const bool pack, const std::function<Parameters(Rasterizer&, unsigned int)>& draw, std::vector<ManifestEntry>& entries, RenderCache* cache, const std::string& cacheKey, FrameStream* stream)
+{
+    // the images keep their filenames (and random streams) when a few of them are rendered again
+    const unsigned int numImages = static_cast<unsigned int>(indices.size());
+    entries.assign(numImages, ManifestEntry());
+    auto nameOf = [&](const unsigned int render)
+    {
+        return snowflakeName + "_" + std::to_string(render + 1) + "." + format;
+    };
+
+    // the snowflakes are recorded in world units and scaled to the size of the image when they are rasterized
+    const double scale = static_cast<double>(size) / WORLD_SIZE;
+    auto rasterize = [&](const DisplayList& list, cv::Mat& img)
+    {
+        PROFILE_SCOPE("rasterize");
+        if (size == WORLD_SIZE)
+            list.Execute(*MakeRasterizer(img, backend));
+        else
+            list.Execute(*MakeRasterizer(img, backend), scale, Vector(0, 0));
+    };
+
+    #if DEBUG_MODE
+
+        // records the snowflake
+        DisplayList list(WORLD_SIZE, WORLD_SIZE);
+        const std::string label = draw(list, indices.empty() ? 0 : indices.front()).label;
+
+        // creates a black canvas and rasterizes the snowflake on it
+        cv::Mat img(size, size, mask ? CV_8UC1 : CV_8UC3, CV_RGB(0, 0, 0));
+        rasterize(list, img);
+
+        // put parameters on the image
+        PutLabel(img, label);
+
+        DisplayImage(snowflakeName, img);
+
+        return true;
+
+    #else
+
+        // an image too large for one canvas is rasterized strip by strip (in parallel) and streamed to its file, so the
+        // images are rendered one after another
+        if (size > MAX_CANVAS_SIZE)
+        {
+            DisplayList list(WORLD_SIZE, WORLD_SIZE);
+            for (unsigned int i = 0; i < numImages; ++i)
+            {
+                const unsigned int render = indices[i];
+                [[maybe_unused]] const std::int64_t started = PROFILE_NOW();
+                list.Clear();
+                PROFILE_BEGIN(recording, "record");
+                entries[i] = {render, nameOf(render), draw(list, render).values};
+                PROFILE_END(recording);
+
+                std::string error;
+                if (!RenderTiledPng(list, size, mask ? 1 : 3, backend == "native-aa", outputDir + "/" + entries[i].filename, numJobs, error))
+                {
+                    std::cerr << error << "\n";
+                    return false;
+                }
+                PROFILE_LATENCY("image", started);
+            }
+
+            return true;
+        }
+
+        // rendering, encoding and writing overlap: the render threads hand their canvases to the encoder threads, which
+        // hand the encoded files to one writer thread
+        // NOTE: the queues are bounded, so the renderers wait (instead of piling up canvases) if the encoders or the disk fall behind
+        // NOTE: the canvases are recycled (and zeroed) once they have been encoded instead of being allocated for every image
+        // NOTE: a mask only has one byte per pixel, which cuts the memory traffic of rasterizing and encoding about 3x
+        // NOTE: a pack file or a stream takes the images in their order, so it is the same for any number of jobs; the
+        // writer holds the images that are done early until the ones before them arrive
+        // NOTE: a raw stream takes the canvases without encoding them, and they go back to the pool once written
+        PackWriter packFile;
+        std::map<unsigned int, OutputFile> pending;
+        unsigned int next = 0;
+        if (pack)
+        {
+            std::string error;
+            if (!packFile.Open(outputDir + "/" + snowflakeName + ".pack", error))
+            {
+                std::cerr << error << "\n";
+                return false;
+            }
+        }
+
+        const int channels = mask ? 1 : 3;
+        BufferPool canvases(static_cast<std::size_t>(size) * size * channels);
+        Pipeline<OutputFile, OutputFile> pipeline(numJobs, 2 * numJobs,
+            [&format, stream](OutputFile& file, OutputFile& encoded, std::string& error)
+            {
+                return EncodeOutputFile(file, encoded, format, stream, error);
+            },
+            [&](OutputFile& file, std::string& error)
+            {
+                PROFILE_SCOPE("write");
+
+                // NOTE: the cache takes a hard link to the written file, so it costs no extra copy; a file that could
+                // not be cached is only rendered again next time
+                std::string cacheError;
+                if (!pack && !stream)
+                {
+                    if (!WriteFile(file.filename, file.bytes, error))
+                        return false;
+                    if (!file.cacheKey.empty() && !cache->Store(file.cacheKey, file.filename, file.parameters, cacheError))
+                        std::cerr << cacheError << "\n";
+                    PROFILE_LATENCY("image", file.started);
+                    return true;
+                }
+
+                if (!file.cacheKey.empty() && !cache->Store(file.cacheKey, file.bytes, file.parameters, cacheError))
+                    std::cerr << cacheError << "\n";
+
+                pending.emplace(file.index, std::move(file));
+                for (auto itr = pending.find(next); itr != pending.end(); itr = pending.find(next))
+                {
+                    const OutputFile& ordered = itr->second;
+                    if (stream ? !WriteToStream(*stream, ordered, error) : !packFile.Append(ordered.filename, ordered.bytes, error))
+                        return false;
+                    PROFILE_LATENCY("image", ordered.started);
+                    pending.erase(itr);
+                    ++next;
+                }
+                return true;
+            });
+
+        ParallelFor(numImages, numJobs, [&](unsigned int i)
+        {
+            // skips the remaining images once one of them has failed
+            if (pipeline.HasFailed())
+                return;
+
+            const unsigned int render = indices[i];
+            const std::int64_t started = PROFILE_NOW();
+
+            // takes the file from the cache if it has been rendered before
+            // NOTE: the entries of a pack file are named after the files they replace
+            OutputFile file;
+            file.index = i;
+            file.started = started;
+            file.filename = pack ? nameOf(render) : outputDir + "/" + nameOf(render);
+            if (cache)
+            {
+                file.cacheKey = cacheKey + std::to_string(render);
+                const bool isHit = pack ? cache->Fetch(file.cacheKey, file.bytes, file.parameters) : cache->Fetch(file.cacheKey, file.filename, file.parameters);
+                JsonValue value;
+                std::string error;
+                if (isHit && ParseJson(file.parameters, value, error) && ReadNamedValues(&value, entries[i].parameters))
+                {
+                    entries[i].index = render;
+                    entries[i].filename = nameOf(render);
+                    file.cacheKey.clear();
+                    if (pack)
+                        pipeline.Submit(std::move(file));
+                    else
+                        PROFILE_LATENCY("image", started);
+                    return;
+                }
+            }
+
+            // records the snowflake
+            // NOTE: the list keeps its buffers, so every thread records all of its images without allocating
+            static thread_local DisplayList list(WORLD_SIZE, WORLD_SIZE);
+            list.Clear();
+            PROFILE_BEGIN(recording, "record");
+            Parameters parameters = draw(list, render);
+            PROFILE_END(recording);
+            const std::string& label = parameters.label;
+            entries[i] = {render, nameOf(render), std::move(parameters.values)};
+            if (cache)
+                file.parameters = ToJson(entries[i].parameters);
+
+            // writes the primitives straight to the file without rasterizing them
+            // NOTE: an SVG file is in world units and scales to any size by itself
+            if (format == "svg")
+            {
+                PROFILE_BEGIN(writing, "write svg");
+                std::ostringstream svg;
+                WriteSvg(svg, list, label);
+                const std::string text = svg.str();
+                file.bytes.assign(text.begin(), text.end());
+                PROFILE_END(writing);
+                pipeline.Submit(std::move(file));
+                return;
+            }
+
+            // takes a black canvas from the pool and rasterizes the snowflake on it
+            file.canvas = canvases.Acquire();
+            file.img = cv::Mat(size, size, mask ? CV_8UC1 : CV_8UC3, file.canvas.Data());
+            rasterize(list, file.img);
+
+            // put parameters on the image
+            PutLabel(file.img, label);
+
+            // hands the image to the encoders
+            pipeline.Submit(std::move(file));
+        });
+
+        // waits for the encoders and the writer
+        bool canSave = pipeline.Finish();
+        for (const std::string& error : pipeline.Errors())
+        {
+            std::cerr << error << "\n";
+        }
+
+        // writes the index of the pack file
+        std::string error;
+        if (pack && canSave && !packFile.Close(error))
+        {
+            std::cerr << error << "\n";
+            canSave = false;
+        }
+
+        return canSave;
+
+    #endif
+}
+
+/// @brief Renders a growth animation of every snowflake of a batch and saves the frames as numbered images or writes
+/// them to a stream
+/// @param snowflakeName the name of the snowflake (prefix of the filenames)
+/// @param outputDir the output directory
+/// @param indices the indices of the snowflakes
+/// @param numFrames the number of frames of every snowflake
+/// @param numJobs the number of threads
+/// @param format the output format ("jpg" or "png")
+/// @param backend the raster backend (see MakeRasterizer)
+/// @param mask renders into a single-channel canvas and saves grayscale images
+/// @param size the number of rows and columns of the frames
+/// @param grow samples the arm of the i-th snowflake and returns its parameters
+/// @param stream writes the frames to the stream in their order instead of writing files (nullptr for files)
+/// @return true if all frames have been saved successfully
+bool RenderAnimation(const std::string& snowflakeName, const std::string& outputDir, const std::vector<unsigned int>& indices, const unsigned int numFrames, const unsigned int numJobs, const std::string& format, const std::string& backend, const bool mask, const int size, const std::function<Parameters(unsigned int, Growth&)>& grow, FrameStream* stream)
+{
+    const unsigned int numImages = static_cast<unsigned int>(indices.size());
+    const double scale = static_cast<double>(size) / WORLD_SIZE;
+    auto nameOf = [&](const unsigned int render, const unsigned int frame)
+    {
+        std::string number = std::to_string(frame + 1);
+        number.insert(0, (number.size() < 4) ? 4 - number.size() : 0, '0');
+        return snowflakeName + "_" + std::to_string(render + 1) + "_" + number + "." + format;
+    };
+
+    // the frames go through the same encoders and writer as the images of a batch
+    // NOTE: a stream takes the frames in their order, so the writer holds the frames that are done early
+    const int channels = mask ? 1 : 3;
+    BufferPool frames(static_cast<std::size_t>(size) * size * channels);
+    std::map<unsigned int, OutputFile> pending;
+    unsigned int next = 0;
+    Pipeline<OutputFile, OutputFile> pipeline(numJobs, 2 * numJobs,
+        [&format, stream](OutputFile& file, OutputFile& encoded, std::string& error)
+        {
+            return EncodeOutputFile(file, encoded, format, stream, error);
+        },
+        [&](OutputFile& file, std::string& error)
+        {
+            PROFILE_SCOPE("write");
+            if (!stream)
+            {
+                if (!WriteFile(file.filename, file.bytes, error))
+                    return false;
+                PROFILE_LATENCY("frame", file.started);
+                return true;
+            }
+
+            pending.emplace(file.index, std::move(file));
+            for (auto itr = pending.find(next); itr != pending.end(); itr = pending.find(next))
+            {
+                if (!WriteToStream(*stream, itr->second, error))
+                    return false;
+                PROFILE_LATENCY("frame", itr->second.started);
+                pending.erase(itr);
+                ++next;
+            }
+            return true;
+        });
+
+    // the frames of a snowflake build on each other, so every snowflake grows on one thread
+    // NOTE: a stream renders the snowflakes one after another, so the writer holds the frames of one snowflake at most
+    ParallelFor(numImages, stream ? 1 : numJobs, [&](unsigned int i)
+    {
+        const unsigned int render = indices[i];
+
+        // samples the whole arm once: the frames only differ by how many of its circles have grown
+        Growth growth;
+        const std::string label = grow(render, growth).label;
+        const std::size_t numCircles = growth.arm.size();
+
+        // every frame records the circles grown since the previous frame and rasterizes them onto the same canvas
+        cv::Mat canvas(size, size, mask ? CV_8UC1 : CV_8UC3, CV_RGB(0, 0, 0));
+        const std::unique_ptr<Rasterizer> rasterizer = MakeRasterizer(canvas, backend);
+        DisplayList list(WORLD_SIZE, WORLD_SIZE);
+        std::size_t numDrawn = 0;
+        for (unsigned int frame = 0; frame < numFrames; ++frame)
+        {
+            // skips the remaining frames once one of them has failed
+            if (pipeline.HasFailed())
+                return;
+
+            OutputFile file;
+            file.index = i * numFrames + frame;
+            file.started = PROFILE_NOW();
+            file.filename = outputDir + "/" + nameOf(render, frame);
+
+            const std::size_t numGrown = (static_cast<std::size_t>(frame) + 1) * numCircles / numFrames;
+            list.Clear();
+            DrawCrystalGrowth(list, growth.arm, numDrawn, numGrown, growth.mirror);
+            numDrawn = numGrown;
+
+            PROFILE_BEGIN(rasterizing, "rasterize");
+            if (size == WORLD_SIZE)
+                list.Execute(*rasterizer);
+            else
+                list.Execute(*rasterizer, scale, Vector(0, 0));
+            PROFILE_END(rasterizing);
+
+            // copies the canvas to a pooled frame, which keeps the label off the canvas the next circles grow on
+            file.canvas = frames.Acquire();
+            file.img = cv::Mat(size, size, mask ? CV_8UC1 : CV_8UC3, file.canvas.Data());
+            canvas.copyTo(file.img);
+            PutLabel(file.img, label);
+
+            pipeline.Submit(std::move(file));
+        }
+    });
+
+    // waits for the encoders and the writer
+    const bool canSave = pipeline.Finish();
+    for (const std::string& error : pipeline.Errors())
+    {
+        std::cerr << error << "\n";
+    }
+
+    return canSave;
+}
+
+/// @brief Renders a batch of snowflakes (cycling through the types) into the cells of atlas pages and saves the pages
+/// with a JSON index of the UV rectangles and the parameters of every snowflake
+/// @param types the types of snowflake
+/// @param outputDir the output directory
+/// @param numImages the number of snowflakes
+/// @param numJobs the number of threads
+/// @param format the format of the pages ("jpg" or "png")
+/// @param backend the raster backend (see MakeRasterizer)
+/// @param mask renders into single-channel pages
+/// @param cellSize the number of rows and columns of a cell
+/// @param pageSize the maximum number of rows and columns of a page
+/// @param seed the seed of the batch (for the index)
+/// @return true if all files have been saved successfully
+bool RenderAtlas(const std::vector<SnowflakeType>& types, const std::string& outputDir, const unsigned int numImages, const unsigned int numJobs, const std::string& format, const std::string& backend, const bool mask, const int cellSize, const int pageSize, const std::uint64_t seed)
+{
+    const unsigned int cellsPerRow = pageSize / cellSize;
+    const unsigned int cellsPerPage = cellsPerRow * cellsPerRow;
+    const unsigned int numPages = (numImages + cellsPerPage - 1) / cellsPerPage;
+    const double scale = static_cast<double>(cellSize) / WORLD_SIZE;
+
+    std::ostringstream index;
+    JsonWriter json(index);
+    json.BeginObject().Key("seed").Value(seed).Key("cellSize").Value(cellSize).Key("pages").BeginArray();
+
+    std::vector<NamedValues> parameters(numImages);
+    std::vector<unsigned char> bytes;
+    std::string error;
+    for (unsigned int page = 0; page < numPages; ++page)
+    {
+        // the last page only has the rows of cells it needs
+        const unsigned int first = page * cellsPerPage;
+        const unsigned int numCells = std::min(cellsPerPage, numImages - first);
+        const int rows = static_cast<int>((numCells + cellsPerRow - 1) / cellsPerRow) * cellSize;
+        const int cols = static_cast<int>(std::min(numCells, cellsPerRow)) * cellSize;
+        cv::Mat img(rows, cols, mask ? CV_8UC1 : CV_8UC3, CV_RGB(0, 0, 0));
+
+        // the cells do not overlap, so every snowflake is rasterized straight into its cell in parallel
+        ParallelFor(numCells, numJobs, [&](unsigned int cell)
+        {
+            const unsigned int render = first + cell;
+            [[maybe_unused]] const std::int64_t started = PROFILE_NOW();
+            static thread_local DisplayList list(WORLD_SIZE, WORLD_SIZE);
+            list.Clear();
+            PROFILE_BEGIN(recording, "record");
+            parameters[render] = types[render % types.size()].draw(list, render).values;
+            PROFILE_END(recording);
+
+            PROFILE_BEGIN(rasterizing, "rasterize");
+            cv::Mat view = img(cv::Rect((cell % cellsPerRow) * cellSize, (cell / cellsPerRow) * cellSize, cellSize, cellSize));
+            list.Execute(*MakeRasterizer(view, backend), scale, Vector(0, 0));
+            PROFILE_END(rasterizing);
+            PROFILE_LATENCY("sprite", started);
+        });
+
+        PROFILE_SCOPE("write page");
+        const std::string filename = "Snowflake-Atlas_" + std::to_string(page + 1) + "." + format;
+        if (!EncodeImage(img, "." + format, bytes, error) || !WriteFile(outputDir + "/" + filename, bytes, error))
+        {
+            std::cerr << filename << ": " << error << "\n";
+            return false;
+        }
+
+        json.BeginObject().Key("file").Value(filename).Key("width").Value(cols).Key("height").Value(rows).EndObject();
+    }
+
+    // the UV rectangle of a cell is in [0, 1] relative to its page with v going down like the rows
+    json.EndArray().Key("sprites").BeginArray();
+    for (unsigned int render = 0; render < numImages; ++render)
+    {
+        const unsigned int page = render / cellsPerPage, cell = render % cellsPerPage;
+        const unsigned int numCells = std::min(cellsPerPage, numImages - page * cellsPerPage);
+        const double rows = static_cast<double>((numCells + cellsPerRow - 1) / cellsPerRow) * cellSize;
+        const double cols = static_cast<double>(std::min(numCells, cellsPerRow)) * cellSize;
+        const int x = (cell % cellsPerRow) * cellSize, y = (cell / cellsPerRow) * cellSize;
+
+        json.BeginObject().Key("index").Value(render).Key("type").Value(types[render % types.size()].option).Key("page").Value(page);
+        json.Key("x").Value(x).Key("y").Value(y);
+        json.Key("uv").BeginArray().Value(x / cols).Value(y / rows).Value((x + cellSize) / cols).Value((y + cellSize) / rows).EndArray();
+        json.Key("parameters");
+        WriteNamedValues(json, parameters[render]);
+        json.EndObject();
+    }
+    json.EndArray().EndObject();
+
+    const std::string text = index.str();
+    if (!WriteFile(outputDir + "/Snowflake-Atlas.json", std::vector<unsigned char>(text.begin(), text.end()), error))
+    {
+        std::cerr << error << "\n";
+        return false;
+    }
+
+    return true;
+}
+
 int main(int argc, char* argv[])
 {
-    std::string selectedSnowflake;
+    std::vector<std::string> selectedSnowflakes;
     std::string outputDir;
     unsigned int numImages;
+    unsigned int numJobs;
+    int imageSize;
+    std::uint64_t seed;
+    std::string outputFormat;
+    std::string rasterBackend;
+    bool useSymmetry = false;
+    bool noOverlap;
+    bool useMask;
+    bool noMask;
+    bool usePack;
+    bool useAtlas;
+    int cellSize;
+    int pageSize;
+    std::string profileFile;
+    std::string replayFile;
+    std::string cacheDir;
+    std::string streamKind;
+    std::string streamPath;
+    std::uint64_t cacheSize;
+    unsigned int numFrames;
+    std::vector<unsigned int> replayIndices;
     bool useDefaultValues;
 
     // creates options descriptions and default values
     po::options_description desc("Options:");
     desc.add_options()
         ("help,h", "Display this information")
-        ("snowflake,s", po::value<std::string>(&selectedSnowflake)->value_name("<SNOWFLAKE_TYPE>")->default_value("crystal"), "the type of snowflake")
+        ("snowflake,s", po::value<std::vector<std::string>>(&selectedSnowflakes)->value_name("<SNOWFLAKE_TYPE>...")->multitoken()->default_value(std::vector<std::string>{"crystal"}, "crystal"), "the types of snowflake (an atlas mixes them)")
         ("output,o", po::value<std::string>(&outputDir)->value_name("<OUTPUT_DIR>")->default_value("outputs"), "the output directory")
         ("number,n", po::value<unsigned int>(&numImages)->value_name("<NUM_IMAGES>")->default_value(10), "number of images")
+        ("jobs,j", po::value<unsigned int>(&numJobs)->value_name("<NUM_JOBS>")->default_value(DefaultNumJobs()), "number of images rendered in parallel")
+        ("size", po::value<int>(&imageSize)->value_name("<PIXELS>")->default_value(WORLD_SIZE), "the number of rows and columns of the images (larger than 8192 is streamed to png)")
+        ("seed", po::value<std::uint64_t>(&seed)->value_name("<SEED>")->default_value(0), "the seed of the random number generator")
+        ("format", po::value<std::string>(&outputFormat)->value_name("<FORMAT>")->default_value("jpg"), "the output format (jpg, png, svg)")
+        ("raster", po::value<std::string>(&rasterBackend)->value_name("<BACKEND>")->default_value("native"), "the raster backend (opencv, native, native-aa)")
+        ("mask", po::bool_switch(&useMask), "render into a single-channel mask and save grayscale images (jpg, png); overrides the manifest given by --replay")
+        ("no-mask", po::bool_switch(&noMask), "render in color; overrides the manifest given by --replay")
+        ("pack", po::bool_switch(&usePack), "append the images to a single <OUTPUT_DIR>/<SNOWFLAKE_NAME>.pack file instead of one file per image")
+        ("atlas", po::bool_switch(&useAtlas), "render the snowflakes into the cells of atlas pages with a JSON index (jpg, png)")
+        ("cell", po::value<int>(&cellSize)->value_name("<PIXELS>")->default_value(256), "the size of an atlas cell")
+        ("page", po::value<int>(&pageSize)->value_name("<PIXELS>")->default_value(4096), "the maximum size of an atlas page")
+        ("replay", po::value<std::string>(&replayFile)->value_name("<MANIFEST>"), "render the images of a manifest again (at any size, format or raster backend)")
+        ("indices", po::value<std::vector<unsigned int>>(&replayIndices)->value_name("<INDEX>...")->multitoken(), "the indices of the images to replay (all by default)")
+        ("cache", po::value<std::string>(&cacheDir)->value_name("<CACHE_DIR>"), "reuse the images rendered by earlier runs with the same parameters (not for --atlas or images larger than 8192)")
+        ("cache-size", po::value<std::uint64_t>(&cacheSize)->value_name("<MB>")->default_value(DEFAULT_CACHE_SIZE), "the size limit of the cache, past which the least recently used images are evicted")
+        ("stream", po::value<std::string>(&streamKind)->value_name("<STREAM>"), "write the images to a stream in their order instead of files (raw, y4m, frames)")
+        ("stream-to", po::value<std::string>(&streamPath)->value_name("<PATH>")->default_value("-"), "the file or FIFO of the stream (- for stdout)")
+        ("animate", po::value<unsigned int>(&numFrames)->value_name("<NUM_FRAMES>"), "render every crystal snowflake as a growth animation of the given number of frames (jpg, png)")
+        ("profile", po::value<std::string>(&profileFile)->value_name("<FILE>"), "save the timings of the stages as a Chrome trace and print a summary of the latencies")
+        ("no-overlap", po::bool_switch(&noOverlap), "grow crystal arms whose circles never overlap each other or the symmetric copies")
         ("default,d", po::value<bool>(&useDefaultValues)->value_name("<USE_DEFUALT_VALUES>")->default_value(true), "use default values");   // (<long name>,<short name>, <argument(s)>, <description>)
 
     // creates the variables map and stores the inputs to the map
@@ -69,9 +915,59 @@ int main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
+    if (useMask && noMask)
+    {
+        std::cout << "Please select either --mask or --no-mask...\n";
+        return EXIT_FAILURE;
+    }
+
+    // takes the settings of the run from the manifest, but for the ones that only change how the images are saved
+    Manifest manifest;
+    const bool isReplaying = !replayFile.empty();
+    if (isReplaying)
+    {
+        std::string error;
+        if (!ReadManifest(replayFile, manifest, error))
+        {
+            std::cerr << error << "\n";
+            return EXIT_FAILURE;
+        }
+
+        selectedSnowflakes = {manifest.type};
+        seed = manifest.seed;
+        if (vm["mask"].defaulted() && vm["no-mask"].defaulted())
+            useMask = manifest.mask;
+        if (vm["size"].defaulted())
+            imageSize = manifest.size;
+        if (vm["format"].defaulted())
+            outputFormat = manifest.format;
+        if (vm["raster"].defaulted())
+            rasterBackend = manifest.backend;
+    }
+
+    // checks if the replayed images are in the manifest
+    std::map<unsigned int, const ManifestEntry*> recorded;
+    for (const ManifestEntry& entry : manifest.entries)
+    {
+        recorded[entry.index] = &entry;
+    }
+
+    if (!replayIndices.empty() && (!isReplaying || std::any_of(replayIndices.begin(), replayIndices.end(), [&](unsigned int index) { return recorded.find(index) == recorded.end(); })))
+    {
+        std::cout << "Invalid indices...\n";
+        std::cout << "Please select images of the manifest given by --replay\n";
+        return EXIT_FAILURE;
+    }
+
+    if (isReplaying && useAtlas)
+    {
+        std::cout << "Manifests are replayed image by image without --atlas...\n";
+        return EXIT_FAILURE;
+    }
+
     // checks if we have the user input snowflake type
-    std::unordered_set<std::string_view> snowflakeOptions({"crystal", "radiating-dendrite", "stellar-plate", "triangular-crystal"});
-    if (snowflakeOptions.find(selectedSnowflake) == snowflakeOptions.end())
+    std::unordered_set<std::string_view> snowflakeOptions({"crystal", "radiating-dendrite", "stellar-plate", "triangular-crystal", "dla", "reiter", "recursive-dendrite"});
+    if (std::any_of(selectedSnowflakes.begin(), selectedSnowflakes.end(), [&](const std::string& type) { return snowflakeOptions.find(type) == snowflakeOptions.end(); }))
     {
         std::cout << "Invalid input...\n";
         std::cout << "Please select one of the following snowflake types:\n";
@@ -84,228 +980,601 @@ int main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
-    // main programme
-    bool canSave = true;
-    if (selectedSnowflake == "crystal")
+    // checks if we have the user input output format
+    std::unordered_set<std::string_view> formatOptions({"jpg", "png", "svg"});
+    if (formatOptions.find(outputFormat) == formatOptions.end())
     {
-        // default values
-        int mean = 45;
-        double sd = 10.0;
-        int radiusHigh = 7;
-        int radiusLow = 2;
-
-        // gets inputs from the console
-        if (!useDefaultValues)
+        std::cout << "Invalid output format...\n";
+        std::cout << "Please select one of the following output formats:\n";
+        for (const auto& option : formatOptions)
         {
-            if(!GetUserInput(mean, "mean", 5, 55) || !GetUserInput(sd, "the standard deviation of the number of crystal", 0.0, 10.0) \
-            || !GetUserInput(radiusHigh, "the upper bound of the radius", 1, 10) || !GetUserInput(radiusLow, "the lower bound of the radius", 0, radiusHigh))
-            {
-                return EXIT_FAILURE;
-            }
+            std::cout << option << "\n";
         }
+        return EXIT_FAILURE;
+    }
 
-        // renders snowflakes
-        for (unsigned char render = 0; render < numImages; render++)
-        {
-            // creates a black canvas
-            cv::Mat img(ROWS, COLS, CV_8UC3, CV_RGB(0, 0, 0));
+    // checks if we have a valid image size
+    if (imageSize <= 0)
+    {
+        std::cout << "Invalid image size...\n";
+        return EXIT_FAILURE;
+    }
 
-            int numCrystals = static_cast<int>(std::max(boost_normal_distribution(mean, sd), 10.0));    // makes sure the value is at least 10
-            const Vector mirror(boost_normal_distribution(1, 0.1), boost_normal_distribution(1, 0.1));
+    // large images are streamed to PNG files strip by strip
+    if (imageSize > MAX_CANVAS_SIZE && outputFormat != "png")
+    {
+        std::cout << "Images larger than " << MAX_CANVAS_SIZE << " pixels can only be saved as png...\n";
+        return EXIT_FAILURE;
+    }
 
-            DrawCrystalSnowflake(img, numCrystals, radiusHigh, radiusLow, mirror);
+    // the strips of a large image are streamed to their own file
+    if (imageSize > MAX_CANVAS_SIZE && usePack)
+    {
+        std::cout << "Images larger than " << MAX_CANVAS_SIZE << " pixels cannot be packed...\n";
+        return EXIT_FAILURE;
+    }
 
-            const std::string snowflakeName("Crystal-Snowflake");
+    // checks if we have a valid atlas layout
+    if (useAtlas && (outputFormat == "svg" || usePack || cellSize <= 0 || cellSize > pageSize))
+    {
+        std::cout << "Atlases need a cell size between 1 and the page size and are saved as jpg or png without --pack...\n";
+        return EXIT_FAILURE;
+    }
 
-            std::string label = "mirror vec: " + mirror.ToString();
+    // checks if we have a valid stream
+    const bool isStreaming = !streamKind.empty();
+    if (isStreaming && !FrameStream::IsKind(streamKind))
+    {
+        std::cout << "Invalid stream...\n";
+        std::cout << "Please select one of the following streams:\nraw\ny4m\nframes\n";
+        return EXIT_FAILURE;
+    }
 
-            // put parameters on the image
-            PutLabel(img, label);
+    if (isStreaming && (useAtlas || usePack || imageSize > MAX_CANVAS_SIZE || (streamKind != "frames" && outputFormat == "svg")))
+    {
+        std::cout << "Streams take images of up to " << MAX_CANVAS_SIZE << " pixels without --atlas or --pack, and raw or y4m streams cannot take svg...\n";
+        return EXIT_FAILURE;
+    }
 
-            #if DEBUG_MODE
+    // checks if we have a valid animation
+    // NOTE: the frames of a snowflake are drawn onto the previous frame, so they cannot be strips, cells or SVG files
+    const bool isAnimating = vm.count("animate") > 0;
+    if (isAnimating && (numFrames == 0 || isReplaying || useAtlas || usePack || !cacheDir.empty() || outputFormat == "svg" || imageSize > MAX_CANVAS_SIZE))
+    {
+        std::cout << "Animations need at least 1 frame and are saved as jpg or png of up to " << MAX_CANVAS_SIZE << " pixels without --replay, --atlas, --pack or --cache...\n";
+        return EXIT_FAILURE;
+    }
 
-                DisplayImage("image", img);
+    // SVG files place one wedge once per arm instead of storing every primitive
+    // NOTE: only display lists keep the wedge, raster canvases always draw every primitive
+    if (outputFormat == "svg")
+        useSymmetry = true;
 
-                return EXIT_SUCCESS;
+    // checks if we have the user input raster backend
+    std::unordered_set<std::string_view> rasterOptions({"opencv", "native", "native-aa"});
+    if (rasterOptions.find(rasterBackend) == rasterOptions.end())
+    {
+        std::cout << "Invalid raster backend...\n";
+        std::cout << "Please select one of the following raster backends:\n";
+        for (const auto& option : rasterOptions)
+        {
+            std::cout << option << "\n";
+        }
+        return EXIT_FAILURE;
+    }
 
-            #else
-                // save image
-                std::string filename = snowflakeName + "_" + std::to_string(render + 1) + ".jpg";
-                canSave = SaveImage(outputDir + "/" + filename, img);
-                if (!canSave)
-                    return EXIT_FAILURE;
-            #endif
+    // the images to render: the whole batch or the ones picked from the manifest
+    // NOTE: every image has its own random streams, so an image is replayed without drawing the ones before it
+    std::vector<unsigned int> indices;
+    if (!isReplaying)
+    {
+        indices.resize(numImages);
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+    else if (replayIndices.empty())
+    {
+        for (const auto& [index, entry] : recorded)
+        {
+            indices.push_back(index);
         }
     }
-    else if (selectedSnowflake == "radiating-dendrite")
+    else
     {
-        // default values
-        int mean = 200;
-        double sd = 20.0;
+        indices = replayIndices;
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    }
 
-        // gets inputs from the console
-        if (!useDefaultValues)
+    // main programme
+    // NOTE: every image draws from its own random streams keyed by (seed, image index) so the outputs do not depend on the number of jobs
+    std::vector<SnowflakeType> types;
+    for (const std::string& selectedSnowflake : selectedSnowflakes)
+    {
+        if (selectedSnowflake == "crystal")
         {
-            if(!GetUserInput(mean, "mean", 150, 300) || !GetUserInput(sd, "the standard deviation of the number of crystal", 0.0, 30.0))
+            // default values
+            int mean = 45;
+            double sd = 10.0;
+            int radiusHigh = 7;
+            int radiusLow = 2;
+
+            // gets inputs from the manifest or the console
+            bool isCollisionFree = noOverlap;
+            if (isReplaying)
             {
-                return EXIT_FAILURE;
+                isCollisionFree = false;
+                LoadSetting(manifest.settings, "mean", mean);
+                LoadSetting(manifest.settings, "sd", sd);
+                LoadSetting(manifest.settings, "radiusHigh", radiusHigh);
+                LoadSetting(manifest.settings, "radiusLow", radiusLow);
+                LoadSetting(manifest.settings, "noOverlap", isCollisionFree);
+            }
+            else if (!useDefaultValues)
+            {
+                // NOTE: an arm that cannot overlap stays crisp with many more circles
+                if(!GetUserInput(mean, "mean", 5, isCollisionFree ? 5000 : 55) || !GetUserInput(sd, "the standard deviation of the number of crystal", 0.0, 10.0) \
+                || !GetUserInput(radiusHigh, "the upper bound of the radius", 1, 10) || !GetUserInput(radiusLow, "the lower bound of the radius", 0, radiusHigh))
+                {
+                    return EXIT_FAILURE;
+                }
             }
-        }
 
-        // renders snowflakes
-        for (unsigned char render = 0; render < numImages; render++)
-        {
-            // creates a black canvas
-            cv::Mat img(ROWS, COLS, CV_8UC3, CV_RGB(0, 0, 0));
+            // records how to draw the snowflakes
+            // NOTE: the mode is only recorded when set, so the manifests and the cache keys of the normal arms stay the same
+            NamedValues settings = {{"mean", mean}, {"sd", sd}, {"radiusHigh", radiusHigh}, {"radiusLow", radiusLow}};
+            if (isCollisionFree)
+                settings.emplace_back("noOverlap", 1);
+            auto grow = [=](unsigned int render, Growth& growth)
+            {
+                PROFILE_BEGIN(sampling, "sample parameters");
+                RandomEngine rng(seed, render, PARAMETER_STREAM);
+                RandomEngine geometryRng(seed, render, GEOMETRY_STREAM);
 
-            const Vector mirror(boost_normal_distribution(1, 0.1), boost_normal_distribution(1, 0.1));
-            const int armLength = boost_normal_distribution(mean, sd);
-            const int armWidth = boost_normal_distribution(5, 1);
-            const int nodeLength = boost_uniform_int_distribution(25, 15);    // 20
-            const int branchLength = boost_uniform_int_distribution(65, 20);    // 50
-            const double theta = DEG_TO_RAD(boost_normal_distribution(60, 10));
-            const double rate = boost_normal_distribution(0.8, 0.1);
+                int numCrystals = static_cast<int>(std::max(rng.Normal(mean, sd), 10.0));    // makes sure the value is at least 10
+                const double mirrorX = rng.Normal(1, 0.1);
+                growth.mirror = Vector(mirrorX, rng.Normal(1, 0.1));
 
-            DrawRadiatingDendriteSnowflake(img, mirror, armLength, armWidth, nodeLength, branchLength, theta, rate);
+                PROFILE_END(sampling);
+                growth.arm = isCollisionFree ? GenerateCrystalArm(numCrystals, radiusHigh, radiusLow, growth.mirror, geometryRng) : GenerateCrystalArm(numCrystals, radiusHigh, radiusLow, geometryRng);
 
-            const std::string snowflakeName("Radiating-Dendrite-Snowflake");
+                return Parameters{"mirror vec: " + growth.mirror.ToString(), {{"numCrystals", numCrystals}, {"mirrorX", growth.mirror.x}, {"mirrorY", growth.mirror.y}}};
+            };
+            types.push_back({selectedSnowflake, "Crystal-Snowflake", settings, [=](Rasterizer& canvas, unsigned int render)
+            {
+                Growth growth;
+                Parameters parameters = grow(render, growth);
+                DrawCrystalSnowflake(canvas, growth.arm, growth.mirror, useSymmetry);
+                return parameters;
+            }, grow});
+        }
+        else if (selectedSnowflake == "radiating-dendrite")
+        {
+            // default values
+            int mean = 200;
+            double sd = 20.0;
 
-            std::string label = "armLength: " + std::to_string(armLength) + " armWidth: " + std::to_string(armWidth) + " theta: " + Formatter(theta) + " rate: " + Formatter(rate);
+            // gets inputs from the manifest or the console
+            if (isReplaying)
+            {
+                LoadSetting(manifest.settings, "mean", mean);
+                LoadSetting(manifest.settings, "sd", sd);
+            }
+            else if (!useDefaultValues)
+            {
+                if(!GetUserInput(mean, "mean", 150, 300) || !GetUserInput(sd, "the standard deviation of the number of crystal", 0.0, 30.0))
+                {
+                    return EXIT_FAILURE;
+                }
+            }
 
-            // put parameters on the image
-            PutLabel(img, label);
+            // records how to draw the snowflakes
+            const NamedValues settings = {{"mean", mean}, {"sd", sd}};
+            types.push_back({selectedSnowflake, "Radiating-Dendrite-Snowflake", settings, [=](Rasterizer& canvas, unsigned int render)
+            {
+                PROFILE_BEGIN(sampling, "sample parameters");
+                RandomEngine rng(seed, render, PARAMETER_STREAM);
 
-            #if DEBUG_MODE
+                const double mirrorX = rng.Normal(1, 0.1);
+                const Vector mirror(mirrorX, rng.Normal(1, 0.1));
+                const int armLength = rng.Normal(mean, sd);
+                const int armWidth = rng.Normal(5, 1);
+                const int nodeLength = rng.UniformInt(25, 15);    // 20
+                const int branchLength = rng.UniformInt(65, 20);    // 50
+                const double theta = DEG_TO_RAD(rng.Normal(60, 10));
+                const double rate = rng.Normal(0.8, 0.1);
 
-                DisplayImage("image", img);
+                PROFILE_END(sampling);
+                DrawRadiatingDendriteSnowflake(canvas, mirror, armLength, armWidth, nodeLength, branchLength, theta, rate, useSymmetry);
 
-                return EXIT_SUCCESS;
+                const std::string label = "armLength: " + std::to_string(armLength) + " armWidth: " + std::to_string(armWidth) + " theta: " + Formatter(theta) + " rate: " + Formatter(rate);
+                return Parameters{label, {{"mirrorX", mirror.x}, {"mirrorY", mirror.y}, {"armLength", armLength}, {"armWidth", armWidth}, {"nodeLength", nodeLength}, {"branchLength", branchLength}, {"theta", theta}, {"rate", rate}}};
+            }});
+        }
+        else if (selectedSnowflake == "recursive-dendrite")
+        {
+            // default values
+            int mean = 360;
+            double sd = 30.0;
+            int depth = 5;
+            int numNodes = 4;
 
-            #else
-                std::string filename = snowflakeName + "_" + std::to_string(render + 1) + ".jpg";
-                canSave = SaveImage(outputDir + "/" + filename, img);
-                if (!canSave)
+            // gets inputs from the manifest or the console
+            if (isReplaying)
+            {
+                LoadSetting(manifest.settings, "mean", mean);
+                LoadSetting(manifest.settings, "sd", sd);
+                LoadSetting(manifest.settings, "depth", depth);
+                LoadSetting(manifest.settings, "numNodes", numNodes);
+            }
+            else if (!useDefaultValues)
+            {
+                if(!GetUserInput(mean, "mean of the arm length", 200, 450) || !GetUserInput(sd, "the standard deviation of the arm length", 0.0, 40.0) \
+                || !GetUserInput(depth, "the number of levels of branches", 1, 8) || !GetUserInput(numNodes, "the number of branch pairs per segment", 1, 8))
+                {
                     return EXIT_FAILURE;
-            #endif
-        }
-    }
-    else if (selectedSnowflake == "stellar-plate")
-    {
-        // default values
-        int motherSideMean = 100, sonSideMean = 40;
-        double motherSideSD = 30.0, sonSideSD = 10.0;
+                }
+            }
+
+            // records how to draw the snowflakes
+            const NamedValues settings = {{"mean", mean}, {"sd", sd}, {"depth", depth}, {"numNodes", numNodes}};
+            types.push_back({selectedSnowflake, "Recursive-Dendrite-Snowflake", settings, [=](Rasterizer& canvas, unsigned int render)
+            {
+                PROFILE_BEGIN(sampling, "sample parameters");
+                RandomEngine rng(seed, render, PARAMETER_STREAM);
+
+                const double vX = rng.Normal(1, 0.1);
+                const Vector v(vX, rng.Normal(1, 0.1));
+                const int armLength = rng.Normal(mean, sd);
+                const int armWidth = rng.Normal(6, 1);
+
+                // every level branches at its own angle and shrinks at its own rate
+                DendriteRule rule{depth, numNodes, std::vector<double>(depth), std::vector<double>(depth), rng.Normal(0.65, 0.05)};
+                NamedValues parameters = {{"vX", v.x}, {"vY", v.y}, {"armLength", armLength}, {"armWidth", armWidth}, {"widthDecay", rule.widthDecay}};
+                for (int level = 0; level < depth; ++level)
+                {
+                    rule.angles[level] = DEG_TO_RAD(rng.Normal(60, 8));
+                    rule.decays[level] = 0.2 + 0.12 * rng.Uniform();
+                    parameters.emplace_back("angle" + std::to_string(level + 1), rule.angles[level]);
+                    parameters.emplace_back("decay" + std::to_string(level + 1), rule.decays[level]);
+                }
+
+                PROFILE_END(sampling);
+                DrawRecursiveDendriteSnowflake(canvas, v, armLength, armWidth, rule);
 
-        // gets inputs from the console
-        if (!useDefaultValues)
+                const std::string label = "armLength: " + std::to_string(armLength) + " depth: " + std::to_string(depth) + " nodes: " + std::to_string(numNodes);
+                return Parameters{label, parameters};
+            }});
+        }
+        else if (selectedSnowflake == "stellar-plate")
         {
-            if(!GetUserInput(motherSideMean, "mean of the mother length", 150, 300) || !GetUserInput(motherSideSD, "the standard deviation of the mother length", 0.0, 30.0) || \
-            !GetUserInput(sonSideMean, "mean of the son length", 60, static_cast<int>(std::min(motherSideMean - 2 * motherSideSD, 100.0))) || !GetUserInput(sonSideSD, "the standard deviation of the son length", 0.0, 0.5 * sonSideMean))
+            // default values
+            int motherSideMean = 100, sonSideMean = 40;
+            double motherSideSD = 30.0, sonSideSD = 10.0;
+
+            // gets inputs from the manifest or the console
+            if (isReplaying)
             {
-                return EXIT_FAILURE;
+                LoadSetting(manifest.settings, "motherSideMean", motherSideMean);
+                LoadSetting(manifest.settings, "motherSideSD", motherSideSD);
+                LoadSetting(manifest.settings, "sonSideMean", sonSideMean);
+                LoadSetting(manifest.settings, "sonSideSD", sonSideSD);
+            }
+            else if (!useDefaultValues)
+            {
+                if(!GetUserInput(motherSideMean, "mean of the mother length", 150, 300) || !GetUserInput(motherSideSD, "the standard deviation of the mother length", 0.0, 30.0) || \
+                !GetUserInput(sonSideMean, "mean of the son length", 60, static_cast<int>(std::min(motherSideMean - 2 * motherSideSD, 100.0))) || !GetUserInput(sonSideSD, "the standard deviation of the son length", 0.0, 0.5 * sonSideMean))
+                {
+                    return EXIT_FAILURE;
+                }
             }
-        }
 
-        // renders snowflakes
-        for (unsigned char render = 0; render < numImages; render++)
+            // records how to draw the snowflakes
+            const NamedValues settings = {{"motherSideMean", motherSideMean}, {"motherSideSD", motherSideSD}, {"sonSideMean", sonSideMean}, {"sonSideSD", sonSideSD}};
+            types.push_back({selectedSnowflake, "Stellar-Plate-Snowflake", settings, [=](Rasterizer& canvas, unsigned int render)
+            {
+                PROFILE_BEGIN(sampling, "sample parameters");
+                RandomEngine rng(seed, render, PARAMETER_STREAM);
+
+                const double vX = rng.Normal(1, 0.1);
+                const Vector v(vX, rng.Normal(1, 0.1));
+
+                int motherSide = rng.Normal(motherSideMean, motherSideSD);
+                int sonSide = rng.Normal(sonSideMean, sonSideSD);
+
+                // makes sure motherSide is greater than sonSide
+                motherSide = (motherSide <= sonSide) ? sonSide + 10 : motherSide;
+
+                PROFILE_END(sampling);
+                DrawStellarPlateSnowflake(canvas, v.Unit(), motherSide, sonSide, useSymmetry);
+
+                return Parameters{"motherSide: " + std::to_string(motherSide) + " sonSide: " + std::to_string(sonSide), {{"vX", v.x}, {"vY", v.y}, {"motherSide", motherSide}, {"sonSide", sonSide}}};
+            }});
+        }
+        else if (selectedSnowflake == "triangular-crystal")
         {
-            // creates a black canvas
-            cv::Mat img(ROWS, COLS, CV_8UC3, CV_RGB(0, 0, 0));
+            // default values
+            int motherSideMean = 280, sonSideMean = 60, radiusMean = 40;
+            double motherSideSD = 15.0, sonSideSD = 10.0, radiusSD = 5.0;
+
+            // gets inputs from the manifest or the console
+            if (isReplaying)
+            {
+                LoadSetting(manifest.settings, "motherSideMean", motherSideMean);
+                LoadSetting(manifest.settings, "motherSideSD", motherSideSD);
+                LoadSetting(manifest.settings, "sonSideMean", sonSideMean);
+                LoadSetting(manifest.settings, "sonSideSD", sonSideSD);
+                LoadSetting(manifest.settings, "radiusMean", radiusMean);
+                LoadSetting(manifest.settings, "radiusSD", radiusSD);
+            }
+            else if (!useDefaultValues)
+            {
+                if(!GetUserInput(motherSideMean, "mean of the mother length", 180, 300) || !GetUserInput(motherSideSD, "the standard deviation of the mother length", 0.0, 25.0) || \
+                !GetUserInput(sonSideMean, "mean of the son length", 50, 60) || !GetUserInput(sonSideSD, "the standard deviation of the son length", 0.0, 10.0) || \
+                !GetUserInput(radiusMean, "mean of the radius", 20, 90) || !GetUserInput(sonSideSD, "the standard deviation of the radius", 0.0, 0.5 * radiusMean))
+                {
+                    return EXIT_FAILURE;
+                }
+            }
 
-            const Vector v(boost_normal_distribution(1, 0.1), boost_normal_distribution(1, 0.1));
+            // records how to draw the snowflakes
+            const NamedValues settings = {{"motherSideMean", motherSideMean}, {"motherSideSD", motherSideSD}, {"sonSideMean", sonSideMean}, {"sonSideSD", sonSideSD}, {"radiusMean", radiusMean}, {"radiusSD", radiusSD}};
+            types.push_back({selectedSnowflake, "Triangular-Crystal-Snowflake", settings, [=](Rasterizer& canvas, unsigned int render)
+            {
+                PROFILE_BEGIN(sampling, "sample parameters");
+                RandomEngine rng(seed, render, PARAMETER_STREAM);
 
-            int motherSide = boost_normal_distribution(motherSideMean, motherSideSD);
-            int sonSide = boost_normal_distribution(sonSideMean, sonSideSD);
+                const double vX = rng.Normal(1, 0.1);
+                const Vector v(vX, rng.Normal(1, 0.1));
 
-            // makes sure motherSide is greater than sonSide
-            motherSide = (motherSide <= sonSide) ? sonSide + 10 : motherSide;
+                int motherTriangleR = rng.Normal(motherSideMean, motherSideSD);
+                int sonTriangleR = rng.Normal(sonSideMean, sonSideSD);
+                int radius = rng.Normal(radiusMean, radiusSD);
 
-            DrawStellarPlateSnowflake(img, v.Unit(), motherSide, sonSide);
+                // runs some aesthetic checks
+                sonTriangleR = (motherTriangleR >= 4 * sonTriangleR) ? 0.25 * motherTriangleR : sonTriangleR;
+                radius = (sonTriangleR >= 2 * radius) ? 0.5 * sonTriangleR -10 : radius;
 
-            const std::string snowflakeName("Stellar-Plate-Snowflake");
+                PROFILE_END(sampling);
+                DrawTriangularCrystalSnowflake(canvas, v, motherTriangleR, sonTriangleR, radius);
 
-            std::string label = "motherSide: " + std::to_string(motherSide) + " sonSide: " + std::to_string(sonSide);
+                const std::string label = "motherTriR: " + std::to_string(motherTriangleR) + " sonTriR: " + std::to_string(sonTriangleR) + " radius: " + std::to_string(radius);
+                return Parameters{label, {{"vX", v.x}, {"vY", v.y}, {"motherTriangleR", motherTriangleR}, {"sonTriangleR", sonTriangleR}, {"radius", radius}}};
+            }});
+        }
+        else if (selectedSnowflake == "dla")
+        {
+            // default values
+            int mean = 1500;
+            double sd = 300.0;
+            int radius = 1;
 
-            // put parameters on the image
-            PutLabel(img, label);
+            // gets inputs from the manifest or the console
+            if (isReplaying)
+            {
+                LoadSetting(manifest.settings, "mean", mean);
+                LoadSetting(manifest.settings, "sd", sd);
+                LoadSetting(manifest.settings, "radius", radius);
+            }
+            else if (!useDefaultValues)
+            {
+                if(!GetUserInput(mean, "mean of the number of particles", 100, 20000) || !GetUserInput(sd, "the standard deviation of the number of particles", 0.0, 0.5 * mean) \
+                || !GetUserInput(radius, "the radius of the particles", 1, 5))
+                {
+                    return EXIT_FAILURE;
+                }
+            }
 
-            #if DEBUG_MODE
+            // the walkers of a snowflake share the threads the images of the batch leave over
+            const unsigned int walkerJobs = std::max(1u, numJobs / std::max(1u, static_cast<unsigned int>(indices.size())));
 
-                DisplayImage(snowflakeName, img);
+            // records how to draw the snowflakes
+            const NamedValues settings = {{"mean", mean}, {"sd", sd}, {"radius", radius}};
+            types.push_back({selectedSnowflake, "DLA-Snowflake", settings, [=](Rasterizer& canvas, unsigned int render)
+            {
+                PROFILE_BEGIN(sampling, "sample parameters");
+                RandomEngine rng(seed, render, PARAMETER_STREAM);
+                RandomEngine geometryRng(seed, render, GEOMETRY_STREAM);
 
-                return EXIT_SUCCESS;
+                const int numParticles = static_cast<int>(std::max(rng.Normal(mean, sd), 10.0));    // makes sure the value is at least 10
+                const double mirrorX = rng.Normal(1, 0.1);
+                const Vector mirror(mirrorX, rng.Normal(1, 0.1));
 
-            #else
+                PROFILE_END(sampling);
+                const std::vector<Vector> particles = GenerateDlaCluster(numParticles, radius, DLA_MAX_RADIUS, mirror, geometryRng, walkerJobs);
+                DrawDlaSnowflake(canvas, particles, radius, mirror, useSymmetry);
 
-                // save image
-                std::string filename = snowflakeName + "_" + std::to_string(render + 1) + ".jpg";
-                canSave = SaveImage(outputDir + "/" + filename, img);
-                if (!canSave)
+                // NOTE: the cluster stops growing at the edge of the image, so it may have fewer particles than sampled
+                const std::string label = "particles: " + std::to_string(particles.size()) + " mirror vec: " + mirror.ToString();
+                return Parameters{label, {{"numParticles", numParticles}, {"mirrorX", mirror.x}, {"mirrorY", mirror.y}}};
+            }});
+        }
+        else if (selectedSnowflake == "reiter")
+        {
+            // default values
+            int radius = 500;
+            double alpha = 1.0;
+
+            // gets inputs from the manifest or the console
+            if (isReplaying)
+            {
+                LoadSetting(manifest.settings, "radius", radius);
+                LoadSetting(manifest.settings, "alpha", alpha);
+            }
+            else if (!useDefaultValues)
+            {
+                if(!GetUserInput(radius, "the radius of the lattice in cells", 50, 1000) || !GetUserInput(alpha, "the diffusion rate", 0.5, 2.0))
+                {
                     return EXIT_FAILURE;
-            #endif
+                }
+            }
+
+            // the rows of a lattice share the threads the images of the batch leave over
+            const unsigned int latticeJobs = std::max(1u, numJobs / std::max(1u, static_cast<unsigned int>(indices.size())));
+
+            // records how to draw the snowflakes
+            const NamedValues settings = {{"radius", radius}, {"alpha", alpha}};
+            types.push_back({selectedSnowflake, "Reiter-Snowflake", settings, [=](Rasterizer& canvas, unsigned int render)
+            {
+                PROFILE_BEGIN(sampling, "sample parameters");
+                RandomEngine rng(seed, render, PARAMETER_STREAM);
+
+                // the vapour level shapes the crystal (plates to dendrites), the growth rate its fineness
+                const double beta = 0.35 + 0.3 * rng.Uniform();
+                const double gamma = std::pow(10.0, -4.0 + 1.5 * rng.Uniform());
+
+                PROFILE_END(sampling);
+                ReiterLattice lattice(radius, static_cast<float>(alpha), static_cast<float>(beta), static_cast<float>(gamma));
+                const int steps = lattice.Run(REITER_MATURITY, REITER_MAX_STEPS, latticeJobs);
+                DrawReiterSnowflake(canvas, lattice, REITER_MAX_RADIUS / lattice.Radius());
+
+                const std::string label = "beta: " + Formatter(beta) + " gamma: " + Formatter(gamma) + " steps: " + std::to_string(steps);
+                return Parameters{label, {{"beta", beta}, {"gamma", gamma}, {"steps", steps}}};
+            }});
         }
     }
-    else if (selectedSnowflake == "triangular-crystal")
+
+    // checks if every type can grow
+    if (isAnimating && std::any_of(types.begin(), types.end(), [](const SnowflakeType& type) { return !type.grow; }))
+    {
+        std::cout << "Only crystal snowflakes can be animated...\n";
+        return EXIT_FAILURE;
+    }
+
+    // times the stages of every thread from here on
+    if (!profileFile.empty())
     {
-        // default values
-        int motherSideMean = 280, sonSideMean = 60, radiusMean = 40;
-        double motherSideSD = 15.0, sonSideSD = 10.0, radiusSD = 5.0;
+        #if SNOWFLAKES_PROFILING
+            Profiler::Enable();
+        #else
+            std::cerr << "Profiling is compiled out (see the SNOWFLAKES_PROFILING option of CMake)...\n";
+        #endif
+    }
 
-        // gets inputs from the console
-        if (!useDefaultValues)
+    // opens the render cache
+    RenderCache cache;
+    if (!cacheDir.empty())
+    {
+        std::string error;
+        if (!cache.Open(cacheDir, cacheSize << 20, error))
         {
-            if(!GetUserInput(motherSideMean, "mean of the mother length", 180, 300) || !GetUserInput(motherSideSD, "the standard deviation of the mother length", 0.0, 25.0) || \
-            !GetUserInput(sonSideMean, "mean of the son length", 50, 60) || !GetUserInput(sonSideSD, "the standard deviation of the son length", 0.0, 10.0) || \
-            !GetUserInput(radiusMean, "mean of the radius", 20, 90) || !GetUserInput(sonSideSD, "the standard deviation of the radius", 0.0, 0.5 * radiusMean))
-            {
-                return EXIT_FAILURE;
-            }
+            std::cerr << error << "\n";
+            return EXIT_FAILURE;
         }
+    }
 
-        // renders snowflakes
-        for (unsigned char render = 0; render < numImages; render++)
+    // opens the stream, which the progress messages must then stay out of
+    FrameStream stream;
+    if (isStreaming)
+    {
+        std::string error;
+        if (!stream.Open(streamPath, streamKind, error))
         {
-            // creates a black canvas
-            cv::Mat img(ROWS, COLS, CV_8UC3, CV_RGB(0, 0, 0));
-
-            const Vector v(boost_normal_distribution(1, 0.1), boost_normal_distribution(1, 0.1));
-
-            int motherTriangleR = boost_normal_distribution(motherSideMean, motherSideSD);
-            int sonTriangleR = boost_normal_distribution(sonSideMean, sonSideSD);
-            int radius = boost_normal_distribution(radiusMean, radiusSD);
+            std::cerr << error << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& log = (isStreaming && streamPath == "-") ? std::cerr : std::cout;
 
-            // runs some aesthetic checks
-            sonTriangleR = (motherTriangleR >= 4 * sonTriangleR) ? 0.25 * motherTriangleR : sonTriangleR;
-            radius = (sonTriangleR >= 2 * radius) ? 0.5 * sonTriangleR -10 : radius;
+    // renders snowflakes
+    bool canSave = true;
+    if (useAtlas)
+    {
+        canSave = RenderAtlas(types, outputDir, numImages, numJobs, outputFormat, rasterBackend, useMask, cellSize, pageSize, seed);
+    }
+    else
+    {
+        for (const SnowflakeType& type : types)
+        {
+            // NOTE: the frames of an animation are not images of a manifest
+            if (isAnimating)
+            {
+                if (!RenderAnimation(type.name, outputDir, indices, numFrames, numJobs, outputFormat, rasterBackend, useMask, imageSize, type.grow, isStreaming ? &stream : nullptr))
+                    canSave = false;
+                continue;
+            }
 
-            DrawTriangularCrystalSnowflake(img, v, motherTriangleR, sonTriangleR, radius);
+            std::vector<ManifestEntry> entries;
+            // NOTE: images too large for one canvas are streamed to their files and not cached, and neither are streams
+            RenderCache* batchCache = (cache.IsOpen() && imageSize <= MAX_CANVAS_SIZE && !isStreaming) ? &cache : nullptr;
+            const std::string cacheKey = CacheKeyPrefix(type, seed, useSymmetry, imageSize, outputFormat, rasterBackend, useMask);
+            if (!RenderBatch(type.name, outputDir, indices, numJobs, outputFormat, rasterBackend, useMask, imageSize, usePack, type.draw, entries, batchCache, cacheKey, isStreaming ? &stream : nullptr))
+            {
+                canSave = false;
+                continue;
+            }
 
-            std::string snowflakeName("Triangular-Crystal-Snowflake");
+            // checks that the replayed images have been drawn with the same parameters, e.g. in case the generators
+            // have changed since the manifest was written
+            if (isReplaying)
+            {
+                for (const ManifestEntry& entry : entries)
+                {
+                    if (!IsSameParameters(entry.parameters, recorded[entry.index]->parameters))
+                    {
+                        std::cerr << entry.filename << ": the parameters differ from the manifest\n";
+                        canSave = false;
+                    }
+                }
+                continue;
+            }
 
-            std::string label = "motherTriR: " + std::to_string(motherTriangleR) + " sonTriR: " + std::to_string(sonTriangleR) + " radius: " + std::to_string(radius);
+            // records how to render every image of the batch again
+            // NOTE: a stream leaves no files behind, so it has no manifest either
+            if (isStreaming)
+                continue;
 
-            // put parameters on the image
-            PutLabel(img, label);
+            std::string error;
+            const Manifest batch = {seed, type.option, imageSize, outputFormat, rasterBackend, useMask, useSymmetry, type.settings, std::move(entries)};
+            if (!WriteManifest(outputDir + "/" + type.name + ".manifest.jsonl", batch, error))
+            {
+                std::cerr << error << "\n";
+                canSave = false;
+            }
+        }
+    }
 
-            #if DEBUG_MODE
+    // flushes the frames that are still buffered
+    std::string streamError;
+    if (!stream.Close(streamError))
+    {
+        std::cerr << streamError << "\n";
+        canSave = false;
+    }
 
-                DisplayImage(snowflakeName, img);
+    // saves the index of the render cache for the next run
+    if (cache.IsOpen())
+    {
+        log << "Cache: " << cache.Hits() << " hits, " << cache.Misses() << " misses, " << (cache.Size() >> 20) << " MB\n";
 
-                return EXIT_SUCCESS;
+        std::string error;
+        if (!cache.Close(error))
+        {
+            std::cerr << error << "\n";
+            canSave = false;
+        }
+    }
 
-            #else
-                // save image
-                std::string filename = snowflakeName + "_" + std::to_string(render + 1) + ".jpg";
-                canSave = SaveImage(outputDir + "/" + filename, img);
-                if (!canSave)
-                    return EXIT_FAILURE;
-            #endif
+    // NOTE: all threads have joined, so the timings are complete
+    if (Profiler::IsEnabled())
+    {
+        std::string error;
+        if (!Profiler::WriteTrace(profileFile, error))
+        {
+            std::cerr << error << "\n";
+            canSave = false;
         }
+
+        Profiler::PrintSummary(log);
     }
 
-    if (canSave)
+    if (!canSave)
     {
-        std::cout << "All files have been saved successfully!" << std::endl;
+        return EXIT_FAILURE;
     }
 
+    #if !DEBUG_MODE
+        log << "All files have been saved successfully!" << std::endl;
+    #endif
+
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,146 @@
+#define CATCH_CONFIG_MAIN
+
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+#include "coordinate/generatorlib.hpp"
+#include "jsonreporter.hpp"
+
+#define PI 3.14159265
+
+// the number of points every benchmark goes through (about the size of a large crystal arm)
+#define NUM_POINTS 1000
+
+/// @brief Sums the x of the results of an operation on every point, so the operation is not optimised away
+template<typename Op>
+static double SumOver(const std::vector<Vector>& points, Op op)
+{
+    double sum = 0.0;
+    for (const Vector& p : points)
+    {
+        sum += op(p);
+    }
+
+    return sum;
+}
+
+TEST_CASE( "Vector Operations", "[benchmark]" )
+{
+    std::vector<Vector> points(NUM_POINTS);
+    for (int i = 0; i < NUM_POINTS; i++)
+    {
+        points[i] = Vector(0.5 * i + 1, 0.1 * i + 3);
+    }
+    const Vector other(0.97, 1.01);
+
+    BENCHMARK("Vector::operator+") { return SumOver(points, [&](const Vector& p) { return (p + other).x; }); };
+
+    BENCHMARK("Vector::operator-") { return SumOver(points, [&](const Vector& p) { return (p - other).x; }); };
+
+    BENCHMARK("Vector::operator* (scalar)") { return SumOver(points, [&](const Vector& p) { return (p * 1.5).x; }); };
+
+    BENCHMARK("Vector::operator* (inner product)") { return SumOver(points, [&](const Vector& p) { return p * other; }); };
+
+    BENCHMARK("Vector::Magnitude") { return SumOver(points, [&](const Vector& p) { return p.Magnitude(); }); };
+
+    BENCHMARK("Vector::Distance") { return SumOver(points, [&](const Vector& p) { return p.Distance(other); }); };
+
+    BENCHMARK("Vector::Unit") { return SumOver(points, [&](const Vector& p) { return p.Unit().x; }); };
+
+    BENCHMARK("Vector::RotateArm") { return SumOver(points, [&](const Vector& p) { return Vector::RotateArm(p, 1).x; }); };
+
+    BENCHMARK("Vector::Project") { return SumOver(points, [&](const Vector& p) { return Vector::Project(p, other).x; }); };
+
+    BENCHMARK("Vector::ToString")
+    {
+        std::size_t length = 0;
+        for (int i = 0; i < NUM_POINTS; i += 10)
+        {
+            length += points[i].ToString().size();
+        }
+        return length;
+    };
+
+    // Vector::Rotate and Vector::Mirror are measured below against their structure of arrays versions
+    BENCHMARK("GenerateNextCircle")
+    {
+        return SumOver(points, [&](const Vector& p) { return GenerateNextCircle(p, 5.0, other.Unit(), 3.0).x; });
+    };
+}
+
+TEST_CASE( "Per-Vector vs Structure of Arrays", "[benchmark]" )
+{
+    std::vector<Vector> points(NUM_POINTS);
+    for (int i = 0; i < NUM_POINTS; i++)
+    {
+        points[i] = Vector(0.5 * i, 0.1 * i + 3);
+    }
+    const VectorArray arr(points);
+    const Vector axis(0.97, 1.01);
+    constexpr double theta = 60 * PI / 180;
+
+    std::vector<Vector> out(NUM_POINTS);
+    VectorArray outArr;
+
+    BENCHMARK("Vector::Rotate")
+    {
+        for (int i = 0; i < NUM_POINTS; i++)
+        {
+            out[i] = Vector::Rotate(points[i], theta);
+        }
+        return out[NUM_POINTS - 1].x;
+    };
+
+    BENCHMARK("VectorArray::RotateAll")
+    {
+        arr.TransformTo(Mat2::Rotation(theta), outArr);
+        return outArr.x[NUM_POINTS - 1];
+    };
+
+    BENCHMARK("Vector::Mirror")
+    {
+        for (int i = 0; i < NUM_POINTS; i++)
+        {
+            out[i] = Vector::Mirror(points[i], axis);
+        }
+        return out[NUM_POINTS - 1].x;
+    };
+
+    BENCHMARK("VectorArray::MirrorAll")
+    {
+        arr.TransformTo(Mat2::Reflection(axis), outArr);
+        return outArr.x[NUM_POINTS - 1];
+    };
+
+    // the 12 copies of a crystal arm
+    BENCHMARK("Crystal Copies (per-Vector)")
+    {
+        double sum = 0.0;
+        for (int rotation = 0; rotation < NUM_ARMS; rotation++)
+        {
+            for (int i = 0; i < NUM_POINTS; i++)
+            {
+                sum += Vector::Rotate(points[i], rotation * theta).x;
+                sum += Vector::Rotate(Vector::Mirror(points[i], axis), rotation * theta).x;
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("Crystal Copies (VectorArray)")
+    {
+        double sum = 0.0;
+        const Mat2 mirror = Mat2::Reflection(axis);
+        for (int rotation = 0; rotation < NUM_ARMS; rotation++)
+        {
+            const Mat2 rotate = Mat2::Rotation(rotation * theta);
+            arr.TransformTo(rotate, outArr);
+            sum += outArr.x[NUM_POINTS - 1];
+            arr.TransformTo(rotate * mirror, outArr);
+            sum += outArr.x[NUM_POINTS - 1];
+        }
+        return sum;
+    };
+}
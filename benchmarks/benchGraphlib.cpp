@@ -0,0 +1,145 @@
+#define CATCH_CONFIG_MAIN
+
+#include <filesystem>
+#include <memory>   // std::unique_ptr
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include <opencv2/core.hpp> // cv::Mat
+
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/dlalib.hpp"
+#include "graph/graphlib.hpp"
+#include "math/mathlib.hpp"
+#include "jsonreporter.hpp"
+
+#define ROWS WORLD_SIZE
+#define COLS WORLD_SIZE
+
+#define PI 3.14159265
+
+TEST_CASE( "OpenCV vs Native Raster Backends", "[benchmark]" )
+{
+    // the default parameters of the app
+    RandomEngine rng(0, 0, 1);
+    const std::vector<Circle> crystalArm = GenerateCrystalArm(45, 7, 2, rng);
+    const Vector mirror(0.97, 1.01);
+
+    cv::Mat img(ROWS, COLS, CV_8UC3);
+    for (const std::string backend : {"opencv", "native", "native-aa"})
+    {
+        std::unique_ptr<Rasterizer> canvas = MakeRasterizer(img, backend);
+
+        BENCHMARK("Crystal (" + backend + ")")
+        {
+            img.setTo(0);
+            DrawCrystalSnowflake(*canvas, crystalArm, mirror);
+            return img.data[0];
+        };
+
+        BENCHMARK("Radiating Dendrite (" + backend + ")")
+        {
+            img.setTo(0);
+            DrawRadiatingDendriteSnowflake(*canvas, mirror, 200, 5, 20, 50, 60 * PI / 180, 0.8);
+            return img.data[0];
+        };
+
+        BENCHMARK("Stellar Plate (" + backend + ")")
+        {
+            img.setTo(0);
+            DrawStellarPlateSnowflake(*canvas, mirror.Unit(), 100, 40);
+            return img.data[0];
+        };
+
+        BENCHMARK("Triangular Crystal (" + backend + ")")
+        {
+            img.setTo(0);
+            DrawTriangularCrystalSnowflake(*canvas, mirror, 280, 60, 40);
+            return img.data[0];
+        };
+    }
+}
+
+TEST_CASE( "Drawing at Fixed Seeds", "[benchmark]" )
+{
+    // the whole snowflake of the app including its random draws (seed 0, image 0)
+    cv::Mat img(ROWS, COLS, CV_8UC3);
+    std::unique_ptr<Rasterizer> canvas = MakeRasterizer(img, "native");
+
+    BENCHMARK("DrawCrystalSnowflake (generate and draw)")
+    {
+        img.setTo(0);
+        RandomEngine rng(0, 0, 1);
+        DrawCrystalSnowflake(*canvas, 45, 7, 2, Vector(0.97, 1.01), rng);
+        return img.data[0];
+    };
+
+    // the default cluster of the app
+    RandomEngine dlaRng(0, 0, 1);
+    const std::vector<Vector> dlaCluster = GenerateDlaCluster(1500, 1, 0.45 * WORLD_SIZE, Vector(0.97, 1.01), dlaRng);
+
+    RandomEngine armRng(0, 0, 1);
+    const std::vector<Circle> crystalArm = GenerateCrystalArm(45, 7, 2, armRng);
+
+    BENCHMARK("DrawCrystalSnowflake")
+    {
+        img.setTo(0);
+        DrawCrystalSnowflake(*canvas, crystalArm, Vector(0.97, 1.01));
+        return img.data[0];
+    };
+
+    BENCHMARK("DrawRadiatingDendriteSnowflake")
+    {
+        img.setTo(0);
+        DrawRadiatingDendriteSnowflake(*canvas, Vector(0.97, 1.01), 200, 5, 20, 50, 60 * PI / 180, 0.8);
+        return img.data[0];
+    };
+
+    BENCHMARK("DrawStellarPlateSnowflake")
+    {
+        img.setTo(0);
+        DrawStellarPlateSnowflake(*canvas, Vector(0.97, 1.01).Unit(), 100, 40);
+        return img.data[0];
+    };
+
+    BENCHMARK("DrawDlaSnowflake")
+    {
+        img.setTo(0);
+        DrawDlaSnowflake(*canvas, dlaCluster, 1, Vector(0.97, 1.01));
+        return img.data[0];
+    };
+}
+
+TEST_CASE( "Labelling and Encoding", "[benchmark]" )
+{
+    // a typical snowflake to encode
+    cv::Mat img(ROWS, COLS, CV_8UC3);
+    img.setTo(0);
+    RandomEngine rng(0, 0, 1);
+    DrawCrystalSnowflake(*MakeRasterizer(img, "native"), GenerateCrystalArm(45, 7, 2, rng), Vector(0.97, 1.01));
+
+    BENCHMARK("PutLabel")
+    {
+        PutLabel(img, "mirror vec: (0.97, 1.01)");
+        return img.data[0];
+    };
+
+    std::vector<unsigned char> bytes;
+    std::string error;
+    for (const std::string format : {"jpg", "png"})
+    {
+        BENCHMARK("EncodeImage (" + format + ")")
+        {
+            EncodeImage(img, "." + format, bytes, error);
+            return bytes.size();
+        };
+    }
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "benchGraphlib-SaveImage.jpg").string();
+    BENCHMARK("SaveImage (jpg)")
+    {
+        return SaveImage(filename, img);
+    };
+    std::filesystem::remove(filename);
+}
@@ -0,0 +1,68 @@
+#define CATCH_CONFIG_MAIN
+
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "math/mathlib.hpp"
+#include "jsonreporter.hpp"
+
+TEST_CASE( "Samplers", "[benchmark]" )
+{
+    // about the number of draws of a crystal arm
+    constexpr int NUM_DRAWS = 1000;
+    RandomEngine rng(0, 0, 0);
+    std::vector<double> out(NUM_DRAWS);
+    std::vector<int> integers(NUM_DRAWS);
+
+    BENCHMARK("boost_normal_distribution")
+    {
+        double sum = 0.0;
+        for (int i = 0; i < NUM_DRAWS; i++)
+        {
+            sum += boost_normal_distribution(45, 10);
+        }
+        return sum;
+    };
+
+    BENCHMARK("boost_uniform_int_distribution")
+    {
+        int sum = 0;
+        for (int i = 0; i < NUM_DRAWS; i++)
+        {
+            sum += boost_uniform_int_distribution(7, 2);
+        }
+        return sum;
+    };
+
+    BENCHMARK("RandomEngine::Normal")
+    {
+        double sum = 0.0;
+        for (int i = 0; i < NUM_DRAWS; i++)
+        {
+            sum += rng.Normal(45, 10);
+        }
+        return sum;
+    };
+
+    BENCHMARK("RandomEngine::UniformInt")
+    {
+        int sum = 0;
+        for (int i = 0; i < NUM_DRAWS; i++)
+        {
+            sum += rng.UniformInt(7, 2);
+        }
+        return sum;
+    };
+
+    BENCHMARK("RandomEngine::FillNormal")
+    {
+        rng.FillNormal(out.data(), NUM_DRAWS, 45, 10);
+        return out[NUM_DRAWS - 1];
+    };
+
+    BENCHMARK("RandomEngine::FillUniformInt")
+    {
+        rng.FillUniformInt(integers.data(), NUM_DRAWS, 7, 2);
+        return integers[NUM_DRAWS - 1];
+    };
+}
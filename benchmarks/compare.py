@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Compares the JSON results of the benchmarks (see jsonreporter.hpp) with a baseline.
+
+Every benchmark is matched by its executable, test case and name. Its mean is compared with the mean in the baseline.
+A benchmark counts as a regression if it is slower by more than the threshold and the confidence intervals of the two
+means do not overlap, which keeps noisy benchmarks from flagging on their own.
+
+Usage: compare.py <BASELINE> <CURRENT> [--threshold <PERCENT>]
+where BASELINE and CURRENT are JSON files or directories of them. The exit code is 1 if any benchmark has regressed (or
+there are no current results); a missing baseline is reported and skipped.
+"""
+
+import argparse
+import json
+import pathlib
+import sys
+
+
+def load(path):
+    """Loads the benchmarks of a file or of every JSON file in a directory, keyed by (executable, test, name)."""
+    path = pathlib.Path(path)
+    files = sorted(path.glob("*.json")) if path.is_dir() else [path]
+    results = {}
+    for file in files:
+        with open(file) as f:
+            document = json.load(f)
+        executable = pathlib.Path(document["executable"]).name
+        for benchmark in document["benchmarks"]:
+            results[(executable, benchmark["test"], benchmark["name"])] = benchmark
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flags benchmark regressions against a baseline")
+    parser.add_argument("baseline", help="the baseline JSON file or directory")
+    parser.add_argument("current", help="the current JSON file or directory")
+    parser.add_argument("--threshold", type=float, default=10.0, help="the slow-down in percent that counts as a regression (default 10)")
+    args = parser.parse_args()
+
+    # a fresh checkout has no baseline yet
+    if not pathlib.Path(args.baseline).exists() or not load(args.baseline):
+        print(f"no baseline in {args.baseline}; run the `benchmarks` target and copy its results/ to {args.baseline}")
+        return 0
+    if not pathlib.Path(args.current).exists() or not load(args.current):
+        print(f"no results in {args.current}; run the `benchmarks` target first")
+        return 1
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print(f"{'benchmark':<70} {'baseline':>12} {'current':>12} {'change':>8}")
+    for key in sorted(current):
+        label = " / ".join(key)
+        now = current[key]
+        before = baseline.get(key)
+        if before is None:
+            print(f"{label:<70} {'-':>12} {now['mean_ns']:>10.0f}ns {'new':>8}")
+            continue
+
+        change = 100.0 * (now["mean_ns"] - before["mean_ns"]) / before["mean_ns"]
+        is_regression = change > args.threshold and now["low_ns"] > before["high_ns"]
+        regressions += is_regression
+        print(f"{label:<70} {before['mean_ns']:>10.0f}ns {now['mean_ns']:>10.0f}ns {change:>+7.1f}%" + ("  REGRESSION" if is_regression else ""))
+
+    for key in sorted(set(baseline) - set(current)):
+        print(f"{' / '.join(key):<70} missing from the current results")
+
+    print(f"{regressions} regression(s) past {args.threshold:g}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,78 @@
+#ifndef BENCHMARKS_JSONREPORTER_H_
+#define BENCHMARKS_JSONREPORTER_H_
+
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "helper/jsonlib.hpp"
+
+/// @brief A Catch2 reporter that writes the results of the benchmarks as JSON (select it with --reporter json)
+///
+/// The document has the name of the executable and one entry per benchmark with its test case, its name and the mean,
+/// confidence interval and standard deviation of a run in nanoseconds, e.g. for benchmarks/compare.py.
+class JsonReporter : public Catch::StreamingReporterBase<JsonReporter>
+{
+public:
+    using StreamingReporterBase::StreamingReporterBase;
+
+    static std::string getDescription()
+    {
+        return "Reports the benchmarks as JSON";
+    }
+
+    void assertionStarting(const Catch::AssertionInfo&) override {}
+
+    bool assertionEnded(const Catch::AssertionStats&) override
+    {
+        return true;
+    }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override
+    {
+        results.push_back({currentTestCaseInfo->name, stats});
+    }
+
+    void benchmarkFailed(const std::string& error) override
+    {
+        failures.push_back(currentTestCaseInfo->name + ": " + error);
+    }
+
+    void testRunEnded(const Catch::TestRunStats& runStats) override
+    {
+        JsonWriter json(stream);
+        json.BeginObject().Key("executable").Value(currentTestRunInfo->name).Key("benchmarks").BeginArray();
+        for (const Result& result : results)
+        {
+            const Catch::BenchmarkStats<>& stats = result.stats;
+            json.BeginObject().Key("test").Value(result.testCase).Key("name").Value(stats.info.name);
+            json.Key("mean_ns").Value(stats.mean.point.count());
+            json.Key("low_ns").Value(stats.mean.lower_bound.count()).Key("high_ns").Value(stats.mean.upper_bound.count());
+            json.Key("stddev_ns").Value(stats.standardDeviation.point.count());
+            json.Key("samples").Value(stats.info.samples).Key("iterations").Value(stats.info.iterations).EndObject();
+        }
+        json.EndArray().Key("failures").BeginArray();
+        for (const std::string& failure : failures)
+        {
+            json.Value(failure);
+        }
+        json.EndArray().EndObject();
+        stream << "\n";
+
+        StreamingReporterBase::testRunEnded(runStats);
+    }
+
+private:
+    struct Result
+    {
+        std::string testCase;
+        Catch::BenchmarkStats<> stats;
+    };
+
+    std::vector<Result> results;
+    std::vector<std::string> failures;
+};
+
+CATCH_REGISTER_REPORTER("json", JsonReporter)
+
+#endif  // BENCHMARKS_JSONREPORTER_H_
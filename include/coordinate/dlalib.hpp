@@ -0,0 +1,23 @@
+#ifndef INCLUDE_COORDINATE_DLALIB_H_
+#define INCLUDE_COORDINATE_DLALIB_H_
+
+#include <vector>
+
+#include "coordinate/vectorlib.hpp"
+#include "math/mathlib.hpp"
+
+/// @brief Grows a snowflake by diffusion-limited aggregation (DLA): random walkers are released around the cluster and
+/// stick to the first particle they touch, and every particle that sticks is added with its 11 images under the six
+/// rotations and the mirror, so the cluster keeps the symmetry of a snowflake
+/// @param numParticles the number of particles that stick, including the seed at the origin (each stands for 12 discs)
+/// @param radius the radius of the particles
+/// @param maxRadius stops once the cluster reaches this distance from the origin
+/// @param mirror the mirror vector
+/// @param rng the random number generator (only draws the seed of the walkers)
+/// @param numJobs the number of threads of the walkers
+/// @return the centers of the particles in the order they stuck (without their images)
+/// @note the walkers are released in rounds that grow with the cluster and do not see the particles of their own round,
+/// so the cluster is the same for any number of jobs; a walker landing on a particle of its own round is dropped
+std::vector<Vector> GenerateDlaCluster(const unsigned int numParticles, const double radius, const double maxRadius, const Vector& mirror, RandomEngine& rng, const unsigned int numJobs = 1);
+
+#endif  // INCLUDE_COORDINATE_DLALIB_H_
@@ -0,0 +1,90 @@
+#ifndef INCLUDE_COORDINATE_GRIDLIB_H_
+#define INCLUDE_COORDINATE_GRIDLIB_H_
+
+#include <algorithm>    // std::min, std::max
+#include <cmath>    // std::floor
+#include <cstddef>  // std::size_t
+#include <vector>
+
+#include "coordinate/vectorlib.hpp"
+
+/// @brief A uniform grid of buckets over the square [-extent, extent]², which finds the points near a position in
+/// constant time (for points spread at least about a cell apart)
+///
+/// Every cell keeps the points inside it as a linked list threaded through one array, so inserting a point never
+/// allocates per cell. The points outside the square are kept in the border cells, so the queries are always correct
+/// and only get slower out there.
+class SpatialGrid
+{
+public:
+    /// @brief Contructor
+    /// @param extent the half width of the square covered by the cells
+    /// @param cellSize the width of a cell (e.g. the largest distance of the queries)
+    SpatialGrid(const double extent, const double cellSize);
+
+    /// @brief Get the number of points
+    /// @return the number of points
+    std::size_t Size() const { return points.size(); }
+
+    /// @brief Get a point
+    /// @param i the index of the point (in the order of insertion)
+    /// @return the point
+    const Vector& Point(const std::size_t i) const { return points[i]; }
+
+    /// @brief Get all points in the order of insertion
+    /// @return the points
+    const std::vector<Vector>& Points() const { return points; }
+
+    /// @brief Adds a point
+    /// @param point the point
+    /// @return the index of the point
+    std::size_t Insert(const Vector& point);
+
+    /// @brief Removes all points (the cells are kept)
+    void Clear();
+
+    /// @brief Visits the points in the cells overlapping the square around a disc, i.e. all points within the radius
+    /// of the center and a few more
+    /// @param center the center of the disc
+    /// @param radius the radius of the disc
+    /// @param visit the callable that takes the index of a point and returns false to stop the search
+    template<typename Visit>
+    void ForEachNear(const Vector& center, const double radius, Visit visit) const
+    {
+        const int x0 = CellOf(center.x - radius), x1 = CellOf(center.x + radius);
+        const int y0 = CellOf(center.y - radius), y1 = CellOf(center.y + radius);
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                for (int i = heads[static_cast<std::size_t>(y) * numCells + x]; i >= 0; i = next[i])
+                {
+                    if (!visit(static_cast<std::size_t>(i)))
+                        return;
+                }
+            }
+        }
+    }
+
+    /// @brief Finds the distance between a position and the nearest point within a radius
+    /// @param center the position
+    /// @param radius the radius of the search
+    /// @return the distance to the nearest point, or the radius if there is none closer
+    double NearestDistance(const Vector& center, const double radius) const;
+
+private:
+    /// @brief Get the column (or row) of the cell holding a coordinate, clamped to the grid
+    int CellOf(const double coordinate) const
+    {
+        const int cell = static_cast<int>(std::floor((coordinate + extent) / cellSize));
+        return std::min(std::max(cell, 0), numCells - 1);
+    }
+
+    double extent, cellSize;
+    int numCells;   // the number of cells per row
+    std::vector<int> heads;     // the last point of every cell (-1 if empty)
+    std::vector<int> next;      // the point before every point in its cell (-1 if first)
+    std::vector<Vector> points;
+};
+
+#endif  // INCLUDE_COORDINATE_GRIDLIB_H_
@@ -0,0 +1,93 @@
+#ifndef INCLUDE_COORDINATE_REITERLIB_H_
+#define INCLUDE_COORDINATE_REITERLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint8_t
+#include <utility>  // std::pair
+#include <vector>
+
+/// @brief Reiter's cellular automaton of a snow crystal (C. A. Reiter, "A local cellular model for snow crystal growth")
+/// on a hexagonal lattice
+///
+/// Every cell holds an amount of water s. A cell is frozen once s >= 1, and a cell is receptive if it or one of its
+/// neighbours is frozen. In every step, the receptive cells gain gamma and keep their water, while the water of the
+/// other cells diffuses by u' = u + alpha / 2 * (mean of the neighbours - u), where the receptive cells count as 0. The
+/// cells start at beta with the center frozen, and the cells on the boundary stay at beta.
+///
+/// The cells are in axial coordinates (q, r) with the neighbours (q ± 1, r), (q, r ± 1), (q + 1, r - 1) and (q - 1, r + 1),
+/// i.e. the center of (q, r) is at (q + r / 2, r * sqrt(3) / 2). The field keeps the 12-fold symmetry of the lattice, so
+/// only the 30° sector 0 <= r <= q is simulated, with its edges mirrored into a margin of ghost cells. The sector is
+/// stored row by row as a structure of arrays, so the stencil runs along the rows (8 cells at a time with AVX2).
+class ReiterLattice
+{
+public:
+    /// @brief Contructor
+    /// @param radius the number of cells between the center and the boundary (in hexagonal distance)
+    /// @param alpha the diffusion rate
+    /// @param beta the background vapour level
+    /// @param gamma the water added to the receptive cells per step
+    ReiterLattice(const int radius, const float alpha, const float beta, const float gamma);
+
+    /// @brief Runs the automaton until the crystal reaches the given fraction of the radius (or the number of steps)
+    /// @param maturity the fraction of the radius at which the crystal is mature
+    /// @param maxSteps the largest number of steps
+    /// @param numJobs the number of threads sharing the rows
+    /// @return the number of steps
+    /// @note the steps are the same for any number of jobs
+    int Run(const double maturity, const int maxSteps, const unsigned int numJobs = 1);
+
+    /// @brief Get the radius of the lattice
+    /// @return the number of cells between the center and the boundary
+    int Radius() const { return radius; }
+
+    /// @brief Get the radius of the crystal
+    /// @return the largest hexagonal distance between a frozen cell and the center
+    int FrozenRadius() const { return frozenRadius; }
+
+    /// @brief Get the amount of water in a cell of the lattice
+    /// @param q the axial column
+    /// @param r the axial row
+    /// @return the water (beta outside the lattice)
+    float State(const int q, const int r) const;
+
+    /// @brief Checks if a cell of the lattice is frozen
+    /// @param q the axial column
+    /// @param r the axial row
+    /// @return true if the cell is frozen (false outside the lattice)
+    bool IsFrozen(const int q, const int r) const;
+
+    /// @brief Maps a cell to its image in the simulated sector 0 <= r <= q
+    /// @param q the axial column
+    /// @param r the axial row
+    /// @return the image of the cell
+    static std::pair<int, int> Fold(const int q, const int r);
+
+private:
+    /// @brief Get the index of a cell of the stored rows
+    std::size_t IndexOf(const int q, const int r) const;
+
+    /// @brief Updates the rows [first, last) of the active region from s to next
+    void UpdateRows(const int first, const int last);
+
+    /// @brief Copies the cells mirrored into the ghost cells, swaps the buffers and freezes the cells that have reached 1
+    void FinishStep();
+
+    /// @brief Marks a sector cell as receptive
+    void MakeReceptive(const int q, const int r);
+
+    int radius;
+    float alpha, beta, gamma;
+    int numRows, width;     // the stored rows (-1 to radius / 2 + 1) and their padded width (columns -2 to radius + 1)
+    int active = 2;         // the cells closer than this to the center are updated
+    int frozenRadius = 0;
+    int numSteps = 0;
+    std::vector<float> s, next;     // the water
+    std::vector<float> u, nextU;    // the water that diffuses, i.e. 0 for the receptive cells (also in the ghost cells)
+    std::vector<float> diffusing;   // 1 for the cells that are not receptive, 0 for the receptive ones
+    std::vector<std::uint8_t> frozen;
+    std::vector<std::pair<std::size_t, std::size_t>> ghosts;    // (ghost, source) ordered by the distance of the source
+    std::vector<int> ghostRings;    // the hexagonal distance of the source of every ghost
+    std::vector<std::pair<int, int>> boundary;  // the receptive cells that are not frozen yet
+};
+
+#endif  // INCLUDE_COORDINATE_REITERLIB_H_
@@ -0,0 +1,32 @@
+#ifndef INCLUDE_COORDINATE_SYMMETRYLIB_H_
+#define INCLUDE_COORDINATE_SYMMETRYLIB_H_
+
+#include "coordinate/vectorlib.hpp"
+
+/// @brief The symmetry group of a snowflake, i.e., the six rotations by 60° (C6) and optionally the six mirrors (D6)
+///
+/// The fundamental wedge starts at the axis and spans 30° (D6) or 60° (C6); every point of the plane is the image of a point
+/// in the wedge under one element of the group.
+struct Symmetry
+{
+    Vector axis;    // the unit vector of the first edge of the wedge (a mirror axis for D6)
+    bool dihedral;  // true for D6, false for C6
+
+    /// @brief Contructor
+    /// @param axis the direction of the first edge of the wedge (does not need to be normalised)
+    /// @param dihedral true if the group has mirrors (D6)
+    Symmetry(const Vector& axis, const bool dihedral);
+
+    /// @brief The distance between a point and the fundamental wedge
+    /// @param p the point
+    /// @return the distance (0 if the point is inside the wedge)
+    double DistanceToWedge(const Vector& p) const;
+
+    /// @brief Checks if a disc overlaps the fundamental wedge
+    /// @param c the center of the disc
+    /// @param r the radius of the disc
+    /// @return true if the disc overlaps the wedge
+    bool Touches(const Vector& c, const double r) const;
+};
+
+#endif  // INCLUDE_COORDINATE_SYMMETRYLIB_H_
@@ -0,0 +1,87 @@
+#ifndef INCLUDE_COORDINATE_VECTORARRAYLIB_H_
+#define INCLUDE_COORDINATE_VECTORARRAYLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <vector>
+
+#include "coordinate/vectorlib.hpp"
+
+/// @brief A 2x2 matrix [[a, b], [c, d]]
+struct Mat2
+{
+    double a, b, c, d;
+
+    /// @brief The rotation matrix
+    /// @param theta the rotation angle in radian
+    /// @return the matrix
+    static Mat2 Rotation(const double theta);
+
+    /// @brief The rotation matrix of k arms (k * 360 / NUM_ARMS degrees) from the sixth roots of unity
+    /// @param k the number of arms (may be negative)
+    /// @return the matrix
+    static Mat2 ArmRotation(const int k);
+
+    /// @brief The reflection matrix (same as Vector::Mirror)
+    /// @param axis the mirror axis (does not need to be normalised)
+    /// @return the matrix
+    static Mat2 Reflection(const Vector& axis);
+
+    /// @brief Composing two transforms (other first)
+    /// @param other the other matrix
+    /// @return the product
+    Mat2 operator*(const Mat2& other) const;
+
+    /// @brief Transforming a Vector
+    /// @param v the Vector
+    /// @return the transformed Vector
+    Vector operator*(const Vector& v) const;
+};
+
+/// @brief A batch of points stored as a structure of arrays so bulk transforms vectorize
+struct VectorArray
+{
+    std::vector<double> x, y;
+
+    /// @brief Contructor
+    VectorArray() = default;
+
+    /// @brief Contructor
+    /// @param n the number of points (all at the origin)
+    explicit VectorArray(const std::size_t n);
+
+    /// @brief Contructor
+    /// @param points the points
+    explicit VectorArray(const std::vector<Vector>& points);
+
+    /// @brief The number of points
+    /// @return the number of points
+    std::size_t Size() const { return x.size(); }
+
+    /// @brief Get a point
+    /// @param i the index
+    /// @return the point
+    Vector operator[](const std::size_t i) const { return Vector(x[i], y[i]); }
+
+    /// @brief Appending a point
+    /// @param v the point
+    void PushBack(const Vector& v);
+
+    /// @brief Rotating all points with theta (the trigonometry is only done once)
+    /// @param theta the rotation angle in radian
+    void RotateAll(const double theta);
+
+    /// @brief Mirroring all points along the axis (same as Vector::Mirror)
+    /// @param axis the mirror axis
+    void MirrorAll(const Vector& axis);
+
+    /// @brief Transforming all points
+    /// @param m the matrix
+    void TransformAll(const Mat2& m);
+
+    /// @brief Transforming all points into another array (resized if needed)
+    /// @param m the matrix
+    /// @param out the transformed points
+    void TransformTo(const Mat2& m, VectorArray& out) const;
+};
+
+#endif  // INCLUDE_COORDINATE_VECTORARRAYLIB_H_
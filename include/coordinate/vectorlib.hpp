@@ -3,117 +3,232 @@
 #ifndef INCLUDE_COORDINATE_VECTORLIB_H_
 #define INCLUDE_COORDINATE_VECTORLIB_H_
 
+#include <cmath>    // std::sqrt, std::cos, std::sin
 #include <string>
+#include <type_traits>  // std::enable_if_t, std::is_arithmetic_v, std::is_floating_point_v
 
-struct Vector
+// the number of arms of a snowflake
+#define NUM_ARMS 6
+
+// sin(60°) = sqrt(3) / 2
+#define SQRT3_OVER_2 0.86602540378443864676
+
+/// @brief A 2D vector (header-only so every operation inlines)
+/// @tparam T float or double
+template<typename T>
+struct Vector2
 {
-    double x, y;
+    static_assert(std::is_floating_point_v<T>, "Vector2 requires a floating point type");
+
+    T x, y;
 
     /// @brief Contructor
-    Vector();
+    constexpr Vector2() : x(0), y(0) {}
 
     /// @brief Contructor
     /// @param  x x value
     /// @param  y y value
-    Vector(double x, double y);
+    constexpr Vector2(T x, T y) : x(x), y(y) {}
 
-    /// @brief Copy constructor
+    /// @brief Converting contructor (e.g. float to double)
     /// @param other the other vector
-    Vector(const Vector& other);
+    template<typename U>
+    constexpr explicit Vector2(const Vector2<U>& other) : x(static_cast<T>(other.x)), y(static_cast<T>(other.y)) {}
 
     /// @brief The Euclidean distance between itself and the other vector
     /// @param other the other vector
     /// @return the Euclidean distance between the two
-    double Distance(const Vector& other);
+    T Distance(const Vector2& other) const
+    {
+        return (*this - other).Magnitude();
+    }
+
+    /// @brief The squared length of itself
+    /// @return the squared length
+    constexpr T SquaredMagnitude() const
+    {
+        return x * x + y * y;
+    }
 
     /// @brief The length of itself
     /// @return the length
-    double Magnitude() const;
+    T Magnitude() const
+    {
+        return std::sqrt(SquaredMagnitude());
+    }
 
     /// @brief Get the unit vector
     /// @return the unit vector
-    Vector Unit() const;
+    Vector2 Unit() const
+    {
+        const T length = Magnitude();
+        return Vector2(x / length, y / length);
+    }
 
     /// @brief Rotating itself with theta
     /// @param theta the rotation angle in radian
-    void Rotate(const double theta);
+    void Rotate(const T theta)
+    {
+        *this = Rotate(*this, theta);
+    }
 
     /// @brief Rotating a vector with theta
     /// @param theta the rotation angle in radian
     /// @return the new vector after rotation
-    static Vector Rotate(const Vector& v, const double theta);
+    static Vector2 Rotate(const Vector2& v, const T theta)
+    {
+        const T c = std::cos(theta), s = std::sin(theta);
+        return Vector2(c * v.x - s * v.y, s * v.x + c * v.y);
+    }
+
+    /// @brief Rotating a vector by k arms (k * 360 / NUM_ARMS degrees) without any trigonometry
+    /// @param v the original vector
+    /// @param k the number of arms (may be negative)
+    /// @return the new vector after rotation
+    static constexpr Vector2 RotateArm(const Vector2& v, const int k);
 
     /// @brief Calculate the projected vector of vector v along vector w
     /// @param v the original vector
     /// @param w the norm vector
     /// @return the projected vector
-    static Vector Project(const Vector& v, const Vector& w);
+    static constexpr Vector2 Project(const Vector2& v, const Vector2& w)
+    {
+        return ((v * w) / w.SquaredMagnitude()) * w;
+    }
 
     /// @brief Calculate the mirrored vector of vector v along vector w
     /// @param v the original vector
     /// @param w the norm vector
     /// @return the new vector after mirrored
-    static Vector Mirror(const Vector& v, const Vector& w);
+    static constexpr Vector2 Mirror(const Vector2& v, const Vector2& w)
+    {
+        return T(2) * Project(v, w) - v;
+    }
 
     std::string ToString() const;
 
     /// @brief Adding two Vectors
     /// @param other the other Vector
     /// @return the sum of the two Vectors
-    Vector operator+(const Vector& other) const;
+    constexpr Vector2 operator+(const Vector2& other) const
+    {
+        return Vector2(x + other.x, y + other.y);
+    }
 
     /// @brief Subtracting two Vectors
     /// @param other the other Vector
     /// @return the difference of the two Vectors
-    Vector operator-(const Vector& other) const;
+    constexpr Vector2 operator-(const Vector2& other) const
+    {
+        return Vector2(x - other.x, y - other.y);
+    }
 
     /// @brief Adding two Vectors
     /// @param other the other Vector
     /// @return the sum of the two Vectors
-    Vector operator+=(const Vector& other);
+    constexpr Vector2& operator+=(const Vector2& other)
+    {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
 
     /// @brief Subtracting two Vectors
     /// @param other the other Vector
     /// @return the difference of the two Vectors
-    Vector operator-=(const Vector& other);
+    constexpr Vector2& operator-=(const Vector2& other)
+    {
+        x -= other.x;
+        y -= other.y;
+        return *this;
+    }
 
     /// @brief Multiplying a Vector with a scalar value
     /// @param c a scalar
     /// @return the scaled vector
-    Vector operator*(double c);
+    constexpr Vector2 operator*(T c) const
+    {
+        return Vector2(x * c, y * c);
+    }
 
     /// @brief Multiplying a Vector with a scalar value
     /// @param c a scalar
     /// @return the scaled vector
-    Vector operator*=(double c);
+    constexpr Vector2& operator*=(T c)
+    {
+        x *= c;
+        y *= c;
+        return *this;
+    }
 
     /// @brief Performing inner product of two Vectors
     /// @param other the other Vector
     /// @return the inner product of the two Vectors
-    double operator*(const Vector& other) const;
-
-    /// @brief Overloaded assignment operator
-    /// @param other 
-    /// @return 
-    Vector& operator=(const Vector& other);
+    constexpr T operator*(const Vector2& other) const
+    {
+        return x * other.x + y * other.y;
+    }
 };
 
 /// @brief To make c * other work
 /// @param c a scalar
 /// @param other the other Vector
 /// @return
-Vector operator*(double c, const Vector& other);
+template<typename S, typename T, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+constexpr Vector2<T> operator*(S c, const Vector2<T>& other)
+{
+    return other * static_cast<T>(c);
+}
 
 /// @brief Checks if two Vectors are the same
 /// @param a Vector A
 /// @param b Vector B
 /// @return true if Vector A is equal to Vector B
-bool operator==(const Vector& a, const Vector& b);
+template<typename T>
+constexpr bool operator==(const Vector2<T>& a, const Vector2<T>& b)
+{
+    return (a.x == b.x) && (a.y == b.y);
+}
 
 /// @brief Compares two Vectors
 /// @param a Vector A
 /// @param b Vector B
 /// @return true if Vector A is not equal to Vector B
-bool operator!=(const Vector& a, const Vector& b);
+template<typename T>
+constexpr bool operator!=(const Vector2<T>& a, const Vector2<T>& b)
+{
+    return !(a == b);
+}
+
+/// @brief The sixth roots of unity, i.e. the unit vectors of the NUM_ARMS arm directions (0°, 60°, ..., 300°)
+template<typename T>
+inline constexpr Vector2<T> SIXTH_ROOTS_OF_UNITY[NUM_ARMS] =
+{
+    Vector2<T>(T(1), T(0)),
+    Vector2<T>(T(0.5), T(SQRT3_OVER_2)),
+    Vector2<T>(T(-0.5), T(SQRT3_OVER_2)),
+    Vector2<T>(T(-1), T(0)),
+    Vector2<T>(T(-0.5), T(-SQRT3_OVER_2)),
+    Vector2<T>(T(0.5), T(-SQRT3_OVER_2)),
+};
+
+template<typename T>
+constexpr Vector2<T> Vector2<T>::RotateArm(const Vector2& v, const int k)
+{
+    // multiplies by the root as complex numbers
+    const Vector2& root = SIXTH_ROOTS_OF_UNITY<T>[((k % NUM_ARMS) + NUM_ARMS) % NUM_ARMS];
+    return Vector2(root.x * v.x - root.y * v.y, root.y * v.x + root.x * v.y);
+}
+
+// ToString is compiled once in vectorlib.cpp
+extern template std::string Vector2<float>::ToString() const;
+extern template std::string Vector2<double>::ToString() const;
+
+using Vector = Vector2<double>;
+using Vector2f = Vector2<float>;
+
+static_assert(std::is_trivially_copyable_v<Vector>, "Vector must be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Vector2f>, "Vector2f must be trivially copyable");
+static_assert(sizeof(Vector2f) == 2 * sizeof(float), "Vector2f must be packed");
 
 #endif  // INCLUDE_COORDINATE_VECTORLIB_H_
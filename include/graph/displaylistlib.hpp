@@ -0,0 +1,141 @@
+#ifndef INCLUDE_GRAPH_DISPLAYLISTLIB_H_
+#define INCLUDE_GRAPH_DISPLAYLISTLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint32_t, std::int32_t
+#include <memory>   // std::shared_ptr
+#include <vector>
+
+#include "graph/rasterlib.hpp"
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/symmetrylib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+
+/// @brief The kinds of commands of a display list
+enum class DrawOp : unsigned char
+{
+    Circle,     // the center is points[first] and size is the radius
+    Line,       // the ends are points[first] and points[first + 1] and size is the width
+    Polygon,    // the vertices are points[first, first + count)
+    Replicate,  // the symmetry group is symmetries[first]
+    Stamp,      // the stamp is stamps[size], the offset is points[first] and the rows of the transform points[first + 1, first + 3)
+};
+
+/// @brief A command of a display list (the coordinates live in the point buffer of the list)
+struct DrawCommand
+{
+    DrawOp op;
+    Colour colour;
+    std::uint32_t first;
+    std::uint32_t count;
+    std::int32_t size;
+};
+
+static_assert(sizeof(DrawCommand) == 16, "DrawCommand must stay compact");
+
+/// @brief A recorded snowflake: the generators draw into it like a canvas and it can be replayed on any backend
+///
+/// The list keeps its buffers between Clear() calls, so one list per thread can record every image of a batch
+/// without allocating.
+class DisplayList : public Rasterizer
+{
+public:
+    /// @brief Contructor
+    /// @param rows the number of rows of the canvas the commands are meant for
+    /// @param cols the number of columns of the canvas the commands are meant for
+    DisplayList(const int rows, const int cols);
+
+    int Rows() const override { return rows; }
+
+    int Cols() const override { return cols; }
+
+    /// @brief A display list has no pixels
+    /// @return an empty buffer
+    RasterBuffer Pixels() override { return RasterBuffer(); }
+
+    void FillCircle(const Vector& center, const int radius, const Colour& colour) override;
+
+    void DrawLine(const Vector& start, const Vector& end, const int width, const Colour& colour) override;
+
+    void FillConvexPolygon(const std::vector<Vector>& points, const Colour& colour) override;
+
+    /// @brief Records that the commands since the last Replicate command are the fundamental wedge of a symmetry group,
+    /// which Execute draws once per element of the group and SVG output places with <use>
+    /// @param symmetry the symmetry group
+    void ReplicateWedge(const Symmetry& symmetry);
+
+    /// @brief Records a copy of a stamp, which keeps the stamp alive as long as the command
+    void DrawStamp(const std::shared_ptr<const Stamp>& stamp, const Mat2& transform, const Vector& offset, const Colour& colour) override;
+
+    /// @brief Removes all commands (keeps the memory for the next recording)
+    void Clear();
+
+    /// @brief The number of commands
+    /// @return the number of commands
+    std::size_t Size() const { return commands.size(); }
+
+    /// @brief Get the commands in drawing order
+    /// @return the commands
+    const std::vector<DrawCommand>& Commands() const { return commands; }
+
+    /// @brief Get the coordinates referenced by the commands
+    /// @return the points
+    const std::vector<Vector>& Points() const { return points; }
+
+    /// @brief Get the symmetry groups referenced by the Replicate commands
+    /// @return the symmetry groups
+    const std::vector<Symmetry>& Symmetries() const { return symmetries; }
+
+    /// @brief Get the stamps referenced by the Stamp commands
+    /// @return the stamps
+    const std::vector<std::shared_ptr<const Stamp>>& Stamps() const { return stamps; }
+
+    /// @brief Get the transform of a Stamp command
+    /// @param command a Stamp command of the list
+    /// @return the transform
+    Mat2 TransformOf(const DrawCommand& command) const;
+
+    /// @brief Get the vertices of a command
+    /// @param command a command of the list
+    /// @return the pointer to the first vertex
+    const Vector* PointsOf(const DrawCommand& command) const { return points.data() + command.first; }
+
+    /// @brief Replays the commands in order
+    ///
+    /// Replicate commands draw the commands before them again, rotated (and mirrored) around the center of the list.
+    /// @param target the backend to draw on
+    void Execute(Rasterizer& target) const;
+
+    /// @brief Replays the commands scaled onto a window of a larger image (e.g. a tile)
+    ///
+    /// The point p of the list lands on the pixel scale * p - origin of the target. Replicate commands are drawn as rotated
+    /// (and mirrored) copies of the commands before them like in Execute(target), and the commands that miss the window
+    /// are skipped.
+    /// @param target the backend to draw on
+    /// @param scale the number of pixels per unit of the list
+    /// @param origin the pixel of the full image at the top left corner of the target
+    void Execute(Rasterizer& target, const double scale, const Vector& origin) const;
+
+    /// @brief Replays the commands in one colour through a transform, e.g. a copy of a stamp drawn without its mask
+    ///
+    /// The point p of the list lands on the pixel transform * p + offset of the target. Replicate commands are ignored
+    /// and the commands that miss the target are skipped.
+    /// @param target the backend to draw on
+    /// @param transform a rotation or a mirror times a scale
+    /// @param offset the pixel of the origin of the list
+    /// @param colour the colour of every command
+    void Execute(Rasterizer& target, const Mat2& transform, const Vector& offset, const Colour& colour) const;
+
+private:
+    /// @brief Replays the commands [begin, end) transformed by m around the center of the list, then scaled and shifted
+    /// (in their own colours, or all in one colour if given)
+    void ExecuteRange(Rasterizer& target, const std::size_t begin, const std::size_t end, const Mat2& m, const double scale, const Vector& origin, const Colour* colour = nullptr) const;
+
+    int rows, cols;
+    std::vector<DrawCommand> commands;
+    std::vector<Vector> points;
+    std::vector<Symmetry> symmetries;
+    std::vector<std::shared_ptr<const Stamp>> stamps;
+};
+
+#endif  // INCLUDE_GRAPH_DISPLAYLISTLIB_H_
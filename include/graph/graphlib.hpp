@@ -1,11 +1,20 @@
 #ifndef INCLUDE_GRAPH_GRAPHLIB_H_
 #define INCLUDE_GRAPH_GRAPHLIB_H_
 
+#include <memory>   // std::unique_ptr
 #include <string>
 #include <vector>
 
 #include <opencv2/core/base.hpp>
+#include "graph/rasterlib.hpp"
 #include "coordinate/vectorlib.hpp"
+#include "coordinate/symmetrylib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+#include "coordinate/reiterlib.hpp"
+#include "math/mathlib.hpp"
+
+// the size of the canvas the snowflakes are designed on, i.e. the world units of the geometry (scaled to the output size)
+#define WORLD_SIZE 1024
 
 struct Circle
 {
@@ -26,18 +35,79 @@ struct Circle
     }
 };
 
+/// @brief A batch of circles stored as a structure of arrays (see Circle)
+struct CircleArray
+{
+    VectorArray c;
+    std::vector<unsigned int> radius;
+    std::vector<unsigned char> r, g, b;
+
+    /// @brief Contructor
+    CircleArray() = default;
+
+    /// @brief Contructor
+    /// @param circles the circles
+    explicit CircleArray(const std::vector<Circle>& circles);
+
+    /// @brief The number of circles
+    /// @return the number of circles
+    std::size_t Size() const { return radius.size(); }
+};
+
+/// @brief The reference raster backend, which draws with OpenCV
+class OpenCVRasterizer : public Rasterizer
+{
+public:
+    /// @brief Contructor
+    /// @param img the canvas (must outlive the rasterizer)
+    explicit OpenCVRasterizer(cv::Mat& img);
+
+    int Rows() const override;
+
+    int Cols() const override;
+
+    RasterBuffer Pixels() override;
+
+    void FillCircle(const Vector& center, const int radius, const Colour& colour) override;
+
+    void DrawLine(const Vector& start, const Vector& end, const int width, const Colour& colour) override;
+
+    void FillConvexPolygon(const std::vector<Vector>& points, const Colour& colour) override;
+
+private:
+    cv::Mat& img;
+};
+
+/// @brief Get a view of the pixels of an 8-bit image
+/// @param img the image
+/// @return the view
+RasterBuffer ToRasterBuffer(cv::Mat& img);
+
+/// @brief Creates a raster backend that draws on the image
+/// @param img the canvas (must outlive the rasterizer)
+/// @param backend "opencv", "native" or "native-aa" (anti-aliased)
+/// @return the raster backend (nullptr if the name is unknown)
+std::unique_ptr<Rasterizer> MakeRasterizer(cv::Mat& img, const std::string& backend);
+
 /// @brief Displays the image using OpenCV
 /// @param windowName the name of the window
 /// @param img the image (OpenCV format)
 void DisplayImage(const std::string& windowName, cv::Mat& img);
 
 /// @brief Draws all circles in the vector container on the canvas
-/// @param img the canvas
+/// @param canvas the canvas
 /// @param circles a vector of circles
-void DrawCircles(cv::Mat& img, const std::vector<Circle>& circles);
+void DrawCircles(Rasterizer& canvas, const std::vector<Circle>& circles);
+
+/// @brief Draws all circles in the batch on the canvas
+/// @param canvas the canvas
+/// @param circles a batch of circles
+/// @param centers the centers to draw the circles at (defaults to circles.c)
+/// @param wedge only draws the circles touching the fundamental wedge of the symmetry group if set
+void DrawCircles(Rasterizer& canvas, const CircleArray& circles, const VectorArray* centers = nullptr, const Symmetry* wedge = nullptr);
 
 /// @brief Draw a fern
-/// @param img the canvas
+/// @param canvas the canvas
 /// @param v the direction vector of the arm
 /// @param armLength the length of the arm
 /// @param armWidth the width of the arm
@@ -45,10 +115,11 @@ void DrawCircles(cv::Mat& img, const std::vector<Circle>& circles);
 /// @param branchLength the length of the branch
 /// @param theta the angle between the branch and the arm
 /// @param rate the discount rate
-void DrawFern(cv::Mat& img, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate);
+/// @param wedge only draws the lines touching the fundamental wedge of the symmetry group if set
+void DrawFern(Rasterizer& canvas, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate, const Symmetry* wedge = nullptr);
 
 /// @brief Draw a Radiating Dendrites snowflake
-/// @param img the canvas
+/// @param canvas the canvas
 /// @param v the direction vector of the arm
 /// @param armLength the length of the arm
 /// @param armWidth the width of the arm
@@ -56,34 +127,110 @@ void DrawFern(cv::Mat& img, const Vector& v, const int armLength, const int armW
 /// @param branchLength the length of the branch
 /// @param theta the angle between the branch and the arm
 /// @param rate the discount rate
-void DrawRadiatingDendriteSnowflake(cv::Mat& img, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate);
+/// @param symmetric records one wedge and replicates it (C6) if the canvas is a DisplayList, e.g. for SVG output
+void DrawRadiatingDendriteSnowflake(Rasterizer& canvas, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate, const bool symmetric = false);
+
+/// @brief The rule of a Recursive Dendrite, which grows every segment like an L-system: a segment of a level has numNodes
+/// pairs of side branches spread along it, and every branch is a segment of the next level
+struct DendriteRule
+{
+    int depth;                  // the number of levels of side branches
+    int numNodes;               // the number of pairs of side branches along a segment
+    std::vector<double> angles; // the angle between the branches of every level and their parent in radian (the last one repeats)
+    std::vector<double> decays; // the length of the branches of every level relative to their parent (the last one repeats)
+    double widthDecay;          // the width of the branches relative to their parent
+};
+
+/// @brief Draw a Recursive Dendrite snowflake: six arms that branch by a rule
+/// @param canvas the canvas
+/// @param v the direction vector of the first arm
+/// @param armLength the length of an arm
+/// @param armWidth the width of an arm
+/// @param rule the rule of the branches
+/// @note the branches of a level are copies of one stamp (see Stamp) made of the copies of the level below, so the
+/// snowflake costs a mask per level rather than a line per branch, which is about (2 * numNodes)^depth per arm
+void DrawRecursiveDendriteSnowflake(Rasterizer& canvas, const Vector& v, const int armLength, const int armWidth, const DendriteRule& rule);
+
+/// @brief Generate the chain of circles of one arm of a Crystal snowflake
+/// @param numCrystals the number of circles per arm
+/// @param radiusHigh the upper bound of the radius
+/// @param radiusLow the lower bound of the radius
+/// @param rng the random number generator
+/// @return the circles of the arm
+std::vector<Circle> GenerateCrystalArm(const int numCrystals, const int radiusHigh, const int radiusLow, RandomEngine& rng);
+
+/// @brief Generate the chain of circles of one arm of a Crystal snowflake where no circle overlaps another one or one
+/// of the 11 symmetric copies of the arm (apart from the hub at the center, where the copies meet)
+/// @param numCrystals the largest number of circles per arm
+/// @param radiusHigh the upper bound of the radius
+/// @param radiusLow the lower bound of the radius
+/// @param mirror the mirror vector the arm is drawn with
+/// @param rng the random number generator
+/// @return the circles of the arm
+/// @note a circle that would overlap tries other directions, and the arm stops growing when none is free (or when it
+/// leaves the canvas); the copies are kept in a uniform grid, so every check takes constant time
+std::vector<Circle> GenerateCrystalArm(const int numCrystals, const int radiusHigh, const int radiusLow, const Vector& mirror, RandomEngine& rng);
 
 /// @brief Draw a Crystal snowflake
-/// @param img the canvas
+/// @param canvas the canvas
 /// @param numCrystals the number of circles per arm
-void DrawCrystalSnowflake(cv::Mat& img, const int numCrystals, int radiusHigh, int radiusLow, const Vector& mirror);
+/// @param rng the random number generator
+void DrawCrystalSnowflake(Rasterizer& canvas, const int numCrystals, int radiusHigh, int radiusLow, const Vector& mirror, RandomEngine& rng);
+
+/// @brief Draw a Crystal snowflake from a pre-generated arm
+/// @param canvas the canvas
+/// @param circles the circles of one arm (see GenerateCrystalArm)
+/// @param mirror the mirror vector
+/// @param symmetric records one wedge and replicates it (D6) if the canvas is a DisplayList, e.g. for SVG output
+void DrawCrystalSnowflake(Rasterizer& canvas, const std::vector<Circle>& circles, const Vector& mirror, const bool symmetric = false);
+
+/// @brief Draw a part of the arm of a Crystal snowflake (and its 11 symmetric copies) on top of the canvas, e.g. the
+/// circles added since the previous frame of a growth animation
+/// @param canvas the canvas (holding the circles drawn so far)
+/// @param circles the circles of one arm (see GenerateCrystalArm)
+/// @param begin the first circle to draw
+/// @param end one past the last circle to draw
+/// @param mirror the mirror vector
+/// @note drawing the arm part by part gives the same snowflake as DrawCrystalSnowflake without symmetric
+void DrawCrystalGrowth(Rasterizer& canvas, const std::vector<Circle>& circles, const std::size_t begin, const std::size_t end, const Vector& mirror);
+
+/// @brief Draw a DLA snowflake: every particle of the cluster with its 11 images
+/// @param canvas the canvas
+/// @param particles the centers of the particles (see GenerateDlaCluster)
+/// @param radius the radius of the particles
+/// @param mirror the mirror vector the cluster has been grown with
+/// @param symmetric records one wedge and replicates it (D6) if the canvas is a DisplayList, e.g. for SVG output
+void DrawDlaSnowflake(Rasterizer& canvas, const std::vector<Vector>& particles, const int radius, const Vector& mirror, const bool symmetric = false);
+
+/// @brief Draw a Reiter snowflake, i.e. the frozen cells of a Reiter lattice
+/// @param canvas the canvas
+/// @param lattice the lattice (see ReiterLattice)
+/// @param spacing the distance between the centers of two neighbouring cells
+/// @note every run of frozen cells of a row is drawn as one rectangle
+void DrawReiterSnowflake(Rasterizer& canvas, const ReiterLattice& lattice, const double spacing);
 
 /// @brief Draw a hexagon
-/// @param img the canvas
+/// @param canvas the canvas
 /// @param v the orientation of the hexagon
 /// @param side the length of the side
 /// @param offset the offset
-void DrawHexagon(cv::Mat& img, const Vector& v, const int side, const Vector& offset = Vector(0, 0));
+void DrawHexagon(Rasterizer& canvas, const Vector& v, const int side, const Vector& offset = Vector(0, 0));
 
 /// @brief Draw a Stellar Plate snowflake
-/// @param img the canvas
+/// @param canvas the canvas
 /// @param v the direction of the mother hexagon
 /// @param motherSide the lenght of the mother hexagon
 /// @param sonSide the length of the son hexagon
-void DrawStellarPlateSnowflake(cv::Mat& img, const Vector& v, const int motherSide, const int sonSide);
+/// @param symmetric records one wedge and replicates it (D6) if the canvas is a DisplayList, e.g. for SVG output
+void DrawStellarPlateSnowflake(Rasterizer& canvas, const Vector& v, const int motherSide, const int sonSide, const bool symmetric = false);
 
 /// @brief Draw a Triangular Crystal snowflake
-/// @param img the canvas
+/// @param canvas the canvas
 /// @param dir the direction of the main triangle
 /// @param motherTriangleR the radius of the circumscribe of the mother triangle
 /// @param sonTriangleR the radius of the circumscribe of the son triangle
 /// @param radius the radius of the circle at the vertex
-void DrawTriangularCrystalSnowflake(cv::Mat& img, const Vector& dir, const int motherTriangleR, const int sonTriangleR, const int radius);
+void DrawTriangularCrystalSnowflake(Rasterizer& canvas, const Vector& dir, const int motherTriangleR, const int sonTriangleR, const int radius);
 
 /// @brief Saves the image using OpenCV
 /// @param filename the filename
@@ -91,6 +238,14 @@ void DrawTriangularCrystalSnowflake(cv::Mat& img, const Vector& dir, const int m
 /// @return true if the file has been saved successfully
 bool SaveImage(const std::string& filename, cv::Mat& img);
 
+/// @brief Encodes the image in memory using OpenCV
+/// @param img the image
+/// @param extension the extension of the format, e.g. ".jpg"
+/// @param bytes the encoded image
+/// @param error the reason if the image could not be encoded
+/// @return true if the image has been encoded successfully
+bool EncodeImage(const cv::Mat& img, const std::string& extension, std::vector<unsigned char>& bytes, std::string& error);
+
 /// @brief Put label on the canvas
 /// @param img the canvas
 /// @param label the label
@@ -0,0 +1,163 @@
+#ifndef INCLUDE_GRAPH_RASTERLIB_H_
+#define INCLUDE_GRAPH_RASTERLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::int64_t
+#include <memory>   // std::shared_ptr
+#include <vector>
+
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+
+class Stamp;
+
+/// @brief A colour (stored in the B, G, R order of OpenCV canvases)
+struct Colour
+{
+    unsigned char b, g, r;
+
+    /// @brief Contructor
+    constexpr Colour() : b(0), g(0), r(0) {}
+
+    /// @brief Contructor (same argument order as CV_RGB)
+    /// @param r red
+    /// @param g green
+    /// @param b blue
+    constexpr Colour(unsigned char r, unsigned char g, unsigned char b) : b(b), g(g), r(r) {}
+};
+
+/// @brief A view of an 8-bit canvas with 1 (mask) or 3 (B, G, R) interleaved channels, e.g. the data of a CV_8UC1 or CV_8UC3 cv::Mat
+struct RasterBuffer
+{
+    unsigned char* data = nullptr;
+    int rows = 0;
+    int cols = 0;
+    int channels = 0;
+    std::size_t step = 0;   // the number of bytes per row
+
+    /// @brief Checks if the rows are stored back to back
+    /// @return true if the buffer is continuous
+    bool IsContinuous() const { return step == static_cast<std::size_t>(cols) * channels; }
+};
+
+/// @brief The half width of a line drawn by the backends (like cv::line, which rounds odd widths up)
+/// @param width the width of the line (at least 1)
+/// @return the half width in pixels
+inline double LineHalfWidth(const int width)
+{
+    return (width == 1) ? 0.5 : (width + 1) / 2;
+}
+
+/// @brief The interface of the raster backends
+/// @note coordinates are in pixels with the origin at the top left corner of the canvas
+class Rasterizer
+{
+public:
+    virtual ~Rasterizer() = default;
+
+    /// @brief The number of rows of the canvas
+    virtual int Rows() const = 0;
+
+    /// @brief The number of columns of the canvas
+    virtual int Cols() const = 0;
+
+    /// @brief Get the pixels of the canvas (e.g. for a stamp)
+    /// @return the pixels
+    virtual RasterBuffer Pixels() = 0;
+
+    /// @brief Draws a filled circle
+    /// @param center the center
+    /// @param radius the radius
+    /// @param colour the colour
+    virtual void FillCircle(const Vector& center, const int radius, const Colour& colour) = 0;
+
+    /// @brief Draws a thick line with round caps (i.e. a capsule)
+    /// @param start the start point
+    /// @param end the end point
+    /// @param width the width of the line
+    /// @param colour the colour
+    virtual void DrawLine(const Vector& start, const Vector& end, const int width, const Colour& colour) = 0;
+
+    /// @brief Draws a filled convex polygon
+    /// @param points the vertices in order (either orientation)
+    /// @param colour the colour
+    virtual void FillConvexPolygon(const std::vector<Vector>& points, const Colour& colour) = 0;
+
+    /// @brief Draws a copy of a stamp (see Stamp)
+    /// @param stamp the stamp
+    /// @param transform maps the coordinates of the stamp onto the canvas (a rotation or a mirror times a scale)
+    /// @param offset the point of the canvas at the origin of the stamp
+    /// @param colour the colour
+    /// @note the default blits the solid mask of the stamp onto the pixels (or draws its primitives at large scales)
+    virtual void DrawStamp(const std::shared_ptr<const Stamp>& stamp, const Mat2& transform, const Vector& offset, const Colour& colour);
+};
+
+/// @brief The native raster backend, which fills every primitive row by row straight into the buffer
+///
+/// Without anti-aliasing the vertices are truncated to whole pixels like cv::Point and the circles follow the
+/// same midpoint spans as cv::circle, so the output matches the OpenCV backend up to the edges of lines and polygons.
+/// With anti-aliasing the exact coordinates are used and the edge pixels are blended by their approximate coverage.
+class SpanRasterizer : public Rasterizer
+{
+public:
+    /// @brief Contructor
+    /// @param buffer the canvas (must outlive the rasterizer)
+    /// @param antialias blends the edge pixels if set
+    explicit SpanRasterizer(const RasterBuffer& buffer, const bool antialias = false);
+
+    int Rows() const override { return buffer.rows; }
+
+    int Cols() const override { return buffer.cols; }
+
+    RasterBuffer Pixels() override { return buffer; }
+
+    void FillCircle(const Vector& center, const int radius, const Colour& colour) override;
+
+    void DrawLine(const Vector& start, const Vector& end, const int width, const Colour& colour) override;
+
+    void FillConvexPolygon(const std::vector<Vector>& points, const Colour& colour) override;
+
+    /// @brief Blits the mask of the stamp (anti-aliased if the rasterizer is), or draws its primitives at large scales
+    void DrawStamp(const std::shared_ptr<const Stamp>& stamp, const Mat2& transform, const Vector& offset, const Colour& colour) override;
+
+private:
+    /// @brief A point in 16.16 fixed point
+    struct FixedPoint
+    {
+        std::int64_t x, y;
+    };
+
+    /// @brief Fills the pixels [x0, x1] of row y (clipped to the canvas)
+    void FillSpan(const int y, int x0, int x1, const Colour& colour);
+
+    /// @brief Fills a pixel if it is on the canvas
+    void PutPixel(const std::int64_t y, const std::int64_t x, const Colour& colour);
+
+    /// @brief Blends a pixel with the colour by the given coverage in [0, 1]
+    void BlendPixel(const int y, const int x, const Colour& colour, const double coverage);
+
+    /// @brief Get the half widths of the rows of a cv::circle of the given radius (cached)
+    const std::vector<int>& CircleSpans(const int radius);
+
+    /// @brief Fills a row: solid inside [innerLo, innerHi] and blended by coverage(x) elsewhere in [outerLo, outerHi]
+    template<typename Coverage>
+    void FillRow(const int y, const double outerLo, const double outerHi, bool hasInner, const double innerLo, const double innerHi, const Colour& colour, Coverage coverage);
+
+    /// @brief Draws the one pixel wide outline of an edge like cv::line does on sub-pixel points
+    void TraceEdge(FixedPoint p, FixedPoint q, const Colour& colour);
+
+    /// @brief Fills a convex polygon and its outline with the same edge walk as cv::fillConvexPoly
+    void FillPolygonSolid(const std::vector<FixedPoint>& points, const Colour& colour);
+
+    /// @brief Draws an anti-aliased capsule of radius rho around the segment [a, b] (a disc if a == b)
+    void FillCapsuleAA(const Vector& a, const Vector& b, const double rho, const Colour& colour);
+
+    /// @brief Draws an anti-aliased convex polygon
+    void FillPolygonAA(const std::vector<Vector>& points, const Colour& colour);
+
+    RasterBuffer buffer;
+    bool antialias;
+    std::vector<std::vector<int>> circleSpans;  // indexed by the radius
+};
+
+#endif  // INCLUDE_GRAPH_RASTERLIB_H_
@@ -0,0 +1,97 @@
+#ifndef INCLUDE_GRAPH_STAMPLIB_H_
+#define INCLUDE_GRAPH_STAMPLIB_H_
+
+#include <deque>
+#include <memory>   // std::shared_ptr
+#include <mutex>    // std::mutex
+#include <utility>  // std::pair
+#include <vector>
+
+#include "graph/rasterlib.hpp"
+#include "graph/displaylistlib.hpp"
+#include "graph/tilelib.hpp"
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+
+// the largest mask; a copy at a larger scale is drawn from the primitives of the shape (a quarter of a strip of a tiled image)
+#define STAMP_MAX_MASK_BYTES (STRIP_BYTES / 4)
+
+/// @brief A shape that is drawn many times with different transforms, e.g. a subtree of a dendrite
+///
+/// The shape is recorded once in its own coordinates (it may draw smaller stamps itself) and rasterized into a coverage
+/// mask the first time it is needed at a scale; every later copy at that scale only maps the pixels of the mask. So a
+/// shape made of copies of copies costs a mask per level instead of every primitive of every copy. A copy whose mask
+/// would be larger than STAMP_MAX_MASK_BYTES (e.g. the top levels of a huge tiled image) draws the primitives of the
+/// shape instead, so the masks never hold more than a few MB.
+/// @note the shape is recorded in white (the mask keeps its blue channel as the coverage), and every copy is drawn in
+/// the colour given to DrawStamp
+class Stamp
+{
+public:
+    /// @brief Contructor
+    /// @param shape the primitives of the stamp in its own coordinates (without Replicate commands)
+    explicit Stamp(const DisplayList& shape);
+
+    /// @brief Get the shape
+    /// @return the primitives of the stamp
+    const DisplayList& Shape() const { return shape; }
+
+    /// @brief Get the lower corner of the box around the shape
+    /// @return the lower corner
+    const Vector& Lower() const { return lower; }
+
+    /// @brief Get the upper corner of the box around the shape
+    /// @return the upper corner
+    const Vector& Upper() const { return upper; }
+
+    /// @brief The memory held by the masks rasterized so far
+    /// @return the number of bytes
+    std::size_t MaskBytes() const;
+
+    /// @brief Draws a copy of the stamp, from its mask if the mask is small enough or else from its primitives
+    /// @param target the canvas
+    /// @param transform maps the coordinates of the stamp onto the pixels (a rotation or a mirror times a scale)
+    /// @param offset the pixel of the origin of the stamp
+    /// @param colour the colour
+    /// @param antialias uses an anti-aliased mask if set
+    void Draw(Rasterizer& target, const Mat2& transform, const Vector& offset, const Colour& colour, const bool antialias) const;
+
+    /// @brief Draws the stamp onto pixels from its mask
+    ///
+    /// Every pixel p of the box around the copy looks up the nearest pixel of the mask at the inverse transform of p
+    /// (or interpolates the 4 nearest ones if the mask is anti-aliased), and is painted by its coverage.
+    /// @param pixels the canvas
+    /// @param transform maps the coordinates of the stamp onto the pixels (a rotation or a mirror times a scale)
+    /// @param offset the pixel of the origin of the stamp
+    /// @param colour the colour
+    /// @param antialias uses an anti-aliased mask if set
+    /// @note safe to call from several threads, e.g. on the strips of one image
+    void Blit(const RasterBuffer& pixels, const Mat2& transform, const Vector& offset, const Colour& colour, const bool antialias) const;
+
+private:
+    /// @brief The shape rasterized at a scale, where the point p of the shape is at the pixel scale * p - origin
+    struct Mask
+    {
+        double scale;
+        bool antialias;
+        Vector origin;
+        int rows, cols;
+        std::vector<unsigned char> coverage;
+    };
+
+    /// @brief Get the size of the mask of a scale
+    /// @param scale the scale
+    /// @param origin the pixel of the mask at the origin of the shape
+    /// @return the number of rows and columns
+    std::pair<int, int> MaskSize(const double scale, Vector& origin) const;
+
+    /// @brief Get the mask of a scale, rasterizing it if needed
+    const Mask& MaskOf(const double scale, const bool antialias) const;
+
+    DisplayList shape;
+    Vector lower, upper;
+    mutable std::deque<Mask> masks;     // never moves the masks handed out
+    mutable std::mutex mutex;
+};
+
+#endif  // INCLUDE_GRAPH_STAMPLIB_H_
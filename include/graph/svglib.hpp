@@ -0,0 +1,26 @@
+#ifndef INCLUDE_GRAPH_SVGLIB_H_
+#define INCLUDE_GRAPH_SVGLIB_H_
+
+#include <ostream>
+#include <string>
+
+#include "graph/displaylistlib.hpp"
+
+/// @brief Writes a display list as an SVG image, one element per command
+///
+/// The commands before a Replicate command become a group in <defs> that is placed once per element of the symmetry
+/// group with <use> and a rotation (or mirror) transform, so a symmetric snowflake only stores one wedge.
+/// @param out the output stream
+/// @param list the display list
+/// @param label the label at the top of the image (none if empty)
+/// @return true if the image has been written successfully
+bool WriteSvg(std::ostream& out, const DisplayList& list, const std::string& label = "");
+
+/// @brief Saves a display list as an SVG file
+/// @param filename the filename
+/// @param list the display list
+/// @param label the label at the top of the image (none if empty)
+/// @return true if the file has been saved successfully
+bool SaveSvg(const std::string& filename, const DisplayList& list, const std::string& label = "");
+
+#endif  // INCLUDE_GRAPH_SVGLIB_H_
@@ -0,0 +1,25 @@
+#ifndef INCLUDE_GRAPH_TILELIB_H_
+#define INCLUDE_GRAPH_TILELIB_H_
+
+#include <string>
+
+#include "graph/displaylistlib.hpp"
+
+// the maximum number of bytes of a strip of the tiled renderer
+#define STRIP_BYTES (8 << 20)
+
+/// @brief Renders a display list onto a PNG file of any size, one strip of full rows at a time
+///
+/// The strips are rasterized independently on numJobs threads with the native backend and streamed to the file in
+/// order, so the memory used stays at a few strips however large the image is.
+/// @param list the snowflake (its canvas is scaled up to the size of the image)
+/// @param size the number of columns of the image (the rows keep the aspect ratio of the list)
+/// @param channels 1 (mask) or 3 (colour)
+/// @param antialias blends the edge pixels if set
+/// @param filename the filename of the PNG file
+/// @param numJobs the number of threads rasterizing strips
+/// @param error the reason if the file could not be saved
+/// @return true if the file has been saved successfully
+bool RenderTiledPng(const DisplayList& list, const int size, const int channels, const bool antialias, const std::string& filename, const unsigned int numJobs, std::string& error);
+
+#endif  // INCLUDE_GRAPH_TILELIB_H_
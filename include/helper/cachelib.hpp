@@ -0,0 +1,130 @@
+#ifndef INCLUDE_HELPER_CACHELIB_H_
+#define INCLUDE_HELPER_CACHELIB_H_
+
+#include <atomic>   // std::atomic
+#include <cstdint>  // std::uint64_t
+#include <list>
+#include <mutex>    // std::mutex
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// the index of a cache directory (JSON Lines, one file per line)
+#define CACHE_INDEX_NAME "index.jsonl"
+
+// the folder of the cached files in a cache directory
+#define CACHE_OBJECTS_NAME "objects"
+
+/// @brief Hashes a key with 64-bit FNV-1a
+/// @param key the key
+/// @return the hash as 16 hexadecimal digits
+std::string HashKey(const std::string& key);
+
+/// @brief A persistent on-disk cache of files (e.g. encoded images) addressed by the hash of a key, which evicts the
+/// least recently used files past a size limit
+///
+/// Every file is stored as objects/<hash of the key> next to an index of the keys, sizes, recency and metadata, so a
+/// lookup is a hash map probe and a hit is a hard link (or a copy) of the cached file. The full key is kept in the
+/// index and compared on lookup, so a collision of the hashes is a miss rather than a wrong file. The methods are
+/// thread-safe, but a cache directory is only used by one process at a time. The index is saved by Close, and files
+/// stored by a run that did not close the cache are dropped the next time it is opened.
+class RenderCache
+{
+public:
+    /// @brief Contructor (a closed cache)
+    RenderCache() = default;
+
+    RenderCache(const RenderCache&) = delete;
+    RenderCache& operator=(const RenderCache&) = delete;
+
+    /// @brief Opens (or creates) a cache directory and loads its index
+    /// @param directory the cache directory
+    /// @param capacity the maximum number of bytes of the cached files
+    /// @param error the reason if the cache could not be opened
+    /// @return true if the cache has been opened
+    bool Open(const std::string& directory, const std::uint64_t capacity, std::string& error);
+
+    /// @brief Checks if the cache is open
+    /// @return true if open
+    bool IsOpen() const { return !directory.empty(); }
+
+    /// @brief Puts the cached file of a key at the given path (a hard link if possible, otherwise a copy)
+    /// @param key the key
+    /// @param filename the path (replaced if it exists)
+    /// @param metadata the metadata stored with the file
+    /// @return true on a hit
+    bool Fetch(const std::string& key, const std::string& filename, std::string& metadata);
+
+    /// @brief Reads the cached file of a key
+    /// @param key the key
+    /// @param bytes the content of the file
+    /// @param metadata the metadata stored with the file
+    /// @return true on a hit
+    bool Fetch(const std::string& key, std::vector<unsigned char>& bytes, std::string& metadata);
+
+    /// @brief Adds a file that has been written already (as a hard link if possible, otherwise a copy)
+    /// @param key the key
+    /// @param filename the file
+    /// @param metadata the metadata to store with the file (e.g. the parameters of an image)
+    /// @param error the reason if the file could not be added
+    /// @return true if the file has been added
+    bool Store(const std::string& key, const std::string& filename, const std::string& metadata, std::string& error);
+
+    /// @brief Adds bytes as a file
+    /// @param key the key
+    /// @param bytes the content of the file
+    /// @param metadata the metadata to store with the file
+    /// @param error the reason if the file could not be added
+    /// @return true if the file has been added
+    bool Store(const std::string& key, const std::vector<unsigned char>& bytes, const std::string& metadata, std::string& error);
+
+    /// @brief Saves the index and closes the cache
+    /// @param error the reason if the index could not be saved
+    /// @return true if the index has been saved
+    bool Close(std::string& error);
+
+    /// @brief The number of hits so far
+    std::uint64_t Hits() const { return hits; }
+
+    /// @brief The number of misses so far
+    std::uint64_t Misses() const { return misses; }
+
+    /// @brief The number of bytes of the cached files
+    std::uint64_t Size() const;
+
+private:
+    /// @brief A cached file
+    struct Entry
+    {
+        std::string hash;
+        std::string key;
+        std::uint64_t size = 0;
+        std::string metadata;
+    };
+
+    /// @brief Finds the entry of a key and marks it as the most recently used
+    /// @return the path of the file or an empty string if there is none
+    std::string Touch(const std::string& key, std::string& metadata);
+
+    /// @brief Moves a complete temporary file into the objects, adds its entry and evicts past the capacity
+    bool Insert(const std::string& key, const std::string& temporary, const std::uint64_t size, const std::string& metadata, std::string& error);
+
+    /// @brief Removes the least recently used files until the cache fits the capacity (needs the lock)
+    void Evict();
+
+    /// @brief The path of a cached file
+    std::string ObjectPath(const std::string& hash) const;
+
+    /// @brief A unique path for a file on its way into the objects
+    std::string TemporaryPath();
+
+    std::string directory;
+    std::uint64_t capacity = 0;
+    std::uint64_t size = 0;
+    std::list<Entry> entries;   // the most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;     // by hash
+    std::atomic<std::uint64_t> hits{0}, misses{0}, numTemporaries{0};
+    mutable std::mutex mutex;
+};
+
+#endif  // INCLUDE_HELPER_CACHELIB_H_
@@ -0,0 +1,22 @@
+#ifndef INCLUDE_HELPER_FILELIB_H_
+#define INCLUDE_HELPER_FILELIB_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// @brief Opens a new file for writing (replacing the old one rather than writing through its hard links)
+/// @param file the stream to open
+/// @param filename the filename
+/// @param mode the open mode (always truncating output)
+/// @return true if the file has been opened successfully
+bool OpenNewFile(std::ofstream& file, const std::string& filename, std::ios::openmode mode = std::ios::out);
+
+/// @brief Writes bytes to a new file (replacing the old one rather than writing through its hard links)
+/// @param filename the filename
+/// @param bytes the content of the file
+/// @param error the reason if the file could not be written
+/// @return true if the file has been written successfully
+bool WriteFile(const std::string& filename, const std::vector<unsigned char>& bytes, std::string& error);
+
+#endif  // INCLUDE_HELPER_FILELIB_H_
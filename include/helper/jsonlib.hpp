@@ -0,0 +1,103 @@
+#ifndef INCLUDE_HELPER_JSONLIB_H_
+#define INCLUDE_HELPER_JSONLIB_H_
+
+#include <ostream>
+#include <string>
+#include <type_traits>  // std::enable_if_t, std::is_integral_v, std::is_same_v
+#include <utility>  // std::pair
+#include <vector>
+
+// the number of significant digits of the numbers written as JSON
+#define JSON_PRECISION 10
+
+// the deepest nesting of arrays and objects ParseJson accepts
+#define JSON_MAX_DEPTH 256
+
+/// @brief Escapes a string for a JSON string (without the quotes)
+/// @param text the string
+/// @return the escaped string
+std::string JsonEscape(const std::string& text);
+
+/// @brief Writes a JSON document to a stream token by token, putting the commas and quotes in between
+///
+/// The writer does not check the structure, so every Begin must be matched by its End and every value of an object
+/// must follow its Key.
+class JsonWriter
+{
+public:
+    /// @brief Contructor
+    /// @param out the stream (must outlive the writer)
+    explicit JsonWriter(std::ostream& out) : out(out) {}
+
+    /// @brief Opens an object
+    JsonWriter& BeginObject();
+
+    /// @brief Closes the innermost object
+    JsonWriter& EndObject();
+
+    /// @brief Opens an array
+    JsonWriter& BeginArray();
+
+    /// @brief Closes the innermost array
+    JsonWriter& EndArray();
+
+    /// @brief Writes the key of the next value of an object
+    /// @param key the key
+    JsonWriter& Key(const std::string& key);
+
+    /// @brief Writes a string
+    JsonWriter& Value(const std::string& value);
+
+    /// @brief Writes a string
+    JsonWriter& Value(const char* value) { return Value(std::string(value)); }
+
+    /// @brief Writes a number (null if it is not finite)
+    JsonWriter& Value(const double value);
+
+    /// @brief Writes true or false
+    JsonWriter& Value(const bool value);
+
+    /// @brief Writes an integer exactly
+    template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    JsonWriter& Value(const T value)
+    {
+        Separate();
+        out << value;
+        return *this;
+    }
+
+private:
+    /// @brief Writes the comma before every element but the first of an array or object
+    void Separate();
+
+    std::ostream& out;
+    std::vector<bool> isFirst;  // one per open array or object
+    bool isAfterKey = false;
+};
+
+/// @brief A parsed JSON value
+struct JsonValue
+{
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string text;   // the string, or the literal of a number (to read large integers exactly)
+    std::vector<JsonValue> elements;    // the elements of an array
+    std::vector<std::pair<std::string, JsonValue>> members;     // the members of an object in their order
+
+    /// @brief Finds a member of an object
+    /// @param key the key
+    /// @return the first member with the key or nullptr if there is none
+    const JsonValue* Find(const std::string& key) const;
+};
+
+/// @brief Parses a JSON document (e.g. a line of a JSON Lines file)
+/// @param text the document
+/// @param value the parsed value
+/// @param error the reason if the document is not valid
+/// @return true if the document has been parsed successfully
+bool ParseJson(const std::string& text, JsonValue& value, std::string& error);
+
+#endif  // INCLUDE_HELPER_JSONLIB_H_
@@ -0,0 +1,96 @@
+#ifndef INCLUDE_HELPER_PACKLIB_H_
+#define INCLUDE_HELPER_PACKLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <fstream>
+#include <string>
+#include <vector>
+
+// the magic bytes at the start and the end of a pack file
+#define PACK_MAGIC "SNOWPACK"
+
+/// @brief An entry of a pack file
+struct PackEntry
+{
+    std::string name;
+    std::uint64_t offset = 0;   // the position of the first byte in the file
+    std::uint64_t size = 0;     // the number of bytes
+};
+
+/// @brief Appends files (e.g. encoded images) back to back to a single pack file, so a batch costs one file instead of
+/// one per image
+///
+/// The layout is the magic, the contents of the entries, the index (offset, size, name length and name of every entry)
+/// and a footer (the offset of the index, the number of entries and the magic), all integers little-endian.
+/// The index is written last, so nothing has to be known in advance and a reader seeks straight to any entry.
+class PackWriter
+{
+public:
+    /// @brief Contructor (a closed writer)
+    PackWriter() = default;
+
+    PackWriter(const PackWriter&) = delete;
+    PackWriter& operator=(const PackWriter&) = delete;
+
+    /// @brief Creates the file (replacing it)
+    /// @param filename the filename
+    /// @param error the reason if the file could not be created
+    /// @return true if the file has been created
+    bool Open(const std::string& filename, std::string& error);
+
+    /// @brief Appends an entry
+    /// @param name the name of the entry (e.g. its filename)
+    /// @param bytes the content of the entry
+    /// @param error the reason if the entry could not be written
+    /// @return true if the entry has been written
+    bool Append(const std::string& name, const std::vector<unsigned char>& bytes, std::string& error);
+
+    /// @brief Writes the index and closes the file
+    /// @param error the reason if the file could not be finished
+    /// @return true if the file is complete
+    bool Close(std::string& error);
+
+    /// @brief The entries appended so far
+    /// @return the entries
+    const std::vector<PackEntry>& Entries() const { return entries; }
+
+private:
+    std::ofstream file;
+    std::string filename;
+    std::uint64_t offset = 0;
+    std::vector<PackEntry> entries;
+};
+
+/// @brief Reads the entries of a pack file by index
+class PackReader
+{
+public:
+    /// @brief Reads the index of a pack file
+    /// @param filename the filename
+    /// @param error the reason if the file is not a complete pack file
+    /// @return true if the index has been read
+    bool Open(const std::string& filename, std::string& error);
+
+    /// @brief The number of entries
+    /// @return the number of entries
+    std::size_t Size() const { return entries.size(); }
+
+    /// @brief The entries in the order they were appended
+    /// @return the entries
+    const std::vector<PackEntry>& Entries() const { return entries; }
+
+    /// @brief Reads the content of an entry
+    /// @param index the index of the entry
+    /// @param bytes the content of the entry
+    /// @param error the reason if the entry could not be read
+    /// @return true if the entry has been read
+    bool Read(const std::size_t index, std::vector<unsigned char>& bytes, std::string& error);
+
+private:
+    std::ifstream file;
+    std::string filename;
+    std::vector<PackEntry> entries;
+};
+
+#endif  // INCLUDE_HELPER_PACKLIB_H_
@@ -0,0 +1,166 @@
+#ifndef INCLUDE_HELPER_PIPELINELIB_H_
+#define INCLUDE_HELPER_PIPELINELIB_H_
+
+#include <algorithm>    // std::max
+#include <atomic>   // std::atomic
+#include <cstddef>  // std::size_t
+#include <exception>    // std::exception
+#include <functional>   // std::function
+#include <mutex>    // std::mutex
+#include <string>
+#include <thread>   // std::thread
+#include <utility>  // std::move
+#include <vector>
+
+#include "helper/threadlib.hpp"
+
+/// @brief A bounded two-stage pipeline: the producers submit items, a pool of workers transforms them (e.g. encodes
+/// images) and a single consumer thread takes the results (e.g. writes files) in the order they are done
+///
+/// Both queues are bounded, so the producers wait whenever the workers or the consumer fall behind and at most about
+/// 2 * capacity + numWorkers items are alive at any time.
+/// @tparam Input the type of the submitted items
+/// @tparam Output the type of the transformed items
+template<typename Input, typename Output>
+class Pipeline
+{
+public:
+    /// @brief Transforms an item; returns false and sets the error message on failure
+    using Transform = std::function<bool(Input&, Output&, std::string&)>;
+
+    /// @brief Consumes a transformed item; returns false and sets the error message on failure
+    using Consume = std::function<bool(Output&, std::string&)>;
+
+    /// @brief Contructor (starts the threads)
+    /// @param numWorkers the number of worker threads (at least 1)
+    /// @param capacity the capacity of each queue
+    /// @param transform the work of the workers
+    /// @param consume the work of the consumer
+    Pipeline(const unsigned int numWorkers, const std::size_t capacity, Transform transform, Consume consume)
+        : inputs(capacity), outputs(capacity), transform(std::move(transform)), consume(std::move(consume))
+    {
+        for (unsigned int i = 0; i < std::max(numWorkers, 1u); ++i)
+        {
+            workers.emplace_back([this]() { Work(); });
+        }
+        consumer = std::thread([this]() { ConsumeAll(); });
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /// @brief Destructor (waits for the submitted items)
+    ~Pipeline()
+    {
+        Finish();
+    }
+
+    /// @brief Hands an item to the workers, waiting while the queue is full
+    /// @param item the item
+    /// @return false if the pipeline has failed or finished (the item is dropped)
+    bool Submit(Input item)
+    {
+        return !HasFailed() && inputs.Push(std::move(item));
+    }
+
+    /// @brief Waits until every submitted item has been consumed and stops the threads
+    /// @return true if no item has failed
+    bool Finish()
+    {
+        if (!finished)
+        {
+            finished = true;
+            inputs.Close();
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+            outputs.Close();
+            consumer.join();
+        }
+
+        return !HasFailed();
+    }
+
+    /// @brief Checks if any item has failed so far
+    /// @return true if an item has failed
+    bool HasFailed() const
+    {
+        return failed;
+    }
+
+    /// @brief Get the error messages of the failed items
+    /// @return the error messages
+    std::vector<std::string> Errors() const
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        return errors;
+    }
+
+private:
+    /// @brief Records the error of an item
+    void Fail(const std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        errors.push_back(error);
+        failed = true;
+    }
+
+    /// @brief The loop of a worker
+    void Work()
+    {
+        Input input;
+        while (inputs.Pop(input))
+        {
+            Output output;
+            std::string error;
+            try
+            {
+                if (!transform(input, output, error))
+                {
+                    Fail(error);
+                    continue;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                Fail(e.what());
+                continue;
+            }
+
+            outputs.Push(std::move(output));
+        }
+    }
+
+    /// @brief The loop of the consumer
+    void ConsumeAll()
+    {
+        Output output;
+        while (outputs.Pop(output))
+        {
+            std::string error;
+            try
+            {
+                if (!consume(output, error))
+                    Fail(error);
+            }
+            catch (const std::exception& e)
+            {
+                Fail(e.what());
+            }
+        }
+    }
+
+    BoundedQueue<Input> inputs;
+    BoundedQueue<Output> outputs;
+    Transform transform;
+    Consume consume;
+    std::vector<std::thread> workers;
+    std::thread consumer;
+    bool finished = false;
+    std::atomic<bool> failed{false};
+    mutable std::mutex errorMutex;
+    std::vector<std::string> errors;
+};
+
+#endif  // INCLUDE_HELPER_PIPELINELIB_H_
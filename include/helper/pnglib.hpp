@@ -0,0 +1,73 @@
+#ifndef INCLUDE_HELPER_PNGLIB_H_
+#define INCLUDE_HELPER_PNGLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <fstream>
+#include <memory>   // std::unique_ptr
+#include <string>
+#include <vector>
+
+// the zlib level of the PNG writer (1 is the fastest, 9 the smallest)
+#define PNG_COMPRESSION_LEVEL 3
+
+struct z_stream_s;
+
+/// @brief A PNG writer that takes the image a few rows at a time, so an image of any size is written without ever being
+/// held in memory as a whole
+///
+/// The rows are deflated into IDAT chunks as they come, so the writer only buffers one compressed chunk.
+class PngWriter
+{
+public:
+    /// @brief Contructor (a closed writer)
+    PngWriter();
+
+    PngWriter(const PngWriter&) = delete;
+    PngWriter& operator=(const PngWriter&) = delete;
+
+    /// @brief Destructor (an unfinished file is left truncated)
+    ~PngWriter();
+
+    /// @brief Creates the file and writes the header
+    /// @param filename the filename
+    /// @param rows the number of rows of the image
+    /// @param cols the number of columns of the image
+    /// @param channels 1 (grayscale) or 3 (colour)
+    /// @param error the reason if the file could not be created
+    /// @return true if the file has been created
+    bool Open(const std::string& filename, const int rows, const int cols, const int channels, std::string& error);
+
+    /// @brief Appends rows to the image
+    /// @param data the first pixel of the first row (B, G, R interleaved like OpenCV canvases if there are 3 channels)
+    /// @param numRows the number of rows
+    /// @param step the number of bytes per row of data
+    /// @param error the reason if the rows could not be written
+    /// @return true if the rows have been written
+    bool WriteRows(const unsigned char* data, const int numRows, const std::size_t step, std::string& error);
+
+    /// @brief Writes the end of the image once all rows have been written and closes the file
+    /// @param error the reason if the file could not be finished
+    /// @return true if the file is complete
+    bool Close(std::string& error);
+
+    /// @brief The number of rows written so far
+    /// @return the number of rows
+    int RowsWritten() const { return rowsWritten; }
+
+private:
+    /// @brief Writes a chunk (length, type, data and CRC)
+    bool WriteChunk(const char* type, const unsigned char* data, const std::size_t size, std::string& error);
+
+    /// @brief Feeds the input of the stream to zlib and flushes every full IDAT chunk
+    bool Deflate(const int flush, std::string& error);
+
+    std::ofstream file;
+    std::string filename;
+    std::unique_ptr<z_stream_s> stream;
+    int rows = 0, cols = 0, channels = 0;
+    int rowsWritten = 0;
+    std::vector<unsigned char> row;     // the filter byte and the pixels of one row in PNG order
+    std::vector<unsigned char> chunk;   // the compressed data of the next IDAT chunk
+};
+
+#endif  // INCLUDE_HELPER_PNGLIB_H_
@@ -0,0 +1,75 @@
+#ifndef INCLUDE_HELPER_POOLLIB_H_
+#define INCLUDE_HELPER_POOLLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <mutex>    // std::mutex
+#include <vector>
+
+/// @brief A thread-safe pool of equally sized byte buffers (e.g. canvases) that are recycled instead of freed
+///
+/// A buffer is zeroed when it comes back, so the next render gets a black canvas without a new allocation or the
+/// page faults of fresh memory. The pool only grows to the peak number of buffers in use at the same time.
+class BufferPool
+{
+public:
+    /// @brief A buffer taken from the pool, which goes back to the pool when the handle is reset or destroyed
+    class Handle
+    {
+    public:
+        /// @brief Contructor (an empty handle)
+        Handle() = default;
+
+        Handle(Handle&& other) noexcept;
+        Handle& operator=(Handle&& other) noexcept;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        /// @brief Destructor (gives the buffer back)
+        ~Handle();
+
+        /// @brief Gives the buffer back to the pool early
+        void Reset();
+
+        /// @brief Get the bytes of the buffer
+        /// @return the bytes (nullptr if empty)
+        unsigned char* Data() { return buffer.data(); }
+
+        /// @brief The size of the buffer in bytes
+        /// @return the size (0 if empty)
+        std::size_t Size() const { return buffer.size(); }
+
+    private:
+        friend class BufferPool;
+
+        Handle(BufferPool* pool, std::vector<unsigned char>&& buffer);
+
+        BufferPool* pool = nullptr;
+        std::vector<unsigned char> buffer;
+    };
+
+    /// @brief Contructor
+    /// @param size the size of every buffer in bytes
+    explicit BufferPool(const std::size_t size);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /// @brief Takes a zeroed buffer (allocates one if none is idle)
+    /// @return the buffer (must be given back before the pool is destroyed)
+    Handle Acquire();
+
+    /// @brief The number of buffers the pool has allocated so far
+    /// @return the number of buffers
+    std::size_t NumAllocated() const;
+
+private:
+    /// @brief Zeroes a buffer and puts it back
+    void Release(std::vector<unsigned char>&& buffer);
+
+    std::size_t size;
+    std::size_t numAllocated = 0;
+    std::vector<std::vector<unsigned char>> idle;
+    mutable std::mutex mutex;
+};
+
+#endif  // INCLUDE_HELPER_POOLLIB_H_
@@ -0,0 +1,103 @@
+#ifndef INCLUDE_HELPER_PROFILELIB_H_
+#define INCLUDE_HELPER_PROFILELIB_H_
+
+#include <cstdint>  // std::int64_t
+#include <ostream>
+#include <string>
+
+// compiles the timers of PROFILE_SCOPE and friends in (set by the SNOWFLAKES_PROFILING option of CMake)
+#ifndef SNOWFLAKES_PROFILING
+#define SNOWFLAKES_PROFILING 0
+#endif
+
+/// @brief Collects the spans of the timers and the latencies of the items of a run (e.g. a batch of images)
+///
+/// Every thread records into its own buffer, so a timer costs two clock reads and an append. Nothing is recorded until
+/// the profiler is enabled, and the results must only be read once the recording threads are done.
+class Profiler
+{
+public:
+    /// @brief Starts recording (the start of the run)
+    static void Enable();
+
+    /// @brief Checks if the profiler is recording
+    /// @return true if recording
+    static bool IsEnabled();
+
+    /// @brief The current time
+    /// @return the time in nanoseconds of a steady clock
+    static std::int64_t Now();
+
+    /// @brief Records a span of the calling thread
+    /// @param name the name of the span (a string literal)
+    /// @param start the start time (see Now)
+    /// @param end the end time (see Now)
+    static void Record(const char* name, const std::int64_t start, const std::int64_t end);
+
+    /// @brief Records the latency of an item from its start until now
+    /// @param name the kind of the item (a string literal)
+    /// @param start the start time (see Now)
+    static void RecordLatency(const char* name, const std::int64_t start);
+
+    /// @brief Writes the spans as Chrome trace events (for chrome://tracing or Perfetto)
+    /// @param filename the filename
+    /// @param error the reason if the file could not be written
+    /// @return true if the file has been written successfully
+    static bool WriteTrace(const std::string& filename, std::string& error);
+
+    /// @brief Prints the throughput and the p50, p99 and max of the latencies and of the spans of every stage
+    /// @param out the stream
+    static void PrintSummary(std::ostream& out);
+};
+
+/// @brief Records a span from its construction until its destruction (or Stop)
+class ScopedTimer
+{
+public:
+    /// @brief Contructor
+    /// @param name the name of the span (a string literal)
+    explicit ScopedTimer(const char* name) : name(name), start(Profiler::IsEnabled() ? Profiler::Now() : -1) {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    /// @brief Destructor (ends the span)
+    ~ScopedTimer()
+    {
+        Stop();
+    }
+
+    /// @brief Ends the span early
+    void Stop()
+    {
+        if (start >= 0)
+            Profiler::Record(name, start, Profiler::Now());
+        start = -1;
+    }
+
+private:
+    const char* name;
+    std::int64_t start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if SNOWFLAKES_PROFILING
+// times the rest of the scope
+#define PROFILE_SCOPE(name) ScopedTimer PROFILE_CONCAT(scopedTimer, __LINE__)(name)
+// times from here until PROFILE_END(timer)
+#define PROFILE_BEGIN(timer, name) ScopedTimer timer(name)
+#define PROFILE_END(timer) timer.Stop()
+// the start time of an item (see Profiler::RecordLatency)
+#define PROFILE_NOW() Profiler::Now()
+#define PROFILE_LATENCY(name, start) Profiler::RecordLatency(name, start)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_BEGIN(timer, name)
+#define PROFILE_END(timer)
+#define PROFILE_NOW() std::int64_t(0)
+#define PROFILE_LATENCY(name, start)
+#endif
+
+#endif  // INCLUDE_HELPER_PROFILELIB_H_
@@ -0,0 +1,90 @@
+#ifndef INCLUDE_HELPER_STREAMLIB_H_
+#define INCLUDE_HELPER_STREAMLIB_H_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <cstdio>   // std::FILE
+#include <string>
+#include <vector>
+
+// the frame rate in the header of a Y4M stream
+#define STREAM_FRAME_RATE 30
+
+// the buffer of the stream in bytes
+#define STREAM_BUFFER_SIZE (1 << 20)
+
+/// @brief Writes frames one after another to a file, a FIFO or stdout, so the images go straight into another process
+/// (e.g. ffmpeg or a training loader) without any intermediate files
+///
+/// The kinds of stream are
+/// - "raw": the pixels of every frame back to back (B, G, R interleaved or grayscale, like OpenCV canvases),
+/// - "y4m": a YUV4MPEG2 stream (4:4:4 in BT.601 limited range, or mono for a grayscale frame),
+/// - "frames": every frame as a little-endian 32-bit length followed by its encoded bytes.
+/// All raw and Y4M frames must have the same size. A raw frame is written straight from its canvas, while a Y4M colour
+/// frame is converted into a buffer that is reused for every frame.
+class FrameStream
+{
+public:
+    /// @brief Contructor (a closed stream)
+    FrameStream() = default;
+
+    FrameStream(const FrameStream&) = delete;
+    FrameStream& operator=(const FrameStream&) = delete;
+
+    /// @brief Destructor (closes the stream)
+    ~FrameStream();
+
+    /// @brief Checks if a kind of stream exists
+    /// @param kind the kind ("raw", "y4m" or "frames")
+    /// @return true if the kind exists
+    static bool IsKind(const std::string& kind);
+
+    /// @brief Opens the stream
+    /// @param path the file or FIFO ("-" for stdout)
+    /// @param kind the kind of stream (see IsKind)
+    /// @param error the reason if the stream could not be opened
+    /// @return true if the stream has been opened
+    bool Open(const std::string& path, const std::string& kind, std::string& error);
+
+    /// @brief Checks if the stream takes the pixels of the frames (raw or Y4M) rather than encoded frames
+    /// @return true if the stream takes pixels
+    bool IsRaw() const { return kind != "frames"; }
+
+    /// @brief Writes the pixels of a frame (raw and Y4M streams)
+    /// @param data the first pixel of the first row
+    /// @param rows the number of rows
+    /// @param cols the number of columns
+    /// @param channels 1 (grayscale) or 3 (B, G, R)
+    /// @param step the number of bytes per row of data
+    /// @param error the reason if the frame could not be written
+    /// @return true if the frame has been written
+    bool WriteFrame(const unsigned char* data, const int rows, const int cols, const int channels, const std::size_t step, std::string& error);
+
+    /// @brief Writes an encoded frame (frames streams)
+    /// @param bytes the encoded frame
+    /// @param error the reason if the frame could not be written
+    /// @return true if the frame has been written
+    bool WriteEncoded(const std::vector<unsigned char>& bytes, std::string& error);
+
+    /// @brief Flushes and closes the stream
+    /// @param error the reason if the stream could not be flushed
+    /// @return true if all frames have been written
+    bool Close(std::string& error);
+
+    /// @brief The number of frames written so far
+    /// @return the number of frames
+    std::uint64_t NumFrames() const { return numFrames; }
+
+private:
+    /// @brief Writes bytes
+    bool Write(const void* data, const std::size_t size, std::string& error);
+
+    std::FILE* file = nullptr;
+    std::string path;
+    std::string kind;
+    int rows = 0, cols = 0, channels = 0;   // the size of the first frame
+    std::uint64_t numFrames = 0;
+    std::vector<unsigned char> planes;  // the Y, U and V planes of a Y4M colour frame
+};
+
+#endif  // INCLUDE_HELPER_STREAMLIB_H_
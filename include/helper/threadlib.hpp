@@ -0,0 +1,177 @@
+#ifndef INCLUDE_HELPER_THREADLIB_H_
+#define INCLUDE_HELPER_THREADLIB_H_
+
+#include <algorithm>    // std::min, std::max
+#include <atomic>   // std::atomic
+#include <condition_variable>   // std::condition_variable
+#include <cstddef>  // std::size_t
+#include <deque>
+#include <exception>    // std::exception_ptr
+#include <mutex>    // std::mutex
+#include <thread>   // std::thread
+#include <utility>  // std::move
+#include <vector>
+
+/// @brief Gets the number of hardware threads (at least 1)
+/// @return the number of hardware threads
+inline unsigned int DefaultNumJobs()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// @brief Runs task(i) for every i in [0, count) on up to numJobs threads
+/// @param count the number of tasks
+/// @param numJobs the maximum number of threads (including the calling thread)
+/// @param task the callable that takes the index of the task
+/// @note the first exception thrown by a task is rethrown once all threads have joined
+template<typename Func>
+void ParallelFor(const unsigned int count, unsigned int numJobs, Func task)
+{
+    numJobs = std::max(1u, std::min(numJobs, count));
+
+    // runs on the calling thread if there is nothing to share
+    if (numJobs == 1)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    // each worker keeps grabbing the next index until all tasks are taken
+    std::atomic<unsigned int> next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex errorMutex;
+    auto worker = [&]()
+    {
+        for (unsigned int i = next++; i < count; i = next++)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                // keeps the first error and stops handing out new tasks
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numJobs - 1);
+    for (unsigned int job = 1; job < numJobs; ++job)
+    {
+        threads.emplace_back(worker);
+    }
+
+    // the calling thread works as well
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+/// @brief A reusable barrier for a fixed team of threads, e.g. the tasks of a ParallelFor with one task per thread
+///
+/// The threads spin (and yield) while they wait, so it suits phases of a few microseconds each.
+class SpinBarrier
+{
+public:
+    /// @brief Contructor
+    /// @param numThreads the number of threads of the team (at least 1)
+    explicit SpinBarrier(const unsigned int numThreads) : numThreads(std::max(1u, numThreads)) {}
+
+    /// @brief Waits until every thread of the team has arrived
+    void ArriveAndWait()
+    {
+        const unsigned int phase = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == numThreads)
+        {
+            // the last thread resets the count before it releases the others
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        while (generation.load(std::memory_order_acquire) == phase)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    const unsigned int numThreads;
+    std::atomic<unsigned int> arrived{0};
+    std::atomic<unsigned int> generation{0};
+};
+
+/// @brief A first-in-first-out queue of a fixed capacity shared by producer and consumer threads
+/// @tparam T the type of the items
+template<typename T>
+class BoundedQueue
+{
+public:
+    /// @brief Contructor
+    /// @param capacity the maximum number of queued items (at least 1)
+    explicit BoundedQueue(const std::size_t capacity) : capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    /// @brief Adds an item, waiting while the queue is full
+    /// @param item the item
+    /// @return false if the queue has been closed (the item is dropped)
+    bool Push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+        if (closed)
+            return false;
+
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /// @brief Takes the oldest item, waiting while the queue is empty
+    /// @param item the item taken
+    /// @return false if the queue has been closed and drained
+    bool Pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        if (items.empty())
+            return false;
+
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /// @brief Stops accepting items; the queued items can still be taken
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    std::size_t capacity;
+    bool closed = false;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+};
+
+#endif  // INCLUDE_HELPER_THREADLIB_H_
@@ -1,16 +1,119 @@
 #ifndef INCLUDE_MATH_MATHLIB_H_
 #define INCLUDE_MATH_MATHLIB_H_
 
+#include <array>
+#include <cstddef>  // std::size_t
+#include <cstdint>
+
 /// @brief Generates a double from the normal distribution
 /// @param mean the mean of the distribution (μ)
 /// @param sd the standard deviation (σ)
 /// @return a random double
+/// @note each thread has its own unseeded generator; use RandomEngine for reproducible results
 double boost_normal_distribution(double mean = 0.0, double sd = 1.0);
 
 /// @brief Generates an integer between min and max
 /// @param max the max value (inclusive)
 /// @param min the min value (inclusive)
 /// @return a random integer
+/// @note each thread has its own unseeded generator; use RandomEngine for reproducible results
 int boost_uniform_int_distribution(int max = 10, int min = 1);
 
+/// @brief The Philox4x32-10 block function (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+/// @param counter the 128-bit counter
+/// @param key the 64-bit key
+/// @return 128 random bits
+std::array<std::uint32_t, 4> Philox4x32(std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key);
+
+/// @brief Runs the Philox4x32-10 block function on consecutive counters (SIMD across blocks)
+/// @param counter the counter of the first block (the first two words are incremented as a 64-bit integer)
+/// @param key the 64-bit key
+/// @param numBlocks the number of blocks
+/// @param out the output, 4 * numBlocks words in counter order
+void Philox4x32Batch(const std::array<std::uint32_t, 4>& counter, const std::array<std::uint32_t, 2>& key, const std::size_t numBlocks, std::uint32_t* out);
+
+/// @brief The layers of the Ziggurat used to sample the normal distribution
+struct ZigguratTables;
+
+/// @brief A counter-based random number generator keyed by (seed, index, stream)
+///
+/// The n-th draw of an engine only depends on its key and n, so every image (index) and purpose (stream)
+/// can be sampled on any thread, in any order, without shared state.
+class RandomEngine
+{
+public:
+    using result_type = std::uint32_t;
+
+    /// @brief Contructor
+    /// @param seed the global seed
+    /// @param index the index of the image
+    /// @param stream the stream within the image
+    explicit RandomEngine(std::uint64_t seed = 0, std::uint32_t index = 0, std::uint32_t stream = 0);
+
+    /// @brief Generates 32 random bits (satisfies UniformRandomBitGenerator)
+    /// @return a random integer
+    result_type operator()();
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    /// @brief Generates a double from the uniform distribution in [0, 1)
+    /// @return a random double
+    double Uniform();
+
+    /// @brief Generates a double from the normal distribution
+    /// @param mean the mean of the distribution (μ)
+    /// @param sd the standard deviation (σ)
+    /// @return a random double
+    double Normal(double mean = 0.0, double sd = 1.0);
+
+    /// @brief Generates an integer between min and max
+    /// @param max the max value (inclusive)
+    /// @param min the min value (inclusive)
+    /// @return a random integer
+    int UniformInt(int max = 10, int min = 1);
+
+    /// @brief Fills the output with doubles from the uniform distribution in [0, 1)
+    /// @param out the output
+    /// @param n the number of values
+    /// @note the values are the same as n calls to Uniform()
+    void FillUniform(double* out, const std::size_t n);
+
+    /// @brief Fills the output with doubles from the normal distribution
+    /// @param out the output
+    /// @param n the number of values
+    /// @param mean the mean of the distribution (μ)
+    /// @param sd the standard deviation (σ)
+    /// @note the values are the same as n calls to Normal(mean, sd); the samples that fall inside the rectangles of the
+    /// Ziggurat are tried 4 at a time (AVX2 with SNOWFLAKES_NATIVE_ARCH), and only the rejected ones take the scalar path
+    void FillNormal(double* out, const std::size_t n, double mean = 0.0, double sd = 1.0);
+
+    /// @brief Fills the output with integers between min and max
+    /// @param out the output
+    /// @param n the number of values
+    /// @param max the max value (inclusive)
+    /// @param min the min value (inclusive)
+    /// @note the values are the same as n calls to UniformInt(max, min); the integers are tried 8 at a time (AVX2 with
+    /// SNOWFLAKES_NATIVE_ARCH), and only the rejected ones take the scalar path
+    void FillUniformInt(int* out, const std::size_t n, int max = 10, int min = 1);
+
+private:
+    /// @brief The number of Philox blocks generated at a time
+    static constexpr std::size_t BATCH_BLOCKS = 16;
+    static constexpr std::size_t BATCH_WORDS = 4 * BATCH_BLOCKS;
+
+    /// @brief Generates the next batch of blocks
+    void Refill();
+
+    /// @brief Generates a double from the standard normal distribution (Ziggurat)
+    /// @param zig the layers of the Ziggurat
+    /// @return a random double
+    double StandardNormal(const ZigguratTables& zig);
+
+    std::array<std::uint32_t, 2> key;
+    std::array<std::uint32_t, 4> counter;
+    std::array<std::uint32_t, BATCH_WORDS> buffer;
+    std::size_t pos;
+};
+
 #endif  // INCLUDE_MATH_MATHLIB_H_
@@ -0,0 +1,255 @@
+#include "helper/cachelib.hpp"
+
+#include <cstdio>   // std::snprintf
+#include <filesystem>
+#include <fstream>
+#include <iterator>     // std::istreambuf_iterator
+#include <sstream>  // std::ostringstream
+#include <string>
+#include <system_error>     // std::error_code
+#include <vector>
+
+#include "helper/filelib.hpp"
+#include "helper/jsonlib.hpp"
+
+// FNV-1a
+#define FNV_OFFSET_BASIS 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+namespace fs = std::filesystem;
+
+/// @brief Puts a file at a path as a hard link, or as a copy if the file system cannot link it
+static bool LinkOrCopy(const std::string& from, const std::string& to)
+{
+    std::error_code ec;
+    fs::create_hard_link(from, to, ec);
+    if (ec)
+    {
+        ec.clear();
+        fs::copy_file(from, to, fs::copy_options::overwrite_existing, ec);
+    }
+
+    return !ec;
+}
+
+std::string HashKey(const std::string& key)
+{
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    for (const char c : key)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+    }
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return hex;
+}
+
+bool RenderCache::Open(const std::string& directory, const std::uint64_t capacity, std::string& error)
+{
+    std::error_code ec;
+    fs::create_directories(fs::path(directory) / CACHE_OBJECTS_NAME, ec);
+    if (ec)
+    {
+        error = "cannot create " + directory + ": " + ec.message();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    this->directory = directory;
+    this->capacity = capacity;
+    size = 0;
+    entries.clear();
+    lookup.clear();
+
+    // keeps the entries of the index whose files are still there
+    // NOTE: a broken line (e.g. from a full disk) only drops the entries from there on
+    std::ifstream index((fs::path(directory) / CACHE_INDEX_NAME).string());
+    std::string line, lineError;
+    JsonValue value;
+    while (std::getline(index, line) && ParseJson(line, value, lineError))
+    {
+        const JsonValue* hash = value.Find("hash");
+        const JsonValue* key = value.Find("key");
+        const JsonValue* metadata = value.Find("metadata");
+        if (!hash || !key || !metadata || lookup.count(hash->text) != 0)
+            continue;
+
+        const std::uint64_t fileSize = fs::file_size(ObjectPath(hash->text), ec);
+        if (ec)
+            continue;
+
+        entries.push_back({hash->text, key->text, fileSize, metadata->text});
+        lookup[hash->text] = std::prev(entries.end());
+        size += fileSize;
+    }
+
+    // removes the files that are not in the index (e.g. stored by a run that did not close the cache)
+    for (const auto& file : fs::directory_iterator(fs::path(directory) / CACHE_OBJECTS_NAME, ec))
+    {
+        if (lookup.count(file.path().filename().string()) == 0)
+            fs::remove(file.path(), ec);
+    }
+
+    Evict();
+    return true;
+}
+
+bool RenderCache::Fetch(const std::string& key, const std::string& filename, std::string& metadata)
+{
+    // NOTE: the file may have been evicted in the meantime, which makes it a miss
+    const std::string path = Touch(key, metadata);
+    bool isHit = !path.empty();
+    if (isHit)
+    {
+        std::error_code ec;
+        fs::remove(filename, ec);
+        isHit = LinkOrCopy(path, filename);
+    }
+
+    ++(isHit ? hits : misses);
+    return isHit;
+}
+
+bool RenderCache::Fetch(const std::string& key, std::vector<unsigned char>& bytes, std::string& metadata)
+{
+    const std::string path = Touch(key, metadata);
+    std::ifstream file;
+    if (!path.empty())
+    {
+        file.open(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    const bool isHit = !path.empty() && file.is_open() && !file.bad();
+    ++(isHit ? hits : misses);
+    return isHit;
+}
+
+bool RenderCache::Store(const std::string& key, const std::string& filename, const std::string& metadata, std::string& error)
+{
+    std::error_code ec;
+    const std::uint64_t fileSize = fs::file_size(filename, ec);
+    const std::string temporary = TemporaryPath();
+    if (ec || !LinkOrCopy(filename, temporary))
+    {
+        error = "cannot cache " + filename;
+        return false;
+    }
+
+    return Insert(key, temporary, fileSize, metadata, error);
+}
+
+bool RenderCache::Store(const std::string& key, const std::vector<unsigned char>& bytes, const std::string& metadata, std::string& error)
+{
+    const std::string temporary = TemporaryPath();
+    if (!WriteFile(temporary, bytes, error))
+        return false;
+
+    return Insert(key, temporary, bytes.size(), metadata, error);
+}
+
+bool RenderCache::Close(std::string& error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (directory.empty())
+        return true;
+
+    // lists the most recently used first, which keeps the order for the next run
+    std::ostringstream text;
+    for (const Entry& entry : entries)
+    {
+        JsonWriter json(text);
+        json.BeginObject().Key("hash").Value(entry.hash).Key("key").Value(entry.key).Key("metadata").Value(entry.metadata).EndObject();
+        text << '\n';
+    }
+
+    // replaces the index at once, so an interrupted run keeps the old one
+    const std::string bytes = text.str();
+    const fs::path index = fs::path(directory) / CACHE_INDEX_NAME;
+    const std::string temporary = index.string() + ".tmp";
+    std::error_code ec;
+    if (!WriteFile(temporary, std::vector<unsigned char>(bytes.begin(), bytes.end()), error))
+        return false;
+    fs::rename(temporary, index, ec);
+    if (ec)
+    {
+        error = "cannot replace " + index.string() + ": " + ec.message();
+        return false;
+    }
+
+    directory.clear();
+    return true;
+}
+
+std::uint64_t RenderCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+std::string RenderCache::Touch(const std::string& key, std::string& metadata)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto itr = lookup.find(HashKey(key));
+    if (itr == lookup.end() || itr->second->key != key)
+        return "";
+
+    entries.splice(entries.begin(), entries, itr->second);
+    metadata = itr->second->metadata;
+    return ObjectPath(itr->second->hash);
+}
+
+bool RenderCache::Insert(const std::string& key, const std::string& temporary, const std::uint64_t fileSize, const std::string& metadata, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::string hash = HashKey(key);
+
+    // replaces the file of the same hash (e.g. a colliding key)
+    std::error_code ec;
+    fs::rename(temporary, ObjectPath(hash), ec);
+    if (ec)
+    {
+        fs::remove(temporary, ec);
+        error = "cannot cache " + key;
+        return false;
+    }
+
+    const auto itr = lookup.find(hash);
+    if (itr != lookup.end())
+    {
+        size -= itr->second->size;
+        entries.erase(itr->second);
+    }
+
+    entries.push_front({hash, key, fileSize, metadata});
+    lookup[hash] = entries.begin();
+    size += fileSize;
+
+    Evict();
+    return true;
+}
+
+void RenderCache::Evict()
+{
+    std::error_code ec;
+    while (size > capacity && !entries.empty())
+    {
+        const Entry& entry = entries.back();
+        fs::remove(ObjectPath(entry.hash), ec);
+        size -= entry.size;
+        lookup.erase(entry.hash);
+        entries.pop_back();
+    }
+}
+
+std::string RenderCache::ObjectPath(const std::string& hash) const
+{
+    return (fs::path(directory) / CACHE_OBJECTS_NAME / hash).string();
+}
+
+std::string RenderCache::TemporaryPath()
+{
+    // NOTE: not a hash, so Open removes it if the run stops before it is inserted
+    return ObjectPath("tmp-" + std::to_string(numTemporaries++));
+}
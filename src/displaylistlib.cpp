@@ -0,0 +1,226 @@
+#include "graph/displaylistlib.hpp"
+
+#include <algorithm>    // std::min, std::max
+#include <cmath>    // std::lround, std::sqrt, std::abs
+#include <vector>
+
+#include "graph/rasterlib.hpp"
+#include "graph/stamplib.hpp"
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/symmetrylib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+
+DisplayList::DisplayList(const int rows, const int cols) : rows(rows), cols(cols)
+{
+}
+
+void DisplayList::FillCircle(const Vector& center, const int radius, const Colour& colour)
+{
+    commands.push_back(DrawCommand{DrawOp::Circle, colour, static_cast<std::uint32_t>(points.size()), 1, radius});
+    points.push_back(center);
+}
+
+void DisplayList::DrawLine(const Vector& start, const Vector& end, const int width, const Colour& colour)
+{
+    commands.push_back(DrawCommand{DrawOp::Line, colour, static_cast<std::uint32_t>(points.size()), 2, width});
+    points.push_back(start);
+    points.push_back(end);
+}
+
+void DisplayList::FillConvexPolygon(const std::vector<Vector>& vertices, const Colour& colour)
+{
+    commands.push_back(DrawCommand{DrawOp::Polygon, colour, static_cast<std::uint32_t>(points.size()), static_cast<std::uint32_t>(vertices.size()), 0});
+    points.insert(points.end(), vertices.begin(), vertices.end());
+}
+
+void DisplayList::ReplicateWedge(const Symmetry& symmetry)
+{
+    commands.push_back(DrawCommand{DrawOp::Replicate, Colour(), static_cast<std::uint32_t>(symmetries.size()), 1, 0});
+    symmetries.push_back(symmetry);
+}
+
+void DisplayList::DrawStamp(const std::shared_ptr<const Stamp>& stamp, const Mat2& transform, const Vector& offset, const Colour& colour)
+{
+    commands.push_back(DrawCommand{DrawOp::Stamp, colour, static_cast<std::uint32_t>(points.size()), 3, static_cast<std::int32_t>(stamps.size())});
+    points.push_back(offset);
+    points.emplace_back(transform.a, transform.b);
+    points.emplace_back(transform.c, transform.d);
+    stamps.push_back(stamp);
+}
+
+Mat2 DisplayList::TransformOf(const DrawCommand& command) const
+{
+    const Vector* p = PointsOf(command);
+    return Mat2{p[1].x, p[1].y, p[2].x, p[2].y};
+}
+
+void DisplayList::Clear()
+{
+    commands.clear();
+    points.clear();
+    symmetries.clear();
+    stamps.clear();
+}
+
+void DisplayList::Execute(Rasterizer& target) const
+{
+    std::vector<Vector> polygon;
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < commands.size(); ++i)
+    {
+        const DrawCommand& command = commands[i];
+        const Vector* p = PointsOf(command);
+        switch (command.op)
+        {
+        case DrawOp::Circle:
+            target.FillCircle(p[0], command.size, command.colour);
+            break;
+        case DrawOp::Line:
+            target.DrawLine(p[0], p[1], command.size, command.colour);
+            break;
+        case DrawOp::Polygon:
+            polygon.assign(p, p + command.count);
+            target.FillConvexPolygon(polygon, command.colour);
+            break;
+        case DrawOp::Replicate:
+        {
+            // the wedge itself has been drawn already
+            const Symmetry& symmetry = symmetries[command.first];
+            for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+            {
+                const Mat2 m = Mat2::ArmRotation(rotation);
+                if (rotation > 0)
+                    ExecuteRange(target, begin, i, m, 1.0, Vector(0, 0));
+                if (symmetry.dihedral)
+                    ExecuteRange(target, begin, i, m * Mat2::Reflection(symmetry.axis), 1.0, Vector(0, 0));
+            }
+
+            begin = i + 1;
+            break;
+        }
+        case DrawOp::Stamp:
+            target.DrawStamp(stamps[command.size], TransformOf(command), p[0], command.colour);
+            break;
+        }
+    }
+}
+
+/// @brief Scales a radius or a width to whole pixels (a positive width stays at least 1 pixel)
+static int ScaleSize(const int size, const double scale)
+{
+    const int scaled = static_cast<int>(std::lround(size * scale));
+    return (size > 0) ? std::max(scaled, 1) : scaled;
+}
+
+/// @brief Checks if the box [lo, hi] (in pixels, inclusive) overlaps the canvas
+static bool Overlaps(const Rasterizer& target, const Vector& lo, const Vector& hi)
+{
+    return hi.x >= 0 && hi.y >= 0 && lo.x < target.Cols() && lo.y < target.Rows();
+}
+
+void DisplayList::ExecuteRange(Rasterizer& target, const std::size_t begin, const std::size_t end, const Mat2& m, const double scale, const Vector& origin, const Colour* colour) const
+{
+    const Vector center(cols / 2, rows / 2);
+    auto map = [&](const Vector& p) { return scale * (m * (p - center) + center) - origin; };
+    auto colourOf = [&](const DrawCommand& command) -> const Colour& { return colour ? *colour : command.colour; };
+
+    std::vector<Vector> polygon;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const DrawCommand& command = commands[i];
+        const Vector* p = PointsOf(command);
+        switch (command.op)
+        {
+        case DrawOp::Circle:
+        {
+            const Vector c = map(p[0]);
+            const int radius = ScaleSize(command.size, scale);
+            const Vector extent(radius + 1, radius + 1);
+            if (Overlaps(target, c - extent, c + extent))
+                target.FillCircle(c, radius, colourOf(command));
+            break;
+        }
+        case DrawOp::Line:
+        {
+            const Vector a = map(p[0]), b = map(p[1]);
+            const int width = ScaleSize(command.size, scale);
+            const double margin = (width > 0) ? LineHalfWidth(width) + 1 : 0;
+            const Vector extent(margin, margin);
+            if (Overlaps(target, Vector(std::min(a.x, b.x), std::min(a.y, b.y)) - extent, Vector(std::max(a.x, b.x), std::max(a.y, b.y)) + extent))
+                target.DrawLine(a, b, width, colourOf(command));
+            break;
+        }
+        case DrawOp::Polygon:
+        {
+            polygon.resize(command.count);
+            Vector lo, hi;
+            for (std::uint32_t k = 0; k < command.count; ++k)
+            {
+                polygon[k] = map(p[k]);
+                lo = (k == 0) ? polygon[k] : Vector(std::min(lo.x, polygon[k].x), std::min(lo.y, polygon[k].y));
+                hi = (k == 0) ? polygon[k] : Vector(std::max(hi.x, polygon[k].x), std::max(hi.y, polygon[k].y));
+            }
+            if (command.count && Overlaps(target, lo - Vector(1, 1), hi + Vector(1, 1)))
+                target.FillConvexPolygon(polygon, colourOf(command));
+            break;
+        }
+        case DrawOp::Replicate:
+            break;
+        case DrawOp::Stamp:
+        {
+            // the stamp is transformed by m (around the center) and scaled on top of its own transform
+            const Stamp& stamp = *stamps[command.size];
+            const Mat2 t = TransformOf(command);
+            const Mat2 transform = Mat2{scale, 0, 0, scale} * m * t;
+            const Vector offset = map(p[0]);
+            Vector lo, hi;
+            const Vector corners[] = {stamp.Lower(), Vector(stamp.Upper().x, stamp.Lower().y), stamp.Upper(), Vector(stamp.Lower().x, stamp.Upper().y)};
+            for (int k = 0; k < 4; ++k)
+            {
+                const Vector corner = transform * corners[k] + offset;
+                lo = (k == 0) ? corner : Vector(std::min(lo.x, corner.x), std::min(lo.y, corner.y));
+                hi = (k == 0) ? corner : Vector(std::max(hi.x, corner.x), std::max(hi.y, corner.y));
+            }
+            if (Overlaps(target, lo - Vector(1, 1), hi + Vector(1, 1)))
+                target.DrawStamp(stamps[command.size], transform, offset, colourOf(command));
+            break;
+        }
+        }
+    }
+}
+
+void DisplayList::Execute(Rasterizer& target, const double scale, const Vector& origin) const
+{
+    // every run of commands that ends with a Replicate command is drawn once per element of the symmetry group
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < commands.size(); ++i)
+    {
+        if (commands[i].op != DrawOp::Replicate)
+            continue;
+
+        const Symmetry& symmetry = symmetries[commands[i].first];
+        for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+        {
+            const Mat2 m = Mat2::ArmRotation(rotation);
+            ExecuteRange(target, begin, i, m, scale, origin);
+            if (symmetry.dihedral)
+                ExecuteRange(target, begin, i, m * Mat2::Reflection(symmetry.axis), scale, origin);
+        }
+
+        begin = i + 1;
+    }
+
+    ExecuteRange(target, begin, commands.size(), Mat2::ArmRotation(0), scale, origin);
+}
+
+void DisplayList::Execute(Rasterizer& target, const Mat2& transform, const Vector& offset, const Colour& colour) const
+{
+    const double scale = std::sqrt(std::abs(transform.a * transform.d - transform.b * transform.c));
+    if (scale == 0.0)
+        return;
+
+    // splits the transform into the rotation (or mirror) m around the center and the scale
+    const Vector center(cols / 2, rows / 2);
+    const Mat2 m{transform.a / scale, transform.b / scale, transform.c / scale, transform.d / scale};
+    ExecuteRange(target, 0, commands.size(), m, scale, scale * (center - m * center) - offset, &colour);
+}
@@ -0,0 +1,140 @@
+#include "coordinate/dlalib.hpp"
+
+#include <algorithm>    // std::min, std::max
+#include <cmath>    // std::cos, std::sin
+#include <cstdint>  // std::uint32_t, std::uint64_t
+
+#include "coordinate/gridlib.hpp"
+#include "coordinate/vectorlib.hpp"
+#include "helper/profilelib.hpp"
+#include "helper/threadlib.hpp"
+#include "math/mathlib.hpp"
+
+#define TWO_PI 6.28318530717958647693
+
+// a walker sticks once the gap between it and a particle is less than this (in radii)
+#define DLA_STICKING_GAP 0.5
+
+// the walkers are released this far outside the cluster (in diameters)
+#define DLA_LAUNCH_MARGIN 4.0
+
+// a walker this many times the launch radius away from the origin is released again
+#define DLA_KILL_FACTOR 3.0
+
+// the near and the far search around a walker (in diameters)
+#define DLA_NEAR_SEARCH 2.0
+#define DLA_FAR_SEARCH 8.0
+
+// a round releases one walker per this many particles of the cluster, and at most DLA_MAX_ROUND walkers
+#define DLA_ROUND_DIVISOR 128
+#define DLA_MAX_ROUND 64
+
+// a walker gives up after this many steps
+#define DLA_MAX_STEPS 1000000
+
+/// @brief Get a random unit vector
+static Vector RandomDirection(RandomEngine& rng)
+{
+    const double angle = TWO_PI * rng.Uniform();
+    return Vector(std::cos(angle), std::sin(angle));
+}
+
+/// @brief Walks a particle from the launch circle until it is about to touch the cluster
+/// @param grid the particles of the cluster (and their images)
+/// @param clusterRadius the largest distance between a particle and the origin
+/// @param radius the radius of the particles
+/// @param rng the random number generator of the walker
+/// @param position the position the walker stuck at
+/// @return false if the walker has given up
+static bool Walk(const SpatialGrid& grid, const double clusterRadius, const double radius, RandomEngine& rng, Vector& position)
+{
+    const double diameter = 2.0 * radius;
+    const double sticking = diameter + DLA_STICKING_GAP * radius;
+    const double nearSearch = DLA_NEAR_SEARCH * diameter, farSearch = DLA_FAR_SEARCH * diameter;
+    const double launch = clusterRadius + DLA_LAUNCH_MARGIN * diameter;
+    const double kill = DLA_KILL_FACTOR * launch;
+
+    // NOTE: every step jumps to a random point of the largest circle around the walker that is clear of the cluster,
+    // which is where a walk inside the circle leaves it, so the walker only takes small steps right next to the cluster
+    position = launch * RandomDirection(rng);
+    for (int step = 0; step < DLA_MAX_STEPS; ++step)
+    {
+        const double distance = position.Magnitude();
+        if (distance > kill)
+        {
+            position = launch * RandomDirection(rng);
+            continue;
+        }
+
+        // far from the cluster: the bounding disc of the cluster is enough
+        const double gap = distance - clusterRadius - diameter;
+        if (gap > nearSearch)
+        {
+            position += gap * RandomDirection(rng);
+            continue;
+        }
+
+        // close to the cluster: asks the grid for the nearest particle, first nearby and then a bit further
+        double nearest = grid.NearestDistance(position, nearSearch);
+        if (nearest >= nearSearch)
+            nearest = grid.NearestDistance(position, farSearch);
+
+        if (nearest < sticking)
+            return true;
+
+        position += (nearest - diameter) * RandomDirection(rng);
+    }
+
+    return false;
+}
+
+std::vector<Vector> GenerateDlaCluster(const unsigned int numParticles, const double radius, const double maxRadius, const Vector& mirror, RandomEngine& rng, const unsigned int numJobs)
+{
+    PROFILE_SCOPE("generate dla cluster");
+    const double diameter = 2.0 * radius;
+
+    // the grid holds every particle with its images, so the walkers see the whole snowflake
+    SpatialGrid grid(maxRadius + DLA_LAUNCH_MARGIN * diameter, DLA_NEAR_SEARCH * diameter);
+    std::vector<Vector> particles = {Vector(0, 0)};
+    grid.Insert(particles.front());
+    double clusterRadius = 0.0;
+
+    // every walker has its own random stream keyed by its number
+    const std::uint64_t walkerSeed = (static_cast<std::uint64_t>(rng()) << 32) | rng();
+    std::uint32_t numWalkers = 0;
+
+    // the walkers of a round only read the grid, so they walk in parallel; their particles are added in order after the round
+    std::vector<Vector> positions;
+    std::vector<char> hasStuck;
+    while (particles.size() < numParticles && clusterRadius < maxRadius)
+    {
+        const std::size_t roundSize = std::min<std::size_t>(std::max<std::size_t>(particles.size() / DLA_ROUND_DIVISOR, 1), std::min<std::size_t>(DLA_MAX_ROUND, numParticles - particles.size()));
+        positions.resize(roundSize);
+        hasStuck.assign(roundSize, 0);
+        ParallelFor(static_cast<unsigned int>(roundSize), numJobs, [&](unsigned int i)
+        {
+            RandomEngine walker(walkerSeed, numWalkers + i);
+            hasStuck[i] = Walk(grid, clusterRadius, radius, walker, positions[i]);
+        });
+        numWalkers += static_cast<std::uint32_t>(roundSize);
+
+        for (std::size_t i = 0; i < roundSize; ++i)
+        {
+            // drops the walkers that have landed on a particle of the same round
+            const Vector& p = positions[i];
+            if (!hasStuck[i] || grid.NearestDistance(p, diameter) < diameter)
+                continue;
+
+            particles.push_back(p);
+            const Vector mirrored = Vector::Mirror(p, mirror);
+            for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+            {
+                grid.Insert(Vector::RotateArm(p, rotation));
+                grid.Insert(Vector::RotateArm(mirrored, rotation));
+            }
+            clusterRadius = std::max(clusterRadius, p.Magnitude());
+        }
+    }
+
+    return particles;
+}
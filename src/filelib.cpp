@@ -0,0 +1,39 @@
+#include "helper/filelib.hpp"
+
+#include <cerrno>   // errno
+#include <cstring>  // std::strerror
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>    // std::error_code
+#include <vector>
+
+bool OpenNewFile(std::ofstream& file, const std::string& filename, std::ios::openmode mode)
+{
+    // NOTE: a new file replaces the old one instead of overwriting it, so a hard link to the old one (e.g. into the render cache) keeps its content
+    std::error_code ec;
+    std::filesystem::remove(filename, ec);
+
+    file.open(filename, mode | std::ios::out | std::ios::trunc);
+    return static_cast<bool>(file);
+}
+
+bool WriteFile(const std::string& filename, const std::vector<unsigned char>& bytes, std::string& error)
+{
+    std::ofstream file;
+    if (!OpenNewFile(file, filename, std::ios::binary))
+    {
+        error = "cannot open " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if (!file)
+    {
+        error = "cannot write " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    return true;
+}
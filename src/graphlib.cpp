@@ -2,33 +2,123 @@
 #include <algorithm>
 #include <vector>
 #include <array>
+#include <cmath>    // std::sqrt, std::pow, std::lround
+#include <memory>   // std::unique_ptr
 
 #include "opencv2/imgcodecs.hpp"
 #include "opencv2/highgui.hpp"
 #include "opencv2/imgproc.hpp"
 
 #include "graph/graphlib.hpp"
+#include "graph/rasterlib.hpp"
+#include "graph/displaylistlib.hpp"
+#include "graph/stamplib.hpp"
 #include "coordinate/vectorlib.hpp"
 #include "coordinate/generatorlib.hpp"
+#include "coordinate/symmetrylib.hpp"
+#include "coordinate/gridlib.hpp"
 #include "math/mathlib.hpp"
+#include "helper/profilelib.hpp"
 
 // OpenCV
 #define FILLED -1
-#define ROWS 1024
-#define COLS 1024
-#define CENTER (ROWS/2)
-
-// snowflake properties
-#define NUM_ARMS 6
 
 // colours
-#define WHITE CV_RGB(255, 255, 255)
+#define WHITE Colour(255, 255, 255)
 #define LIGHT_SKY_BLUE CV_RGB(153, 204, 255)
 #define SALMON CV_RGB(250, 128, 114)
 
-// algebra
-#define PI 3.14159265
-#define DEG_TO_RAD(deg) ((deg) * PI / 180.0 )
+// the extra distance (in pixels) within which primitives near the wedge are still drawn
+#define WEDGE_MARGIN 2
+
+// two circles of a collision-free Crystal arm may overlap by this much, i.e. they touch
+#define CRYSTAL_TOUCH_TOLERANCE 1e-6
+
+// the number of directions a collision-free Crystal arm tries for a circle before it stops growing
+#define CRYSTAL_MAX_ATTEMPTS 32
+
+// the circles of a collision-free Crystal arm closer than this to the center (in largest radii) form the hub
+#define CRYSTAL_HUB_RADII 4.0
+
+#define HALF_PI 1.57079632679489661923
+
+CircleArray::CircleArray(const std::vector<Circle>& circles) : c(circles.size()), radius(circles.size()), r(circles.size()), g(circles.size()), b(circles.size())
+{
+    for (std::size_t i = 0; i < circles.size(); ++i)
+    {
+        c.x[i] = circles[i].c.x;
+        c.y[i] = circles[i].c.y;
+        radius[i] = circles[i].radius;
+        r[i] = circles[i].r;
+        g[i] = circles[i].g;
+        b[i] = circles[i].b;
+    }
+}
+
+OpenCVRasterizer::OpenCVRasterizer(cv::Mat& img) : img(img)
+{
+}
+
+int OpenCVRasterizer::Rows() const
+{
+    return img.rows;
+}
+
+int OpenCVRasterizer::Cols() const
+{
+    return img.cols;
+}
+
+RasterBuffer OpenCVRasterizer::Pixels()
+{
+    return ToRasterBuffer(img);
+}
+
+void OpenCVRasterizer::FillCircle(const Vector& center, const int radius, const Colour& colour)
+{
+    cv::circle(img, cv::Point(center.x, center.y), radius, CV_RGB(colour.r, colour.g, colour.b), FILLED);
+}
+
+void OpenCVRasterizer::DrawLine(const Vector& start, const Vector& end, const int width, const Colour& colour)
+{
+    cv::line(img, cv::Point(start.x, start.y), cv::Point(end.x, end.y), CV_RGB(colour.r, colour.g, colour.b), width);
+}
+
+void OpenCVRasterizer::FillConvexPolygon(const std::vector<Vector>& points, const Colour& colour)
+{
+    std::vector<std::vector<cv::Point>> pts(1);
+    for (const Vector& p : points)
+    {
+        pts[0].push_back(cv::Point(p.x, p.y));
+    }
+
+    // NOTE: cv::fillPoly rather than cv::fillConvexPoly to keep the original output
+    cv::fillPoly(img, pts, CV_RGB(colour.r, colour.g, colour.b));
+}
+
+RasterBuffer ToRasterBuffer(cv::Mat& img)
+{
+    RasterBuffer buffer;
+    if (img.depth() != CV_8U)
+        return buffer;
+
+    buffer.data = img.data;
+    buffer.rows = img.rows;
+    buffer.cols = img.cols;
+    buffer.channels = img.channels();
+    buffer.step = img.step;
+    return buffer;
+}
+
+std::unique_ptr<Rasterizer> MakeRasterizer(cv::Mat& img, const std::string& backend)
+{
+    if (backend == "opencv")
+        return std::make_unique<OpenCVRasterizer>(img);
+    else if (backend == "native" || backend == "native-aa")
+        return std::make_unique<SpanRasterizer>(ToRasterBuffer(img), backend == "native-aa");
+    else
+        return nullptr;
+}
 
 void DisplayImage(const std::string& windowName, cv::Mat& img)
 {
@@ -38,30 +128,60 @@ void DisplayImage(const std::string& windowName, cv::Mat& img)
     return;
 }
 
-void DrawCircles(cv::Mat& img, const std::vector<Circle>& circles)
+/// @brief The pixel at the center of the canvas, i.e. the center of the snowflake
+static Vector CenterOf(const Rasterizer& canvas)
+{
+    return Vector(canvas.Cols() / 2, canvas.Rows() / 2);
+}
+
+void DrawCircles(Rasterizer& canvas, const std::vector<Circle>& circles)
 {
+    const Vector center = CenterOf(canvas);
     auto itr = circles.cbegin();
     while (itr != circles.cend())
     {
-        cv::circle(img, cv::Point(itr->c.x + CENTER, itr->c.y + CENTER), itr->radius, CV_RGB(itr->r, itr->g, itr->b), FILLED);
+        canvas.FillCircle(itr->c + center, itr->radius, Colour(itr->r, itr->g, itr->b));
         ++itr;
     }
 }
 
-void DrawBackbone(cv::Mat& img, const Vector& v, const int length)
+void DrawCircles(Rasterizer& canvas, const CircleArray& circles, const VectorArray* centers, const Symmetry* wedge)
 {
-    const unsigned char THETA = 360 / NUM_ARMS;
+    const VectorArray& c = centers ? *centers : circles.c;
+    const Vector center = CenterOf(canvas);
+    for (std::size_t i = 0; i < circles.Size(); ++i)
+    {
+        if (wedge && !wedge->Touches(c[i], circles.radius[i] + WEDGE_MARGIN))
+            continue;
+
+        canvas.FillCircle(c[i] + center, circles.radius[i], Colour(circles.r[i], circles.g[i], circles.b[i]));
+    }
+}
+
+void DrawBackbone(Rasterizer& canvas, const Vector& v, const int length)
+{
+    const Vector center = CenterOf(canvas);
     for (int rotation = 0; rotation < NUM_ARMS; rotation++)
     {
-        Vector dir = length * Vector::Rotate(v, DEG_TO_RAD(THETA * rotation));
-        cv::line(img, cv::Point(CENTER, CENTER), cv::Point(dir.x + CENTER, dir.y + CENTER), WHITE, 5);
+        Vector dir = length * Vector::RotateArm(v, rotation);
+        canvas.DrawLine(center, dir + center, 5, WHITE);
     }
 }
 
-void DrawFern(cv::Mat& img, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate)
+/// @brief Draws a line unless it misses the wedge
+static void DrawSegment(Rasterizer& canvas, const Vector& start, const Vector& end, const int width, const Symmetry* wedge)
+{
+    if (wedge && !wedge->Touches(0.5 * (start + end), 0.5 * (end - start).Magnitude() + width + WEDGE_MARGIN))
+        return;
+
+    const Vector center = CenterOf(canvas);
+    canvas.DrawLine(start + center, end + center, width, WHITE);
+}
+
+void DrawFern(Rasterizer& canvas, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate, const Symmetry* wedge)
 {
     // draws the main arm
-    cv::line(img, cv::Point(CENTER, CENTER), cv::Point(armLength * v.x + CENTER, armLength * v.y + CENTER), WHITE, 5);
+    DrawSegment(canvas, Vector(0, 0), armLength * v, 5, wedge);
 
     // draw the branches
     const int N = armLength / nodeLength;
@@ -71,172 +191,443 @@ void DrawFern(cv::Mat& img, const Vector& v, const int armLength, const int armW
         // draw the branch
         Vector start = (i * nodeLength) * v;
         Vector end = alpha * branchLength * Vector::Rotate(v, theta) + start;
-        cv::line(img, cv::Point(start.x + CENTER, start.y + CENTER), cv::Point(end.x + CENTER, end.y + CENTER), WHITE, armWidth);
+        DrawSegment(canvas, start, end, armWidth, wedge);
 
         // draw the mirrored branch
         end = Vector::Mirror(end, v);
-        cv::line(img, cv::Point(start.x + CENTER, start.y + CENTER), cv::Point(end.x + CENTER, end.y + CENTER), WHITE, 5);
+        DrawSegment(canvas, start, end, 5, wedge);
 
         // apply the discount rate
         alpha *= rate;
     }
 }
 
-void DrawRadiatingDendriteSnowflake(cv::Mat& img, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate)
+/// @brief Get the display list that records one wedge of a symmetric snowflake (raster canvases draw every primitive)
+static DisplayList* WedgeListOf(Rasterizer& canvas, const bool symmetric)
 {
-    for (int rotation = 0; rotation < 6; ++rotation)
+    return symmetric ? dynamic_cast<DisplayList*>(&canvas) : nullptr;
+}
+
+void DrawRadiatingDendriteSnowflake(Rasterizer& canvas, const Vector& v, const int armLength, const int armWidth, const int nodeLength, const int branchLength, const double theta, const double rate, const bool symmetric)
+{
+    PROFILE_SCOPE("draw radiating dendrite");
+    if (DisplayList* list = WedgeListOf(canvas, symmetric))
     {
-        DrawFern(img, Vector::Rotate(v, DEG_TO_RAD(60 * rotation)), armLength, armWidth, nodeLength, branchLength, theta, rate);
+        // NOTE: only C6 since the branch and its mirror have different widths
+        const Symmetry wedge(v, false);
+        for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+        {
+            DrawFern(*list, Vector::RotateArm(v, rotation), armLength, armWidth, nodeLength, branchLength, theta, rate, &wedge);
+        }
+        list->ReplicateWedge(wedge);
+
+        return;
+    }
+
+    for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+    {
+        DrawFern(canvas, Vector::RotateArm(v, rotation), armLength, armWidth, nodeLength, branchLength, theta, rate);
     }
 }
 
-void DrawRotatedCircles(cv::Mat& img, const std::vector<Circle>& circles, const int theta, const int spin)
+/// @brief Get the value of a level, where the last value repeats
+static double ValueOfLevel(const std::vector<double>& values, const int level, const double fallback)
 {
-    auto itr = circles.cbegin();
-    while (itr != circles.cend())
+    return values.empty() ? fallback : values[std::min(static_cast<std::size_t>(level), values.size() - 1)];
+}
+
+void DrawRecursiveDendriteSnowflake(Rasterizer& canvas, const Vector& v, const int armLength, const int armWidth, const DendriteRule& rule)
+{
+    PROFILE_SCOPE("draw recursive dendrite");
+    const int depth = std::max(rule.depth, 0);
+    const int numNodes = std::max(rule.numNodes, 0);
+
+    // the length and the width of the segments of every level
+    std::vector<double> lengths(depth + 1, armLength);
+    std::vector<int> widths(depth + 1, armWidth);
+    for (int level = 1; level <= depth; ++level)
     {
-        auto focus = Vector::Rotate(itr->c, DEG_TO_RAD(theta * spin));
-        cv::circle(img, cv::Point(focus.x + CENTER, focus.y + CENTER), itr->radius, CV_RGB(itr->r, itr->g, itr->b), FILLED);
-        ++itr;
+        lengths[level] = lengths[level - 1] * ValueOfLevel(rule.decays, level - 1, 0.5);
+        widths[level] = std::max(1, static_cast<int>(std::lround(armWidth * std::pow(rule.widthDecay, level))));
+    }
+
+    // builds the levels from the tips: a segment along the x axis with a copy of the level below on either side of every node
+    DisplayList shape(0, 0);
+    std::shared_ptr<const Stamp> below;
+    for (int level = depth; level >= 0; --level)
+    {
+        shape.Clear();
+        shape.DrawLine(Vector(0, 0), Vector(lengths[level], 0), widths[level], WHITE);
+        if (below)
+        {
+            const double angle = ValueOfLevel(rule.angles, level, 0.0);
+            const Mat2 left = Mat2::Rotation(angle), right = Mat2::Rotation(-angle);
+            for (int node = 1; node <= numNodes; ++node)
+            {
+                const Vector start(lengths[level] * node / (numNodes + 1), 0);
+                shape.DrawStamp(below, left, start, WHITE);
+                shape.DrawStamp(below, right, start, WHITE);
+            }
+        }
+
+        below = std::make_shared<const Stamp>(shape);
+    }
+
+    // places the arm in the six directions
+    const Vector center = CenterOf(canvas);
+    for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+    {
+        const Vector dir = Vector::RotateArm(v.Unit(), rotation);
+        canvas.DrawStamp(below, Mat2{dir.x, -dir.y, dir.y, dir.x}, center, WHITE);
     }
 }
 
-void DrawCrystalSnowflake(cv::Mat& img, const int numCrystals, int radiusHigh, int radiusLow, const Vector& mirror)
+std::vector<Circle> GenerateCrystalArm(const int numCrystals, const int radiusHigh, const int radiusLow, RandomEngine& rng)
 {
-    std::vector<Circle> circles(numCrystals * 2 * NUM_ARMS);
+    PROFILE_SCOPE("generate crystal arm");
+    std::vector<Circle> circles(std::max(numCrystals, 1));
     circles[0].c = Vector(0, 0);
 
+    // samples the radii and the directions in bulk
+    const std::size_t numNew = circles.size() - 1;
+    std::vector<int> radii(numNew);
+    std::vector<double> slopes(numNew);
+    rng.FillUniformInt(radii.data(), numNew, radiusHigh, radiusLow);
+    rng.FillNormal(slopes.data(), numNew, 1, 0.3);
+
     // generates particles
     for (int i = 1; i < numCrystals; i++)
     {
         Vector start = circles[i - 1].c;
         int radiusStart = circles[i - 1].radius;
-        int radiusNew = boost_uniform_int_distribution(radiusHigh, radiusLow);
-        Vector cNew = GenerateNextCircle(start, radiusStart, Vector(1, boost_normal_distribution(1, 0.3)), radiusNew);
+        int radiusNew = radii[i - 1];
+        Vector cNew = GenerateNextCircle(start, radiusStart, Vector(1, slopes[i - 1]), radiusNew);
         circles[i].c = cNew;
         circles[i].radius = radiusNew;
     }
 
-    // draws all circles on the canvas
-    const unsigned char THETA = 360 / NUM_ARMS;
-    // draws the original circles
-    for (int rotation = 0; rotation < NUM_ARMS; rotation++)
+    return circles;
+}
+
+std::vector<Circle> GenerateCrystalArm(const int numCrystals, const int radiusHigh, const int radiusLow, const Vector& mirror, RandomEngine& rng)
+{
+    PROFILE_SCOPE("generate crystal arm");
+    std::vector<Circle> circles(1);
+    circles[0].c = Vector(0, 0);
+
+    // samples the radii and the first directions in bulk, like the arm that may overlap
+    const std::size_t numNew = std::max(numCrystals, 1) - 1;
+    std::vector<int> radii(numNew);
+    std::vector<double> slopes(numNew);
+    rng.FillUniformInt(radii.data(), numNew, radiusHigh, radiusLow);
+    rng.FillNormal(slopes.data(), numNew, 1, 0.3);
+
+    // the grid holds the 12 images of every circle (up to the corners of the canvas), and no query reaches further than a cell
+    const int largest = std::max({radiusHigh, radiusLow, 1});
+    const double reach = 0.5 * std::sqrt(2.0) * WORLD_SIZE;
+    SpatialGrid grid(reach + 2.0 * largest, 2.0 * largest);
+    std::vector<double> imageRadii;
+    std::vector<char> isHubImage;
+
+    // the circles at the center meet their own images, so the hub may overlap itself
+    const double hubRadius = CRYSTAL_HUB_RADII * largest;
+    auto isHub = [&](const Vector& c) { return c.Magnitude() < hubRadius; };
+    auto addImages = [&](const Circle& circle)
+    {
+        const Vector mirrored = Vector::Mirror(circle.c, mirror);
+        for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+        {
+            for (const Vector& image : {Vector::RotateArm(circle.c, rotation), Vector::RotateArm(mirrored, rotation)})
+            {
+                grid.Insert(image);
+                imageRadii.push_back(circle.radius);
+                isHubImage.push_back(isHub(circle.c));
+            }
+        }
+    };
+
+    // checks a circle against the images so far and against its own images
+    auto overlaps = [&](const Circle& circle, const std::size_t previous)
     {
-        DrawRotatedCircles(img, circles, THETA, rotation);
+        const bool hub = isHub(circle.c);
+        bool found = false;
+        grid.ForEachNear(circle.c, circle.radius + largest, [&](std::size_t i)
+        {
+            // NOTE: the circle touches the previous one, which is the first image of it
+            if (i == previous || (hub && isHubImage[i]))
+                return true;
+
+            found = (grid.Point(i) - circle.c).Magnitude() < circle.radius + imageRadii[i] - CRYSTAL_TOUCH_TOLERANCE;
+            return !found;
+        });
+        if (found || hub)
+            return found;
+
+        const Vector mirrored = Vector::Mirror(circle.c, mirror);
+        double closest = (mirrored - circle.c).Magnitude();
+        for (int rotation = 1; rotation < NUM_ARMS; ++rotation)
+        {
+            closest = std::min({closest, (Vector::RotateArm(circle.c, rotation) - circle.c).Magnitude(), (Vector::RotateArm(mirrored, rotation) - circle.c).Magnitude()});
+        }
+
+        return closest < 2.0 * circle.radius - CRYSTAL_TOUCH_TOLERANCE;
+    };
+
+    // grows the chain until a circle finds no free direction
+    addImages(circles[0]);
+    for (std::size_t i = 0; i < numNew; ++i)
+    {
+        const Circle& last = circles.back();
+        const std::size_t previous = grid.Size() - 2 * NUM_ARMS;
+        Circle circle{};
+        circle.radius = radii[i];
+
+        // tries the sampled direction first, so the arm only differs from the normal one after a collision, and then
+        // any direction away from the center
+        Vector dir(1, slopes[i]);
+        int attempt = 0;
+        for (; attempt < CRYSTAL_MAX_ATTEMPTS; ++attempt)
+        {
+            circle.c = GenerateNextCircle(last.c, last.radius, dir, circle.radius);
+            if (!overlaps(circle, previous))
+                break;
+
+            const double angle = HALF_PI * (2.0 * rng.Uniform() - 1.0);
+            dir = Vector(std::cos(angle), std::sin(angle));
+        }
+
+        // NOTE: the rest of the arm would be outside the canvas
+        if (attempt == CRYSTAL_MAX_ATTEMPTS || circle.c.Magnitude() - circle.radius > reach)
+            break;
+
+        circles.push_back(circle);
+        addImages(circle);
     }
 
-    // calculates the circles mirror w.r.t. the mirror vector
-    std::vector<Circle> tmp(circles.size());
-    std::transform(circles.begin(), circles.end(), tmp.begin(), [&](const Circle& circle)
+    return circles;
+}
+
+void DrawCrystalSnowflake(Rasterizer& canvas, const int numCrystals, int radiusHigh, int radiusLow, const Vector& mirror, RandomEngine& rng)
+{
+    DrawCrystalSnowflake(canvas, GenerateCrystalArm(numCrystals, radiusHigh, radiusLow, rng), mirror);
+}
+
+/// @brief Draws the circles of an arm in all 12 places of a Crystal snowflake: the arm and its mirror image in every
+/// arm direction
+static void DrawCrystalCopies(Rasterizer& canvas, const CircleArray& arm, const Vector& mirror, const Symmetry* wedge)
+{
+    CircleArray mirrored = arm;
+    mirrored.c.MirrorAll(mirror);
+
+    // draws the rotations of the original circles, then the ones of the mirrored circles
+    // NOTE: the rotation matrices come from the sixth roots of unity, so no trigonometry per arm
+    VectorArray centers;
+    const CircleArray* halves[] = {&arm, &mirrored};
+    for (const CircleArray* half : halves)
     {
-        Circle mirroredCircle = circle;
-        mirroredCircle.c = Vector::Mirror(circle.c, mirror);
-        return mirroredCircle;
-    });
+        for (int rotation = 0; rotation < NUM_ARMS; rotation++)
+        {
+            half->c.TransformTo(Mat2::ArmRotation(rotation), centers);
+            DrawCircles(canvas, *half, &centers, wedge);
+        }
+    }
+}
 
-    // draw the mirrored circles
-    for (int rotation = 0; rotation < NUM_ARMS; rotation++)
+void DrawCrystalSnowflake(Rasterizer& canvas, const std::vector<Circle>& circles, const Vector& mirror, const bool symmetric)
+{
+    PROFILE_SCOPE("draw crystal");
+    // only records the circles touching the fundamental wedge if symmetric
+    const Symmetry symmetry(mirror, true);
+    DisplayList* list = WedgeListOf(canvas, symmetric);
+    DrawCrystalCopies(canvas, CircleArray(circles), mirror, list ? &symmetry : nullptr);
+    if (list)
+        list->ReplicateWedge(symmetry);
+}
+
+void DrawCrystalGrowth(Rasterizer& canvas, const std::vector<Circle>& circles, const std::size_t begin, const std::size_t end, const Vector& mirror)
+{
+    PROFILE_SCOPE("draw crystal growth");
+    if (begin >= end)
+        return;
+
+    const std::vector<Circle> added(circles.begin() + begin, circles.begin() + std::min(end, circles.size()));
+    DrawCrystalCopies(canvas, CircleArray(added), mirror, nullptr);
+}
+
+void DrawDlaSnowflake(Rasterizer& canvas, const std::vector<Vector>& particles, const int radius, const Vector& mirror, const bool symmetric)
+{
+    // the particles are placed like the circles of a Crystal arm
+    std::vector<Circle> circles(particles.size());
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+        circles[i].c = particles[i];
+        circles[i].radius = radius;
+    }
+
+    DrawCrystalSnowflake(canvas, circles, mirror, symmetric);
+}
+
+void DrawReiterSnowflake(Rasterizer& canvas, const ReiterLattice& lattice, const double spacing)
+{
+    PROFILE_SCOPE("draw reiter snowflake");
+    const Vector center = CenterOf(canvas);
+    const double rowHeight = 0.5 * std::sqrt(3.0) * spacing;
+    const int extent = lattice.FrozenRadius();
+
+    // the cell (q, r) is centered at (q + r / 2, r * sqrt(3) / 2)
+    auto drawRun = [&](const int r, const int first, const int last)
+    {
+        const double left = (first + 0.5 * r - 0.5) * spacing, right = (last + 0.5 * r + 0.5) * spacing;
+        const double y = r * rowHeight;
+        const std::vector<Vector> points = {
+            Vector(left, y - 0.5 * spacing) + center, Vector(right, y - 0.5 * spacing) + center,
+            Vector(right, y + 0.5 * spacing) + center, Vector(left, y + 0.5 * spacing) + center};
+        canvas.FillConvexPolygon(points, WHITE);
+    };
+
+    for (int r = -extent; r <= extent; ++r)
     {
-        DrawRotatedCircles(img, tmp, THETA, rotation);
+        // the cells of the row closer than the extent to the center
+        const int last = std::min(extent, extent - r);
+        int first = std::max(-extent, -extent - r);
+        for (int q = first; q <= last + 1; ++q)
+        {
+            const bool isFrozen = q <= last && lattice.IsFrozen(q, r);
+            if (!isFrozen)
+            {
+                if (q > first)
+                    drawRun(r, first, q - 1);
+                first = q + 1;
+            }
+        }
     }
 }
 
-void DrawHexagon(cv::Mat& img, const Vector& v, const int side, const Vector& offset)
+void DrawHexagon(Rasterizer& canvas, const Vector& v, const int side, const Vector& offset)
 {
     // defines the points (vertices) of the hexagon
-    std::vector<cv::Point> points(6);
+    std::vector<Vector> points(6);
 
     // finds the first vertice
     Vector r = side * v;
 
     // figures out all the vertices
+    const Vector center = CenterOf(canvas);
     auto itr = points.begin();
     while (itr != points.end())
     {
-        *itr = cv::Point(r.x + offset.x + CENTER, r.y + offset.y + CENTER);
+        *itr = r + offset + center;
 
         // rotate the vector
-        r.Rotate(DEG_TO_RAD(60));
+        r = Vector::RotateArm(r, 1);
         ++itr;
     }
 
-    // puts the points into a vector of vectors
-    std::vector<std::vector<cv::Point>> pts(1);
-    pts[0] = points;
-
     // draws the polygon on the image
-    cv::fillPoly(img, pts, WHITE);
+    canvas.FillConvexPolygon(points, WHITE);
 }
 
-void DrawStellarPlateSnowflake(cv::Mat& img, const Vector& v, const int motherSide, const int sonSide)
+void DrawStellarPlateSnowflake(Rasterizer& canvas, const Vector& v, const int motherSide, const int sonSide, const bool symmetric)
 {
-    DrawHexagon(img, v, motherSide);
+    PROFILE_SCOPE("draw stellar plate");
+    // only records the son hexagons touching the fundamental wedge if symmetric
+    const Symmetry wedge(v, true);
+    DisplayList* list = WedgeListOf(canvas, symmetric);
+
+    DrawHexagon(canvas, v, motherSide);
 
     Vector offset = motherSide * v;
 
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < NUM_ARMS; i++)
     {
-        DrawHexagon(img, v, sonSide, offset);
-        offset.Rotate(DEG_TO_RAD(60));
+        if (!list || wedge.Touches(offset, sonSide + WEDGE_MARGIN))
+            DrawHexagon(canvas, v, sonSide, offset);
+        offset = Vector::RotateArm(offset, 1);
     }
+
+    if (list)
+        list->ReplicateWedge(wedge);
 }
 
-void DrawTriangularCrystalSnowflake(cv::Mat& img, const Vector& dir, const int motherTriangleR, const int sonTriangleR, const int radius)
+void DrawTriangularCrystalSnowflake(Rasterizer& canvas, const Vector& dir, const int motherTriangleR, const int sonTriangleR, const int radius)
 {
+    PROFILE_SCOPE("draw triangular crystal");
     // defines the points (vertices) of the main body
-    std::vector<cv::Point> points(6);
+    std::vector<Vector> points(6);
     Vector v = (motherTriangleR - sonTriangleR) * dir;
     Vector tmp;
+    const Vector center = CenterOf(canvas);
     
     // the first vertex
-    tmp = sonTriangleR * Vector::Rotate(v.Unit(), DEG_TO_RAD(-120)) + v;
-    points[0] = cv::Point(tmp.x + CENTER, tmp.y + CENTER);
-    cv::circle(img, cv::Point(tmp.x + CENTER, tmp.y + CENTER), radius, WHITE, FILLED);
-    tmp = sonTriangleR * Vector::Rotate(v.Unit(), DEG_TO_RAD(120)) + v;
-    points[1] = cv::Point(tmp.x + CENTER, tmp.y + CENTER);
-    cv::circle(img, cv::Point(tmp.x + CENTER, tmp.y + CENTER), radius, WHITE, FILLED);
+    tmp = sonTriangleR * Vector::RotateArm(v.Unit(), -2) + v;
+    points[0] = tmp + center;
+    canvas.FillCircle(points[0], radius, WHITE);
+    tmp = sonTriangleR * Vector::RotateArm(v.Unit(), 2) + v;
+    points[1] = tmp + center;
+    canvas.FillCircle(points[1], radius, WHITE);
 
     // the second vertex
-    v.Rotate(DEG_TO_RAD(120));
-    tmp = sonTriangleR * Vector::Rotate(v.Unit(), DEG_TO_RAD(-120)) + v;
-    points[2] = cv::Point(tmp.x + CENTER, tmp.y + CENTER);
-    cv::circle(img, cv::Point(tmp.x + CENTER, tmp.y + CENTER), radius, WHITE, FILLED);
-    tmp = sonTriangleR * Vector::Rotate(v.Unit(), DEG_TO_RAD(120)) + v;
-    points[3] = cv::Point(tmp.x + CENTER, tmp.y + CENTER);
-    cv::circle(img, cv::Point(tmp.x + CENTER, tmp.y + CENTER), radius, WHITE, FILLED);
+    v = Vector::RotateArm(v, 2);
+    tmp = sonTriangleR * Vector::RotateArm(v.Unit(), -2) + v;
+    points[2] = tmp + center;
+    canvas.FillCircle(points[2], radius, WHITE);
+    tmp = sonTriangleR * Vector::RotateArm(v.Unit(), 2) + v;
+    points[3] = tmp + center;
+    canvas.FillCircle(points[3], radius, WHITE);
 
     // the third vertex
-    v.Rotate(DEG_TO_RAD(120));
-    tmp = sonTriangleR * Vector::Rotate(v.Unit(), DEG_TO_RAD(-120)) + v;
-    points[4] = cv::Point(tmp.x + CENTER, tmp.y + CENTER);
-    cv::circle(img, cv::Point(tmp.x + CENTER, tmp.y + CENTER), radius, WHITE, FILLED);
-    tmp = sonTriangleR * Vector::Rotate(v.Unit(), DEG_TO_RAD(120)) + v;
-    points[5] = cv::Point(tmp.x + CENTER, tmp.y + CENTER);
-    cv::circle(img, cv::Point(tmp.x + CENTER, tmp.y + CENTER), radius, WHITE, FILLED);
-
-    // puts the points into a vector of vectors
-    std::vector<std::vector<cv::Point>> pts(1);
-    pts[0] = points;
+    v = Vector::RotateArm(v, 2);
+    tmp = sonTriangleR * Vector::RotateArm(v.Unit(), -2) + v;
+    points[4] = tmp + center;
+    canvas.FillCircle(points[4], radius, WHITE);
+    tmp = sonTriangleR * Vector::RotateArm(v.Unit(), 2) + v;
+    points[5] = tmp + center;
+    canvas.FillCircle(points[5], radius, WHITE);
 
     // draws the polygon on the image
-    cv::fillPoly(img, pts, WHITE);
+    // NOTE: the main body is always convex
+    canvas.FillConvexPolygon(points, WHITE);
 }
 
 bool SaveImage(const std::string& filename, cv::Mat& img)
 {
+    PROFILE_SCOPE("save image");
     // checks if the folder exists
     std::filesystem::path p(filename);
-    if (std::filesystem::exists(p.parent_path()))
+    if (!std::filesystem::exists(p.parent_path()))
+        return false;
+
+    try
     {
-        cv::imwrite(filename, img);
-        return true;
+        return cv::imwrite(filename, img);
     }
-    else
+    catch (const cv::Exception&)
+    {
         return false;
+    }
+}
+
+bool EncodeImage(const cv::Mat& img, const std::string& extension, std::vector<unsigned char>& bytes, std::string& error)
+{
+    PROFILE_SCOPE("encode image");
+    try
+    {
+        if (cv::imencode(extension, img, bytes))
+            return true;
+
+        error = "cannot encode the image as " + extension;
+    }
+    catch (const cv::Exception& e)
+    {
+        error = "cannot encode the image as " + extension + ": " + e.what();
+    }
+
+    return false;
 }
 
 void PutLabel(cv::Mat& img, const std::string& label)
 {
+    PROFILE_SCOPE("put label");
     int fontFace = cv::FONT_HERSHEY_PLAIN;
     double fontScale = 2;
     int thickness = 2;
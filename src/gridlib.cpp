@@ -0,0 +1,44 @@
+#include "coordinate/gridlib.hpp"
+
+#include <algorithm>    // std::fill, std::min, std::max
+#include <cmath>    // std::ceil, std::sqrt
+
+// the largest number of cells per row (keeps the heads of a very fine grid within 16 MB)
+#define MAX_GRID_CELLS 2048
+
+SpatialGrid::SpatialGrid(const double extent, const double cellSize) : extent(std::max(extent, cellSize))
+{
+    numCells = std::min(static_cast<int>(std::ceil(2.0 * this->extent / cellSize)), MAX_GRID_CELLS);
+    numCells = std::max(numCells, 1);
+    this->cellSize = 2.0 * this->extent / numCells;
+    heads.assign(static_cast<std::size_t>(numCells) * numCells, -1);
+}
+
+std::size_t SpatialGrid::Insert(const Vector& point)
+{
+    const std::size_t cell = static_cast<std::size_t>(CellOf(point.y)) * numCells + CellOf(point.x);
+    const std::size_t index = points.size();
+    points.push_back(point);
+    next.push_back(heads[cell]);
+    heads[cell] = static_cast<int>(index);
+    return index;
+}
+
+void SpatialGrid::Clear()
+{
+    std::fill(heads.begin(), heads.end(), -1);
+    next.clear();
+    points.clear();
+}
+
+double SpatialGrid::NearestDistance(const Vector& center, const double radius) const
+{
+    double nearest = radius * radius;
+    ForEachNear(center, radius, [&](const std::size_t i)
+    {
+        nearest = std::min(nearest, (points[i] - center).SquaredMagnitude());
+        return true;
+    });
+
+    return std::sqrt(nearest);
+}
@@ -0,0 +1,365 @@
+#include "helper/jsonlib.hpp"
+
+#include <cmath>    // std::isfinite
+#include <cstdio>   // std::snprintf
+#include <cstdlib>  // std::strtod, std::strtoul
+#include <cstring>  // std::strlen, std::strchr
+#include <ostream>
+#include <string>
+
+#include "helper/fmtlib.hpp"
+
+std::string JsonEscape(const std::string& text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '"': escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\r': escaped += "\\r"; break;
+        case '\t': escaped += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char code[7];
+                std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned int>(c));
+                escaped += code;
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+    }
+
+    return escaped;
+}
+
+JsonWriter& JsonWriter::BeginObject()
+{
+    Separate();
+    out << '{';
+    isFirst.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndObject()
+{
+    out << '}';
+    isFirst.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray()
+{
+    Separate();
+    out << '[';
+    isFirst.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::EndArray()
+{
+    out << ']';
+    isFirst.pop_back();
+    return *this;
+}
+
+JsonWriter& JsonWriter::Key(const std::string& key)
+{
+    Separate();
+    out << '"' << JsonEscape(key) << "\":";
+    isAfterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(const std::string& value)
+{
+    Separate();
+    out << '"' << JsonEscape(value) << '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(const double value)
+{
+    Separate();
+    if (std::isfinite(value))
+        out << Formatter(value, JSON_PRECISION);
+    else
+        out << "null";
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(const bool value)
+{
+    Separate();
+    out << (value ? "true" : "false");
+    return *this;
+}
+
+void JsonWriter::Separate()
+{
+    // a value right after its key needs no comma
+    if (isAfterKey)
+    {
+        isAfterKey = false;
+        return;
+    }
+
+    if (!isFirst.empty())
+    {
+        if (!isFirst.back())
+            out << ',';
+        isFirst.back() = false;
+    }
+}
+
+const JsonValue* JsonValue::Find(const std::string& key) const
+{
+    for (const auto& member : members)
+    {
+        if (member.first == key)
+            return &member.second;
+    }
+
+    return nullptr;
+}
+
+/// @brief A recursive descent parser over a JSON document
+class JsonParser
+{
+public:
+    explicit JsonParser(const std::string& text) : text(text) {}
+
+    /// @brief Parses the whole document
+    bool Parse(JsonValue& value, std::string& error)
+    {
+        bool isValid = ParseValue(value, 0);
+        SkipSpace();
+        if (isValid && pos != text.size())
+            isValid = Fail("unexpected trailing characters");
+
+        if (!isValid)
+        {
+            error = "invalid JSON at offset " + std::to_string(pos) + ": " + reason;
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    bool Fail(const std::string& why)
+    {
+        reason = why;
+        return false;
+    }
+
+    void SkipSpace()
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+        {
+            ++pos;
+        }
+    }
+
+    bool Expect(const char* literal)
+    {
+        const std::size_t length = std::strlen(literal);
+        if (text.compare(pos, length, literal) != 0)
+            return Fail("invalid literal");
+        pos += length;
+        return true;
+    }
+
+    bool ParseValue(JsonValue& value, const int depth)
+    {
+        if (depth > JSON_MAX_DEPTH)
+            return Fail("nested too deeply");
+
+        SkipSpace();
+        if (pos == text.size())
+            return Fail("unexpected end");
+
+        value = JsonValue();
+        switch (text[pos])
+        {
+        case 'n':
+            return Expect("null");
+        case 't':
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+            return Expect("true");
+        case 'f':
+            value.type = JsonValue::Type::Bool;
+            return Expect("false");
+        case '"':
+            value.type = JsonValue::Type::String;
+            return ParseString(value.text);
+        case '[':
+            value.type = JsonValue::Type::Array;
+            return ParseArray(value, depth);
+        case '{':
+            value.type = JsonValue::Type::Object;
+            return ParseObject(value, depth);
+        default:
+            value.type = JsonValue::Type::Number;
+            return ParseNumber(value);
+        }
+    }
+
+    bool ParseNumber(JsonValue& value)
+    {
+        const std::size_t start = pos;
+        while (pos < text.size() && std::strchr("+-0123456789.eE", text[pos]) != nullptr)
+        {
+            ++pos;
+        }
+
+        value.text = text.substr(start, pos - start);
+        char* end = nullptr;
+        value.number = std::strtod(value.text.c_str(), &end);
+        if (value.text.empty() || end != value.text.c_str() + value.text.size())
+            return Fail("invalid number");
+        return true;
+    }
+
+    bool ParseString(std::string& out)
+    {
+        ++pos;  // the opening quote
+        while (pos < text.size() && text[pos] != '"')
+        {
+            const char c = text[pos++];
+            if (c != '\\')
+            {
+                out += c;
+                continue;
+            }
+
+            if (pos == text.size())
+                break;
+            switch (text[pos++])
+            {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u':
+            {
+                // encodes the code point as UTF-8 (surrogate pairs are kept as they are)
+                if (pos + 4 > text.size())
+                    return Fail("invalid escape");
+                char* end = nullptr;
+                const std::string digits = text.substr(pos, 4);
+                const unsigned long code = std::strtoul(digits.c_str(), &end, 16);
+                if (end != digits.c_str() + 4)
+                    return Fail("invalid escape");
+                pos += 4;
+
+                if (code < 0x80)
+                {
+                    out += static_cast<char>(code);
+                }
+                else if (code < 0x800)
+                {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return Fail("invalid escape");
+            }
+        }
+
+        if (pos == text.size())
+            return Fail("unterminated string");
+        ++pos;  // the closing quote
+        return true;
+    }
+
+    bool ParseArray(JsonValue& value, const int depth)
+    {
+        ++pos;  // [
+        SkipSpace();
+        if (pos < text.size() && text[pos] == ']')
+        {
+            ++pos;
+            return true;
+        }
+
+        while (true)
+        {
+            value.elements.emplace_back();
+            if (!ParseValue(value.elements.back(), depth + 1))
+                return false;
+
+            SkipSpace();
+            if (pos == text.size())
+                return Fail("unterminated array");
+            if (text[pos++] == ']')
+                return true;
+            if (text[pos - 1] != ',')
+                return Fail("expected , or ]");
+        }
+    }
+
+    bool ParseObject(JsonValue& value, const int depth)
+    {
+        ++pos;  // {
+        SkipSpace();
+        if (pos < text.size() && text[pos] == '}')
+        {
+            ++pos;
+            return true;
+        }
+
+        while (true)
+        {
+            SkipSpace();
+            if (pos == text.size() || text[pos] != '"')
+                return Fail("expected a key");
+
+            value.members.emplace_back();
+            if (!ParseString(value.members.back().first))
+                return false;
+
+            SkipSpace();
+            if (pos == text.size() || text[pos++] != ':')
+                return Fail("expected :");
+            if (!ParseValue(value.members.back().second, depth + 1))
+                return false;
+
+            SkipSpace();
+            if (pos == text.size())
+                return Fail("unterminated object");
+            if (text[pos++] == '}')
+                return true;
+            if (text[pos - 1] != ',')
+                return Fail("expected , or }");
+        }
+    }
+
+    const std::string& text;
+    std::size_t pos = 0;
+    std::string reason;
+};
+
+bool ParseJson(const std::string& text, JsonValue& value, std::string& error)
+{
+    return JsonParser(text).Parse(value, error);
+}
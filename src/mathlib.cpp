@@ -1,9 +1,40 @@
+#include "math/mathlib.hpp"
+
+#include <cmath>    // std::sqrt, std::log, std::exp, std::fabs
+#include <algorithm>    // std::min
+#include <cstring>  // std::memcpy
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
 #include <boost/math/distributions/normal.hpp> // for normal_distribution
 #include <boost/random.hpp> // for mt19937 and variate_generator
 
+// Philox4x32 constants
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+// Ziggurat constants (Doornik, "An Improved Ziggurat Method to Generate Normal Random Samples")
+#define ZIGGURAT_LAYERS 128
+#define ZIGGURAT_R 3.442619855899
+#define ZIGGURAT_V 9.91256303526217e-3
+
+// the number of blocks in one SIMD group of Philox4x32Batch
+#define PHILOX_LANES 8
+
+// the number of normals FillNormal tries at a time (2 words each)
+#define NORMAL_LANES 4
+
+// the number of integers FillUniformInt tries at a time (1 word each)
+#define INT_LANES 8
+
 double boost_normal_distribution(double mean, double sd)
 {
-    static boost::mt19937 rng; // random number generator, declared as static
+    thread_local boost::mt19937 rng; // random number generator, one per thread
     boost::normal_distribution<> nd(mean, sd);
     boost::variate_generator<boost::mt19937&, boost::normal_distribution<>> var_nor(rng, nd);
 
@@ -12,8 +43,474 @@ double boost_normal_distribution(double mean, double sd)
 
 int boost_uniform_int_distribution(int max, int min)
 {
-    static boost::mt19937 rng; // random number generator, declared as static
+    thread_local boost::mt19937 rng; // random number generator, one per thread
     boost::random::uniform_int_distribution<> uni(min, max);
 
     return uni(rng);
-}
\ No newline at end of file
+}
+
+std::array<std::uint32_t, 4> Philox4x32(std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key)
+{
+    for (int round = 0; round < PHILOX_ROUNDS; ++round)
+    {
+        const std::uint64_t p0 = static_cast<std::uint64_t>(PHILOX_M0) * counter[0];
+        const std::uint64_t p1 = static_cast<std::uint64_t>(PHILOX_M1) * counter[2];
+
+        counter = {static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<std::uint32_t>(p1),
+                   static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<std::uint32_t>(p0)};
+
+        // bumps the key
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+
+    return counter;
+}
+
+#if defined(__AVX2__)
+
+/// @brief Multiplies the 32-bit lanes of a and b and splits the 64-bit products into their high and low halves
+static inline void MulHiLo(const __m256i a, const __m256i b, __m256i& hi, __m256i& lo)
+{
+    // _mm256_mul_epu32 only multiplies the even lanes, so the odd lanes are shifted down first
+    const __m256i even = _mm256_mul_epu32(a, b);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+/// @brief Runs 8 Philox4x32-10 blocks, one per 32-bit lane (AVX2)
+static void Philox4x32Lanes(std::uint32_t (&c)[4][PHILOX_LANES], std::array<std::uint32_t, 2> key)
+{
+    __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c[0]));
+    __m256i c1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c[1]));
+    __m256i c2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c[2]));
+    __m256i c3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c[3]));
+    const __m256i m0 = _mm256_set1_epi32(static_cast<int>(PHILOX_M0));
+    const __m256i m1 = _mm256_set1_epi32(static_cast<int>(PHILOX_M1));
+
+    for (int round = 0; round < PHILOX_ROUNDS; ++round)
+    {
+        __m256i hi0, lo0, hi1, lo1;
+        MulHiLo(m0, c0, hi0, lo0);
+        MulHiLo(m1, c2, hi1, lo1);
+
+        c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(key[0])));
+        c1 = lo1;
+        c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(key[1])));
+        c3 = lo0;
+
+        // bumps the key
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c[0]), c0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c[1]), c1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c[2]), c2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(c[3]), c3);
+}
+
+#elif defined(__ARM_NEON)
+
+/// @brief Runs 8 Philox4x32-10 blocks, one per lane (structure of arrays so the compiler can vectorize it with NEON)
+static void Philox4x32Lanes(std::uint32_t (&c)[4][PHILOX_LANES], std::array<std::uint32_t, 2> key)
+{
+    for (int round = 0; round < PHILOX_ROUNDS; ++round)
+    {
+        // writes the next state to a separate array so the lanes are independent
+        std::uint32_t next[4][PHILOX_LANES];
+        for (int lane = 0; lane < PHILOX_LANES; ++lane)
+        {
+            const std::uint64_t p0 = static_cast<std::uint64_t>(PHILOX_M0) * c[0][lane];
+            const std::uint64_t p1 = static_cast<std::uint64_t>(PHILOX_M1) * c[2][lane];
+
+            next[0][lane] = static_cast<std::uint32_t>(p1 >> 32) ^ c[1][lane] ^ key[0];
+            next[1][lane] = static_cast<std::uint32_t>(p1);
+            next[2][lane] = static_cast<std::uint32_t>(p0 >> 32) ^ c[3][lane] ^ key[1];
+            next[3][lane] = static_cast<std::uint32_t>(p0);
+        }
+        std::memcpy(c, next, sizeof(next));
+
+        // bumps the key
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+}
+
+#else
+
+/// @brief Runs 8 Philox4x32-10 blocks one after another
+/// @note without AVX2 or NEON the compiler does better with the scalar 32x32->64 multiplier than with SSE2
+static void Philox4x32Lanes(std::uint32_t (&c)[4][PHILOX_LANES], std::array<std::uint32_t, 2> key)
+{
+    for (int lane = 0; lane < PHILOX_LANES; ++lane)
+    {
+        const auto block = Philox4x32({c[0][lane], c[1][lane], c[2][lane], c[3][lane]}, key);
+        for (int word = 0; word < 4; ++word)
+        {
+            c[word][lane] = block[word];
+        }
+    }
+}
+
+#endif
+
+void Philox4x32Batch(const std::array<std::uint32_t, 4>& counter, const std::array<std::uint32_t, 2>& key, const std::size_t numBlocks, std::uint32_t* out)
+{
+    const std::uint64_t first = (static_cast<std::uint64_t>(counter[1]) << 32) | counter[0];
+
+    for (std::size_t base = 0; base < numBlocks; base += PHILOX_LANES)
+    {
+        // lays out the counters of the group as a structure of arrays
+        std::uint32_t c[4][PHILOX_LANES];
+        for (int lane = 0; lane < PHILOX_LANES; ++lane)
+        {
+            const std::uint64_t block = first + base + lane;
+            c[0][lane] = static_cast<std::uint32_t>(block);
+            c[1][lane] = static_cast<std::uint32_t>(block >> 32);
+            c[2][lane] = counter[2];
+            c[3][lane] = counter[3];
+        }
+
+        Philox4x32Lanes(c, key);
+
+        // writes the blocks back in counter order
+        const std::size_t numLanes = std::min<std::size_t>(PHILOX_LANES, numBlocks - base);
+        for (std::size_t lane = 0; lane < numLanes; ++lane)
+        {
+            for (int word = 0; word < 4; ++word)
+            {
+                out[4 * (base + lane) + word] = c[word][lane];
+            }
+        }
+    }
+}
+
+/// @brief Converts 64 random bits to a double in [0, 1)
+static inline double ToUniform(const std::uint32_t a, const std::uint32_t b)
+{
+    // uses 53 random bits to fill the mantissa
+    return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+/// @brief Converts 64 random bits to a double in (-1, 1)
+static inline double ToSignedUniform(const std::uint32_t a, const std::uint32_t b)
+{
+    return 2.0 * ToUniform(a, b) - 1.0;
+}
+
+/// @brief The 7-bit layer of the Ziggurat from the bits dropped by ToUniform
+static inline unsigned int ToLayer(const std::uint32_t a, const std::uint32_t b)
+{
+    return (a & 0x1F) | ((b & 0x3) << 5);
+}
+
+/// @brief The layers of the Ziggurat
+struct ZigguratTables
+{
+    double x[ZIGGURAT_LAYERS + 1];  // the right edges of the layers
+    double r[ZIGGURAT_LAYERS];  // the ratios of the edges of two neighbouring layers
+
+    ZigguratTables()
+    {
+        double f = std::exp(-0.5 * ZIGGURAT_R * ZIGGURAT_R);
+        x[0] = ZIGGURAT_V / f;  // the bottom layer, which includes the tail
+        x[1] = ZIGGURAT_R;
+        x[ZIGGURAT_LAYERS] = 0;
+        for (int i = 2; i < ZIGGURAT_LAYERS; ++i)
+        {
+            x[i] = std::sqrt(-2.0 * std::log(ZIGGURAT_V / x[i - 1] + f));
+            f = std::exp(-0.5 * x[i] * x[i]);
+        }
+
+        for (int i = 0; i < ZIGGURAT_LAYERS; ++i)
+        {
+            r[i] = x[i + 1] / x[i];
+        }
+    }
+};
+
+/// @brief Gets the Ziggurat (built once, thread-safe)
+static const ZigguratTables& GetZiggurat()
+{
+    static const ZigguratTables tables;
+    return tables;
+}
+
+/// @brief Counts the lanes before the first rejected one
+static inline int NumAccepted(const unsigned int mask, const int numLanes)
+{
+    int count = 0;
+    while (count < numLanes && (mask >> count & 1u))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+#if defined(__AVX2__)
+
+/// @brief Tries the rectangles of the Ziggurat for 4 standard normals at once (AVX2)
+/// @param words the 8 random words of the samples, in the order StandardNormal draws them
+/// @param zig the layers of the Ziggurat
+/// @param out the 4 samples (only the accepted ones are valid)
+/// @return the number of samples accepted before the first one that falls outside its rectangle
+static int NormalLanes(const std::uint32_t* words, const ZigguratTables& zig, double* out)
+{
+    // splits the pairs (a, b) of the samples into a = words 0, 2, 4, 6 and b = words 1, 3, 5, 7
+    const __m256i w = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)), _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+    const __m128i a = _mm256_castsi256_si128(w), b = _mm256_extracti128_si256(w, 1);
+
+    // ToSignedUniform and ToLayer (the shifted words fit in 27 bits, so the signed conversion is exact)
+    const __m256d high = _mm256_cvtepi32_pd(_mm_srli_epi32(a, 5)), low = _mm256_cvtepi32_pd(_mm_srli_epi32(b, 6));
+    const __m256d uniform = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(high, _mm256_set1_pd(67108864.0)), low), _mm256_set1_pd(1.0 / 9007199254740992.0));
+    const __m256d u = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), uniform), _mm256_set1_pd(1.0));
+    const __m128i layer = _mm_or_si128(_mm_and_si128(a, _mm_set1_epi32(0x1F)), _mm_slli_epi32(_mm_and_si128(b, _mm_set1_epi32(0x3)), 5));
+
+    // |u| < r[i] keeps u * x[i] (the masked gathers start from zeros, which the plain ones leave undefined)
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    const __m256d r = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), zig.r, layer, all, sizeof(double));
+    const __m256d x = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), zig.x, layer, all, sizeof(double));
+    const __m256d magnitude = _mm256_andnot_pd(_mm256_set1_pd(-0.0), u);
+    const unsigned int inside = static_cast<unsigned int>(_mm256_movemask_pd(_mm256_cmp_pd(magnitude, r, _CMP_LT_OQ)));
+    _mm256_storeu_pd(out, _mm256_mul_pd(u, x));
+
+    return NumAccepted(inside, NORMAL_LANES);
+}
+
+/// @brief Tries Lemire's method for 8 integers at once (AVX2)
+/// @param words the 8 random words
+/// @param range the number of integers (not 0)
+/// @param threshold the low halves below this are rejected
+/// @param min the smallest integer
+/// @param out the 8 integers (only the accepted ones are valid)
+/// @return the number of integers accepted before the first rejected one
+static int UniformIntLanes(const std::uint32_t* words, const std::uint32_t range, const std::uint32_t threshold, const std::uint32_t min, int* out)
+{
+    __m256i high, low;
+    MulHiLo(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)), _mm256_set1_epi32(static_cast<int>(range)), high, low);
+
+    // AVX2 only compares signed lanes, so both sides are flipped by the sign bit
+    const __m256i sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i rejected = _mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(threshold)), sign), _mm256_xor_si256(low, sign));
+    const unsigned int accepted = ~static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(rejected))) & 0xFFu;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi32(high, _mm256_set1_epi32(static_cast<int>(min))));
+
+    return NumAccepted(accepted, INT_LANES);
+}
+
+#else
+
+/// @brief Tries the rectangles of the Ziggurat for 4 standard normals at once
+/// @note the lanes are independent, so the compiler vectorizes the arithmetic with SSE2 or NEON
+static int NormalLanes(const std::uint32_t* words, const ZigguratTables& zig, double* out)
+{
+    unsigned int inside = 0;
+    for (int lane = 0; lane < NORMAL_LANES; ++lane)
+    {
+        const std::uint32_t a = words[2 * lane], b = words[2 * lane + 1];
+        const double u = ToSignedUniform(a, b);
+        const unsigned int i = ToLayer(a, b);
+        out[lane] = u * zig.x[i];
+        inside |= static_cast<unsigned int>(std::fabs(u) < zig.r[i]) << lane;
+    }
+
+    return NumAccepted(inside, NORMAL_LANES);
+}
+
+/// @brief Tries Lemire's method for 8 integers at once
+/// @note the lanes are independent, so the compiler vectorizes them with SSE2 or NEON
+static int UniformIntLanes(const std::uint32_t* words, const std::uint32_t range, const std::uint32_t threshold, const std::uint32_t min, int* out)
+{
+    unsigned int accepted = 0;
+    for (int lane = 0; lane < INT_LANES; ++lane)
+    {
+        const std::uint64_t m = static_cast<std::uint64_t>(words[lane]) * range;
+        out[lane] = static_cast<int>(min + static_cast<std::uint32_t>(m >> 32));
+        accepted |= static_cast<unsigned int>(static_cast<std::uint32_t>(m) >= threshold) << lane;
+    }
+
+    return NumAccepted(accepted, INT_LANES);
+}
+
+#endif
+
+RandomEngine::RandomEngine(std::uint64_t seed, std::uint32_t index, std::uint32_t stream)
+    : key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}, counter{0, 0, index, stream}, buffer{}, pos(BATCH_WORDS) {}
+
+void RandomEngine::Refill()
+{
+    Philox4x32Batch(counter, key, BATCH_BLOCKS, buffer.data());
+    pos = 0;
+
+    // the first two words of the counter number the blocks
+    const std::uint64_t next = ((static_cast<std::uint64_t>(counter[1]) << 32) | counter[0]) + BATCH_BLOCKS;
+    counter[0] = static_cast<std::uint32_t>(next);
+    counter[1] = static_cast<std::uint32_t>(next >> 32);
+}
+
+RandomEngine::result_type RandomEngine::operator()()
+{
+    // generates the next batch of blocks once the current one has been used up
+    if (pos == BATCH_WORDS)
+        Refill();
+
+    return buffer[pos++];
+}
+
+double RandomEngine::Uniform()
+{
+    const std::uint32_t a = (*this)();
+    const std::uint32_t b = (*this)();
+    return ToUniform(a, b);
+}
+
+double RandomEngine::Normal(double mean, double sd)
+{
+    return mean + sd * StandardNormal(GetZiggurat());
+}
+
+double RandomEngine::StandardNormal(const ZigguratTables& zig)
+{
+    for (;;)
+    {
+        const std::uint32_t a = (*this)();
+        const std::uint32_t b = (*this)();
+        const double u = ToSignedUniform(a, b);
+        const unsigned int i = ToLayer(a, b);
+
+        // most samples fall inside the rectangle of their layer
+        if (std::fabs(u) < zig.r[i])
+            return u * zig.x[i];
+
+        // the bottom layer samples from the tail
+        if (i == 0)
+        {
+            double x, y;
+            do
+            {
+                x = std::log(1.0 - Uniform()) / ZIGGURAT_R;
+                y = std::log(1.0 - Uniform());
+            } while (-2.0 * y < x * x);
+
+            return (u < 0) ? x - ZIGGURAT_R : ZIGGURAT_R - x;
+        }
+
+        // the wedge between the rectangle and the curve
+        const double x = u * zig.x[i];
+        const double f0 = std::exp(-0.5 * (zig.x[i] * zig.x[i] - x * x));
+        const double f1 = std::exp(-0.5 * (zig.x[i + 1] * zig.x[i + 1] - x * x));
+        if (f1 + Uniform() * (f0 - f1) < 1.0)
+            return x;
+    }
+}
+
+int RandomEngine::UniformInt(int max, int min)
+{
+    // Lemire's nearly divisionless method (unbiased)
+    const std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+    std::uint32_t x = (*this)();
+
+    // the whole 32-bit range
+    if (range == 0)
+        return static_cast<int>(static_cast<std::uint32_t>(min) + x);
+
+    std::uint64_t m = static_cast<std::uint64_t>(x) * range;
+    std::uint32_t l = static_cast<std::uint32_t>(m);
+    if (l < range)
+    {
+        const std::uint32_t threshold = -range % range;
+        while (l < threshold)
+        {
+            x = (*this)();
+            m = static_cast<std::uint64_t>(x) * range;
+            l = static_cast<std::uint32_t>(m);
+        }
+    }
+
+    return static_cast<int>(static_cast<std::uint32_t>(min) + static_cast<std::uint32_t>(m >> 32));
+}
+
+void RandomEngine::FillUniform(double* out, const std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = Uniform();
+    }
+}
+
+void RandomEngine::FillNormal(double* out, const std::size_t n, double mean, double sd)
+{
+    // looks up the tables once for the whole batch
+    const ZigguratTables& zig = GetZiggurat();
+
+    std::size_t i = 0;
+    while (i < n)
+    {
+        if (pos == BATCH_WORDS)
+            Refill();
+
+        // tries the next samples at once while their words are in the buffer
+        if (n - i >= NORMAL_LANES && pos + 2 * NORMAL_LANES <= BATCH_WORDS)
+        {
+            const int numAccepted = NormalLanes(&buffer[pos], zig, out + i);
+            pos += 2 * numAccepted;
+            i += numAccepted;
+            if (numAccepted == NORMAL_LANES)
+                continue;
+        }
+
+        // the first rejected sample (or the tail of the batch) redraws its words, so the draws are the same as Normal()
+        out[i++] = StandardNormal(zig);
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        out[i] = mean + sd * out[i];
+    }
+}
+
+void RandomEngine::FillUniformInt(int* out, const std::size_t n, int max, int min)
+{
+    // Lemire's nearly divisionless method with the division hoisted out of the loop
+    const std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+    const std::uint32_t threshold = (range == 0) ? 0 : -range % range;
+
+    std::size_t i = 0;
+    while (i < n)
+    {
+        if (pos == BATCH_WORDS)
+            Refill();
+
+        // tries the next integers at once while their words are in the buffer
+        if (range != 0 && n - i >= INT_LANES && pos + INT_LANES <= BATCH_WORDS)
+        {
+            const int numAccepted = UniformIntLanes(&buffer[pos], range, threshold, static_cast<std::uint32_t>(min), out + i);
+            pos += numAccepted;
+            i += numAccepted;
+            if (numAccepted == INT_LANES)
+                continue;
+        }
+
+        std::uint32_t x = (*this)();
+
+        // the whole 32-bit range
+        if (range == 0)
+        {
+            out[i++] = static_cast<int>(static_cast<std::uint32_t>(min) + x);
+            continue;
+        }
+
+        std::uint64_t m = static_cast<std::uint64_t>(x) * range;
+        while (static_cast<std::uint32_t>(m) < threshold)
+        {
+            x = (*this)();
+            m = static_cast<std::uint64_t>(x) * range;
+        }
+
+        out[i++] = static_cast<int>(static_cast<std::uint32_t>(min) + static_cast<std::uint32_t>(m >> 32));
+    }
+}
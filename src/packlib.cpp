@@ -0,0 +1,195 @@
+#include "helper/packlib.hpp"
+
+#include <cerrno>   // errno
+#include <cstdint>  // std::uint32_t, std::uint64_t
+#include <cstring>  // std::strerror, std::memcmp
+#include <fstream>
+#include <string>
+#include <utility>  // std::move
+#include <vector>
+
+#include "helper/filelib.hpp"
+
+// the size of the magic
+#define PACK_MAGIC_SIZE 8
+
+// the size of the footer: the offset of the index, the number of entries and the magic
+#define PACK_FOOTER_SIZE (8 + 8 + PACK_MAGIC_SIZE)
+
+/// @brief Appends a little-endian integer
+template<typename T>
+static void PutLittleEndian(std::vector<unsigned char>& out, const T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+/// @brief Reads a little-endian integer
+template<typename T>
+static T GetLittleEndian(const unsigned char* in)
+{
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+    {
+        value |= static_cast<T>(in[i]) << (8 * i);
+    }
+
+    return value;
+}
+
+bool PackWriter::Open(const std::string& filename, std::string& error)
+{
+    file.close();
+    file.clear();
+    if (!OpenNewFile(file, filename, std::ios::binary))
+    {
+        error = "cannot open " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    this->filename = filename;
+    entries.clear();
+    file.write(PACK_MAGIC, PACK_MAGIC_SIZE);
+    offset = PACK_MAGIC_SIZE;
+    return true;
+}
+
+bool PackWriter::Append(const std::string& name, const std::vector<unsigned char>& bytes, std::string& error)
+{
+    if (!file.is_open())
+    {
+        error = "cannot append " + name + ": no open pack";
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+    {
+        error = "cannot write " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    entries.push_back(PackEntry{name, offset, bytes.size()});
+    offset += bytes.size();
+    return true;
+}
+
+bool PackWriter::Close(std::string& error)
+{
+    if (!file.is_open())
+    {
+        error = "cannot close: no open pack";
+        return false;
+    }
+
+    std::vector<unsigned char> index;
+    for (const PackEntry& entry : entries)
+    {
+        PutLittleEndian<std::uint64_t>(index, entry.offset);
+        PutLittleEndian<std::uint64_t>(index, entry.size);
+        PutLittleEndian<std::uint32_t>(index, static_cast<std::uint32_t>(entry.name.size()));
+        index.insert(index.end(), entry.name.begin(), entry.name.end());
+    }
+    PutLittleEndian<std::uint64_t>(index, offset);
+    PutLittleEndian<std::uint64_t>(index, entries.size());
+    index.insert(index.end(), PACK_MAGIC, PACK_MAGIC + PACK_MAGIC_SIZE);
+
+    file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+    file.close();
+    if (!file)
+    {
+        error = "cannot write " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    return true;
+}
+
+bool PackReader::Open(const std::string& filename, std::string& error)
+{
+    file.close();
+    file.clear();
+    file.open(filename, std::ios::binary);
+    if (!file)
+    {
+        error = "cannot open " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    this->filename = filename;
+    entries.clear();
+
+    // the footer points at the index
+    file.seekg(0, std::ios::end);
+    const std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+    unsigned char footer[PACK_FOOTER_SIZE];
+    if (fileSize < PACK_MAGIC_SIZE + PACK_FOOTER_SIZE || !file.seekg(fileSize - PACK_FOOTER_SIZE) || !file.read(reinterpret_cast<char*>(footer), PACK_FOOTER_SIZE) \
+    || std::memcmp(footer + 16, PACK_MAGIC, PACK_MAGIC_SIZE) != 0)
+    {
+        error = filename + " is not a complete pack file";
+        return false;
+    }
+
+    const std::uint64_t indexOffset = GetLittleEndian<std::uint64_t>(footer);
+    const std::uint64_t numEntries = GetLittleEndian<std::uint64_t>(footer + 8);
+    if (indexOffset < PACK_MAGIC_SIZE || indexOffset > fileSize - PACK_FOOTER_SIZE)
+    {
+        error = filename + " has an invalid index";
+        return false;
+    }
+
+    std::vector<unsigned char> index(fileSize - PACK_FOOTER_SIZE - indexOffset);
+    file.seekg(indexOffset);
+    file.read(reinterpret_cast<char*>(index.data()), static_cast<std::streamsize>(index.size()));
+
+    std::size_t pos = 0;
+    for (std::uint64_t i = 0; i < numEntries; ++i)
+    {
+        if (!file || pos + 20 > index.size())
+        {
+            error = filename + " has an invalid index";
+            return false;
+        }
+
+        PackEntry entry;
+        entry.offset = GetLittleEndian<std::uint64_t>(&index[pos]);
+        entry.size = GetLittleEndian<std::uint64_t>(&index[pos + 8]);
+        const std::uint32_t nameSize = GetLittleEndian<std::uint32_t>(&index[pos + 16]);
+        pos += 20;
+        if (pos + nameSize > index.size() || entry.offset > indexOffset || entry.size > indexOffset - entry.offset)
+        {
+            error = filename + " has an invalid index";
+            return false;
+        }
+
+        entry.name.assign(reinterpret_cast<const char*>(&index[pos]), nameSize);
+        pos += nameSize;
+        entries.push_back(std::move(entry));
+    }
+
+    return true;
+}
+
+bool PackReader::Read(const std::size_t index, std::vector<unsigned char>& bytes, std::string& error)
+{
+    if (index >= entries.size())
+    {
+        error = "no entry " + std::to_string(index) + " in " + filename;
+        return false;
+    }
+
+    const PackEntry& entry = entries[index];
+    bytes.resize(entry.size);
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(entry.offset));
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+    {
+        error = "cannot read " + entry.name + " from " + filename;
+        return false;
+    }
+
+    return true;
+}
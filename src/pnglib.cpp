@@ -0,0 +1,206 @@
+#include "helper/pnglib.hpp"
+
+#include <cerrno>   // errno
+#include <cstring>  // std::strerror, std::memcpy
+#include <cstdint>  // std::uint32_t
+#include <string>
+#include <utility>  // std::move
+#include <vector>
+
+#include <zlib.h>
+
+#include "helper/filelib.hpp"
+
+// the size of the compressed data of an IDAT chunk
+#define PNG_CHUNK_SIZE (1 << 18)
+
+/// @brief Stores a 32-bit integer in the big-endian order of PNG
+static void PutUint32(unsigned char* out, const std::uint32_t value)
+{
+    out[0] = static_cast<unsigned char>(value >> 24);
+    out[1] = static_cast<unsigned char>(value >> 16);
+    out[2] = static_cast<unsigned char>(value >> 8);
+    out[3] = static_cast<unsigned char>(value);
+}
+
+PngWriter::PngWriter() : stream(std::make_unique<z_stream>()) {}
+
+PngWriter::~PngWriter()
+{
+    if (!filename.empty())
+        deflateEnd(stream.get());
+}
+
+bool PngWriter::Open(const std::string& filename, const int rows, const int cols, const int channels, std::string& error)
+{
+    if (!this->filename.empty())
+    {
+        error = "cannot open " + filename + ": " + this->filename + " is still open";
+        return false;
+    }
+    if (rows <= 0 || cols <= 0 || (channels != 1 && channels != 3))
+    {
+        error = "cannot open " + filename + ": invalid image size";
+        return false;
+    }
+
+    if (!OpenNewFile(file, filename, std::ios::binary))
+    {
+        error = "cannot open " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    *stream = z_stream();
+    if (deflateInit(stream.get(), PNG_COMPRESSION_LEVEL) != Z_OK)
+    {
+        error = "cannot open " + filename + ": cannot initialise zlib";
+        file.close();
+        return false;
+    }
+
+    this->filename = filename;
+    this->rows = rows;
+    this->cols = cols;
+    this->channels = channels;
+    rowsWritten = 0;
+    row.assign(1 + static_cast<std::size_t>(cols) * channels, 0);
+    chunk.resize(PNG_CHUNK_SIZE);
+    stream->next_out = chunk.data();
+    stream->avail_out = PNG_CHUNK_SIZE;
+
+    // the signature and the header: 8-bit depth, grayscale (0) or RGB (2), deflate, adaptive filters, no interlace
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    unsigned char header[13];
+    PutUint32(header, static_cast<std::uint32_t>(cols));
+    PutUint32(header + 4, static_cast<std::uint32_t>(rows));
+    header[8] = 8;
+    header[9] = (channels == 1) ? 0 : 2;
+    header[10] = header[11] = header[12] = 0;
+
+    return WriteChunk("IHDR", header, sizeof(header), error);
+}
+
+bool PngWriter::WriteRows(const unsigned char* data, const int numRows, const std::size_t step, std::string& error)
+{
+    if (filename.empty())
+    {
+        error = "cannot write rows: no open file";
+        return false;
+    }
+    if (rowsWritten + numRows > rows)
+    {
+        error = "cannot write " + filename + ": too many rows";
+        return false;
+    }
+
+    for (int y = 0; y < numRows; ++y, data += step)
+    {
+        // every row starts with filter type 0 (none) and colours are stored as R, G, B
+        unsigned char* out = row.data() + 1;
+        if (channels == 1)
+        {
+            std::memcpy(out, data, cols);
+        }
+        else
+        {
+            for (int x = 0; x < cols; ++x, out += 3)
+            {
+                out[0] = data[3 * x + 2];
+                out[1] = data[3 * x + 1];
+                out[2] = data[3 * x];
+            }
+        }
+
+        stream->next_in = row.data();
+        stream->avail_in = static_cast<uInt>(row.size());
+        if (!Deflate(Z_NO_FLUSH, error))
+            return false;
+    }
+
+    rowsWritten += numRows;
+    return true;
+}
+
+bool PngWriter::Close(std::string& error)
+{
+    if (filename.empty())
+    {
+        error = "cannot close: no open file";
+        return false;
+    }
+    if (rowsWritten != rows)
+    {
+        error = "cannot close " + filename + ": " + std::to_string(rowsWritten) + " of " + std::to_string(rows) + " rows written";
+        return false;
+    }
+
+    stream->next_in = nullptr;
+    stream->avail_in = 0;
+    const bool isWritten = Deflate(Z_FINISH, error) && WriteChunk("IEND", nullptr, 0, error);
+
+    deflateEnd(stream.get());
+    const std::string closed = std::move(filename);
+    filename.clear();
+    file.close();
+    if (isWritten && !file)
+    {
+        error = "cannot write " + closed + ": " + std::strerror(errno);
+        return false;
+    }
+
+    return isWritten;
+}
+
+bool PngWriter::WriteChunk(const char* type, const unsigned char* data, const std::size_t size, std::string& error)
+{
+    unsigned char prefix[8];
+    PutUint32(prefix, static_cast<std::uint32_t>(size));
+    std::memcpy(prefix + 4, type, 4);
+
+    // the CRC covers the type and the data
+    uLong crc = crc32(0L, prefix + 4, 4);
+    if (size)
+        crc = crc32(crc, data, static_cast<uInt>(size));
+    unsigned char suffix[4];
+    PutUint32(suffix, static_cast<std::uint32_t>(crc));
+
+    file.write(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+    if (size)
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    file.write(reinterpret_cast<const char*>(suffix), sizeof(suffix));
+    if (!file)
+    {
+        error = "cannot write " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    return true;
+}
+
+bool PngWriter::Deflate(const int flush, std::string& error)
+{
+    while (true)
+    {
+        const int status = deflate(stream.get(), flush);
+        if (status == Z_STREAM_ERROR)
+        {
+            error = "cannot write " + filename + ": zlib error";
+            return false;
+        }
+
+        // writes the chunk once it is full (or the stream has ended)
+        const bool isDone = (status == Z_STREAM_END);
+        if (stream->avail_out == 0 || (isDone && stream->avail_out < PNG_CHUNK_SIZE))
+        {
+            if (!WriteChunk("IDAT", chunk.data(), PNG_CHUNK_SIZE - stream->avail_out, error))
+                return false;
+            stream->next_out = chunk.data();
+            stream->avail_out = PNG_CHUNK_SIZE;
+        }
+
+        if (isDone || (flush == Z_NO_FLUSH && stream->avail_in == 0))
+            return true;
+    }
+}
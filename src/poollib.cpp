@@ -0,0 +1,79 @@
+#include "helper/poollib.hpp"
+
+#include <cstring>  // std::memset
+#include <mutex>    // std::lock_guard
+#include <utility>  // std::move
+#include <vector>
+
+BufferPool::Handle::Handle(BufferPool* pool, std::vector<unsigned char>&& buffer) : pool(pool), buffer(std::move(buffer))
+{
+}
+
+BufferPool::Handle::Handle(Handle&& other) noexcept : pool(other.pool), buffer(std::move(other.buffer))
+{
+    other.pool = nullptr;
+}
+
+BufferPool::Handle& BufferPool::Handle::operator=(Handle&& other) noexcept
+{
+    if (this != &other)
+    {
+        Reset();
+        pool = other.pool;
+        buffer = std::move(other.buffer);
+        other.pool = nullptr;
+    }
+
+    return *this;
+}
+
+BufferPool::Handle::~Handle()
+{
+    Reset();
+}
+
+void BufferPool::Handle::Reset()
+{
+    if (pool)
+        pool->Release(std::move(buffer));
+
+    pool = nullptr;
+    buffer = std::vector<unsigned char>();
+}
+
+BufferPool::BufferPool(const std::size_t size) : size(size)
+{
+}
+
+BufferPool::Handle BufferPool::Acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idle.empty())
+        {
+            std::vector<unsigned char> buffer = std::move(idle.back());
+            idle.pop_back();
+            return Handle(this, std::move(buffer));
+        }
+
+        ++numAllocated;
+    }
+
+    // allocates outside the lock; new buffers are already zeroed
+    return Handle(this, std::vector<unsigned char>(size, 0));
+}
+
+std::size_t BufferPool::NumAllocated() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return numAllocated;
+}
+
+void BufferPool::Release(std::vector<unsigned char>&& buffer)
+{
+    // clears outside the lock so the other threads are not held up by the memset
+    std::memset(buffer.data(), 0, buffer.size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.push_back(std::move(buffer));
+}
@@ -0,0 +1,187 @@
+#include "helper/profilelib.hpp"
+
+#include <algorithm>    // std::sort, std::max
+#include <atomic>   // std::atomic
+#include <chrono>
+#include <cstdio>   // std::snprintf
+#include <fstream>
+#include <map>
+#include <memory>   // std::unique_ptr
+#include <mutex>    // std::mutex
+#include <vector>
+
+#include "helper/filelib.hpp"
+#include "helper/jsonlib.hpp"
+
+// the number of nanoseconds per microsecond (the unit of Chrome trace events)
+#define NS_PER_US 1000.0
+
+// the number of nanoseconds per second
+#define NS_PER_S 1e9
+
+/// @brief A span recorded by a thread
+struct TraceSpan
+{
+    const char* name;
+    std::int64_t start, end;
+};
+
+/// @brief The spans of a thread (owned by the profiler so they outlive the thread)
+struct ThreadTrace
+{
+    unsigned int id;
+    std::vector<TraceSpan> spans;
+};
+
+static std::atomic<bool> enabled{false};
+static std::int64_t origin = 0;
+static std::mutex traceMutex;
+static std::vector<std::unique_ptr<ThreadTrace>> threadTraces;
+static std::map<std::string, std::vector<std::int64_t>> latencies;
+
+/// @brief Get the trace of the calling thread, registering it on first use
+static ThreadTrace& LocalTrace()
+{
+    thread_local ThreadTrace* trace = nullptr;
+    if (!trace)
+    {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        threadTraces.push_back(std::make_unique<ThreadTrace>());
+        trace = threadTraces.back().get();
+        trace->id = static_cast<unsigned int>(threadTraces.size());
+    }
+
+    return *trace;
+}
+
+/// @brief Get the value at the given percentile of sorted values (nearest rank)
+static std::int64_t Percentile(const std::vector<std::int64_t>& sorted, const double percentile)
+{
+    const std::size_t rank = static_cast<std::size_t>(percentile / 100.0 * sorted.size() + 0.5);
+    return sorted[std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1];
+}
+
+/// @brief Prints a row of the summary: the count, the total and the p50, p99 and max of the durations
+static void PrintRow(std::ostream& out, const std::string& name, std::vector<std::int64_t>& durations)
+{
+    std::sort(durations.begin(), durations.end());
+    std::int64_t total = 0;
+    for (const std::int64_t duration : durations)
+    {
+        total += duration;
+    }
+
+    char row[160];
+    std::snprintf(row, sizeof(row), "  %-24s %8zu %12.1f %10.1f %10.1f %10.1f\n", name.c_str(), durations.size(),
+                  total / (NS_PER_US * 1000), Percentile(durations, 50) / NS_PER_US, Percentile(durations, 99) / NS_PER_US,
+                  durations.back() / NS_PER_US);
+    out << row;
+}
+
+void Profiler::Enable()
+{
+    origin = Now();
+    enabled = true;
+}
+
+bool Profiler::IsEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+std::int64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::Record(const char* name, const std::int64_t start, const std::int64_t end)
+{
+    if (!IsEnabled())
+        return;
+
+    LocalTrace().spans.push_back({name, start, end});
+}
+
+void Profiler::RecordLatency(const char* name, const std::int64_t start)
+{
+    if (!IsEnabled())
+        return;
+
+    const std::int64_t latency = Now() - start;
+    std::lock_guard<std::mutex> lock(traceMutex);
+    latencies[name].push_back(latency);
+}
+
+bool Profiler::WriteTrace(const std::string& filename, std::string& error)
+{
+    std::ofstream file;
+    if (!OpenNewFile(file, filename))
+    {
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    JsonWriter json(file);
+    json.BeginObject().Key("displayTimeUnit").Value("ms").Key("traceEvents").BeginArray();
+    for (const auto& trace : threadTraces)
+    {
+        json.BeginObject()
+            .Key("name").Value("thread_name").Key("ph").Value("M").Key("pid").Value(1).Key("tid").Value(trace->id)
+            .Key("args").BeginObject().Key("name").Value("thread " + std::to_string(trace->id)).EndObject()
+            .EndObject();
+        for (const TraceSpan& span : trace->spans)
+        {
+            // complete events, which nest by their times
+            json.BeginObject()
+                .Key("name").Value(span.name).Key("ph").Value("X").Key("pid").Value(1).Key("tid").Value(trace->id)
+                .Key("ts").Value((span.start - origin) / NS_PER_US).Key("dur").Value((span.end - span.start) / NS_PER_US)
+                .EndObject();
+        }
+    }
+    json.EndArray().EndObject();
+    file << '\n';
+
+    if (!file)
+    {
+        error = "cannot write " + filename;
+        return false;
+    }
+
+    return true;
+}
+
+void Profiler::PrintSummary(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    const double seconds = (Now() - origin) / NS_PER_S;
+
+    std::map<std::string, std::vector<std::int64_t>> stages;
+    for (const auto& trace : threadTraces)
+    {
+        for (const TraceSpan& span : trace->spans)
+        {
+            stages[span.name].push_back(span.end - span.start);
+        }
+    }
+
+    for (const auto& [name, samples] : latencies)
+    {
+        char line[160];
+        std::snprintf(line, sizeof(line), "Profile: %zu %ss in %.3f s (%.1f %ss/s)\n", samples.size(), name.c_str(), seconds,
+                      samples.size() / seconds, name.c_str());
+        out << line;
+    }
+
+    char header[160];
+    std::snprintf(header, sizeof(header), "  %-24s %8s %12s %10s %10s %10s\n", "", "count", "total ms", "p50 us", "p99 us", "max us");
+    out << header;
+    for (auto& [name, samples] : latencies)
+    {
+        PrintRow(out, name + " latency", samples);
+    }
+    for (auto& [name, samples] : stages)
+    {
+        PrintRow(out, name, samples);
+    }
+}
@@ -0,0 +1,535 @@
+#include "graph/rasterlib.hpp"
+
+#include <algorithm>    // std::min, std::max, std::clamp
+#include <cmath>    // std::floor, std::ceil, std::sqrt, std::abs, std::lround, std::llrint
+#include <cstdint>  // std::int64_t
+#include <cstring>  // std::memset, std::memcpy
+#include <utility>  // std::swap
+#include <limits>   // std::numeric_limits
+
+#include "graph/stamplib.hpp"
+#include "coordinate/vectorlib.hpp"
+
+// sub-pixel coordinates of the solid fill (16.16 fixed point like OpenCV)
+#define XY_SHIFT 16
+#define XY_ONE (std::int64_t(1) << XY_SHIFT)
+#define XY_HALF (XY_ONE >> 1)
+
+/// @brief The pixel that contains a coordinate
+/// @note the same as the truncation of cv::Point on the canvas, but also consistent off the canvas, so a primitive covers
+/// the same pixels wherever the canvas is cut (e.g. into strips)
+static int PixelOf(const double coordinate)
+{
+    return static_cast<int>(std::floor(coordinate));
+}
+
+/// @brief The half-plane nx * x + ny * y <= c (with a unit normal)
+struct HalfPlane
+{
+    double nx, ny, c;
+};
+
+/// @brief Get the half-planes of the edges of a convex polygon
+/// @param points the vertices in order (either orientation)
+/// @return the half-planes (empty if the polygon has no area)
+static std::vector<HalfPlane> ToHalfPlanes(const std::vector<Vector>& points)
+{
+    std::vector<HalfPlane> planes;
+    const std::size_t n = points.size();
+    if (n < 3)
+        return planes;
+
+    // the orientation decides which side of every edge is outside
+    double area = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Vector& p = points[i];
+        const Vector& q = points[(i + 1) % n];
+        area += p.x * q.y - q.x * p.y;
+    }
+    if (std::abs(area) < 1e-12)
+        return planes;
+    const double side = (area > 0) ? 1.0 : -1.0;
+
+    planes.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Vector& p = points[i];
+        const Vector edge = points[(i + 1) % n] - p;
+        const double length = edge.Magnitude();
+        if (length == 0.0)
+            continue;
+
+        const double nx = side * edge.y / length, ny = -side * edge.x / length;
+        planes.push_back(HalfPlane{nx, ny, nx * p.x + ny * p.y});
+    }
+
+    return planes;
+}
+
+/// @brief Get the x-interval of row y inside all half-planes pushed out by offset
+/// @return true if the interval is not empty
+static bool RowInterval(const std::vector<HalfPlane>& planes, const double y, const double offset, double& lo, double& hi)
+{
+    lo = -std::numeric_limits<double>::infinity();
+    hi = std::numeric_limits<double>::infinity();
+    for (const HalfPlane& plane : planes)
+    {
+        // nx * x <= bound
+        const double bound = plane.c + offset - plane.ny * y;
+        if (std::abs(plane.nx) < 1e-12)
+        {
+            if (bound < 0)
+                return false;
+        }
+        else if (plane.nx > 0)
+            hi = std::min(hi, bound / plane.nx);
+        else
+            lo = std::max(lo, bound / plane.nx);
+    }
+
+    return lo <= hi;
+}
+
+/// @brief Get the signed distance to a convex polygon (exact inside, a lower bound outside)
+static double SignedDistance(const std::vector<HalfPlane>& planes, const double x, const double y)
+{
+    double d = -std::numeric_limits<double>::infinity();
+    for (const HalfPlane& plane : planes)
+    {
+        d = std::max(d, plane.nx * x + plane.ny * y - plane.c);
+    }
+
+    return d;
+}
+
+/// @brief Get the x-interval of row y within distance rho of the segment [a, b]
+/// @return true if the interval is not empty
+static bool CapsuleRow(const Vector& a, const Vector& b, const double rho, const double y, double& lo, double& hi)
+{
+    lo = std::numeric_limits<double>::infinity();
+    hi = -std::numeric_limits<double>::infinity();
+    if (rho <= 0)
+        return false;
+
+    // the round caps
+    for (const Vector* p : {&a, &b})
+    {
+        const double dy = y - p->y;
+        if (std::abs(dy) <= rho)
+        {
+            const double w = std::sqrt(rho * rho - dy * dy);
+            lo = std::min(lo, p->x - w);
+            hi = std::max(hi, p->x + w);
+        }
+    }
+
+    // the body (a rectangle along the segment)
+    const Vector d = b - a;
+    const double length = d.Magnitude();
+    if (length > 0)
+    {
+        const double ux = d.x / length, uy = d.y / length;
+        const double nx = -uy, ny = ux;
+        const std::vector<HalfPlane> body =
+        {
+            {-ux, -uy, -(ux * a.x + uy * a.y)},
+            {ux, uy, ux * b.x + uy * b.y},
+            {nx, ny, nx * a.x + ny * a.y + rho},
+            {-nx, -ny, -(nx * a.x + ny * a.y) + rho},
+        };
+
+        double bodyLo, bodyHi;
+        if (RowInterval(body, y, 0.0, bodyLo, bodyHi))
+        {
+            lo = std::min(lo, bodyLo);
+            hi = std::max(hi, bodyHi);
+        }
+    }
+
+    return lo <= hi;
+}
+
+/// @brief Get the distance between a point and the segment [a, b]
+static double SegmentDistance(const Vector& a, const Vector& b, const double x, const double y)
+{
+    const Vector d = b - a;
+    const Vector p(x - a.x, y - a.y);
+    const double length2 = d.SquaredMagnitude();
+    const double t = (length2 > 0) ? std::clamp((p * d) / length2, 0.0, 1.0) : 0.0;
+    return (p - t * d).Magnitude();
+}
+
+void Rasterizer::DrawStamp(const std::shared_ptr<const Stamp>& stamp, const Mat2& transform, const Vector& offset, const Colour& colour)
+{
+    stamp->Draw(*this, transform, offset, colour, false);
+}
+
+SpanRasterizer::SpanRasterizer(const RasterBuffer& buffer, const bool antialias) : buffer(buffer), antialias(antialias)
+{
+}
+
+void SpanRasterizer::DrawStamp(const std::shared_ptr<const Stamp>& stamp, const Mat2& transform, const Vector& offset, const Colour& colour)
+{
+    stamp->Draw(*this, transform, offset, colour, antialias);
+}
+
+void SpanRasterizer::FillSpan(const int y, int x0, int x1, const Colour& colour)
+{
+    if (y < 0 || y >= buffer.rows)
+        return;
+
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, buffer.cols - 1);
+    if (x0 > x1)
+        return;
+
+    unsigned char* p = buffer.data + y * buffer.step + static_cast<std::size_t>(x0) * buffer.channels;
+    const int n = x1 - x0 + 1;
+    if (buffer.channels == 1)
+    {
+        std::memset(p, colour.b, n);
+    }
+    else if (buffer.channels == 3)
+    {
+        for (int i = 0; i < n; ++i, p += 3)
+        {
+            p[0] = colour.b;
+            p[1] = colour.g;
+            p[2] = colour.r;
+        }
+    }
+    else
+    {
+        const unsigned char bytes[3] = {colour.b, colour.g, colour.r};
+        const int channels = std::min(buffer.channels, 3);
+        for (int i = 0; i < n; ++i, p += buffer.channels)
+        {
+            for (int k = 0; k < channels; ++k)
+            {
+                p[k] = bytes[k];
+            }
+        }
+    }
+}
+
+void SpanRasterizer::BlendPixel(const int y, const int x, const Colour& colour, const double coverage)
+{
+    if (y < 0 || y >= buffer.rows || x < 0 || x >= buffer.cols || coverage <= 0.0)
+        return;
+
+    unsigned char* p = buffer.data + y * buffer.step + static_cast<std::size_t>(x) * buffer.channels;
+    const unsigned char bytes[3] = {colour.b, colour.g, colour.r};
+    const int channels = std::min(buffer.channels, 3);
+    for (int k = 0; k < channels; ++k)
+    {
+        p[k] = static_cast<unsigned char>(p[k] + (bytes[k] - p[k]) * std::min(coverage, 1.0) + 0.5);
+    }
+}
+
+void SpanRasterizer::PutPixel(const std::int64_t y, const std::int64_t x, const Colour& colour)
+{
+    if (y >= 0 && y < buffer.rows && x >= 0 && x < buffer.cols)
+        FillSpan(static_cast<int>(y), static_cast<int>(x), static_cast<int>(x), colour);
+}
+
+const std::vector<int>& SpanRasterizer::CircleSpans(const int radius)
+{
+    if (static_cast<std::size_t>(radius) >= circleSpans.size())
+        circleSpans.resize(radius + 1);
+
+    std::vector<int>& spans = circleSpans[radius];
+    if (!spans.empty())
+        return spans;
+
+    // the same midpoint walk as cv::circle, which fills rows +-dy with [-dx, dx] and rows +-dx with [-dy, dy]
+    spans.assign(radius + 1, 0);
+    int err = 0, dx = radius, dy = 0, plus = 1, minus = (radius << 1) - 1;
+    while (dx >= dy)
+    {
+        spans[dy] = std::max(spans[dy], dx);
+        spans[dx] = std::max(spans[dx], dy);
+
+        dy++;
+        err += plus;
+        plus += 2;
+        if (err > 0)
+        {
+            err -= minus;
+            dx--;
+            minus -= 2;
+        }
+    }
+
+    return spans;
+}
+
+template<typename Coverage>
+void SpanRasterizer::FillRow(const int y, const double outerLo, const double outerHi, bool hasInner, const double innerLo, const double innerHi, const Colour& colour, Coverage coverage)
+{
+    const int x0 = static_cast<int>(std::ceil(outerLo)), x1 = static_cast<int>(std::floor(outerHi));
+
+    // the pixels inside the inner interval are fully covered
+    int i0 = x1 + 1, i1 = x1;
+    if (hasInner)
+    {
+        i0 = std::max(x0, static_cast<int>(std::ceil(innerLo)));
+        i1 = std::min(x1, static_cast<int>(std::floor(innerHi)));
+        if (i0 > i1)
+        {
+            i0 = x1 + 1;
+            i1 = x1;
+        }
+    }
+
+    for (int x = std::max(x0, 0); x <= std::min(i0 - 1, buffer.cols - 1); ++x)
+    {
+        BlendPixel(y, x, colour, coverage(x));
+    }
+    FillSpan(y, i0, i1, colour);
+    for (int x = std::max(i1 + 1, 0); x <= std::min(x1, buffer.cols - 1); ++x)
+    {
+        BlendPixel(y, x, colour, coverage(x));
+    }
+}
+
+void SpanRasterizer::TraceEdge(FixedPoint p, FixedPoint q, const Colour& colour)
+{
+    const std::int64_t dx = q.x - p.x, dy = q.y - p.y;
+    const bool isShallow = std::abs(dx) > std::abs(dy);
+
+    // walks from the end with the smaller major coordinate, which starts at its rounded major coordinate
+    // NOTE: like cv::line on sub-pixel points, the minor coordinate is not corrected for that rounding
+    if ((isShallow && dx < 0) || (!isShallow && dy < 0))
+        std::swap(p, q);
+
+    // the end point is always drawn
+    PutPixel((q.y + XY_HALF) >> XY_SHIFT, (q.x + XY_HALF) >> XY_SHIFT, colour);
+
+    if (isShallow)
+    {
+        const std::int64_t yStep = ((q.y - p.y) << XY_SHIFT) / ((q.x - p.x) | 1);
+        std::int64_t x = (p.x + XY_HALF) >> XY_SHIFT, y = p.y + XY_HALF;
+        for (std::int64_t count = (q.x - p.x) >> XY_SHIFT; count >= 0; --count, ++x, y += yStep)
+        {
+            PutPixel(y >> XY_SHIFT, x, colour);
+        }
+    }
+    else
+    {
+        const std::int64_t xStep = ((q.x - p.x) << XY_SHIFT) / ((q.y - p.y) | 1);
+        std::int64_t x = p.x + XY_HALF, y = (p.y + XY_HALF) >> XY_SHIFT;
+        for (std::int64_t count = (q.y - p.y) >> XY_SHIFT; count >= 0; --count, x += xStep, ++y)
+        {
+            PutPixel(y, x >> XY_SHIFT, colour);
+        }
+    }
+}
+
+void SpanRasterizer::FillPolygonSolid(const std::vector<FixedPoint>& points, const Colour& colour)
+{
+    const int n = static_cast<int>(points.size());
+    if (n < 3)
+        return;
+
+    // traces the outline and finds the top vertex
+    int top = 0;
+    std::int64_t yMin = points[0].y, yMax = points[0].y;
+    for (int i = 0; i < n; ++i)
+    {
+        if (points[i].y < yMin)
+        {
+            yMin = points[i].y;
+            top = i;
+        }
+        yMax = std::max(yMax, points[i].y);
+
+        TraceEdge(points[(i + n - 1) % n], points[i], colour);
+    }
+
+    // the rows between the rounded extremes
+    const std::int64_t yStart = (yMin + XY_HALF) >> XY_SHIFT;
+    const std::int64_t yEnd = std::min<std::int64_t>((yMax + XY_HALF) >> XY_SHIFT, buffer.rows - 1);
+
+    // walks down the left and right chains from the top vertex (edges [0] and [1] go forwards and backwards)
+    // NOTE: an edge starts at the x of its upper vertex on the row of the rounded y of that vertex
+    struct Edge
+    {
+        int idx, di;
+        std::int64_t x, dx, yEnd;
+    };
+    Edge edges[2] = {{top, 1, -XY_ONE, 0, yStart}, {top, n - 1, -XY_ONE, 0, yStart}};
+    int remaining = n;
+    for (std::int64_t y = yStart; y <= yEnd; ++y)
+    {
+        for (Edge& edge : edges)
+        {
+            if (y < edge.yEnd)
+                continue;
+
+            int idx0 = edge.idx, idx = (edge.idx + edge.di) % n;
+            while (remaining-- > 0)
+            {
+                const std::int64_t ty = (points[idx].y + XY_HALF) >> XY_SHIFT;
+                if (ty > y)
+                {
+                    edge.yEnd = ty;
+                    edge.dx = ((points[idx].x - points[idx0].x) * 2 + (ty - y)) / (2 * (ty - y));
+                    edge.x = points[idx0].x;
+                    edge.idx = idx;
+                    break;
+                }
+                idx0 = idx;
+                idx = (idx + edge.di) % n;
+            }
+        }
+
+        if (remaining < 0)
+            break;
+
+        const std::int64_t x0 = std::min(edges[0].x, edges[1].x), x1 = std::max(edges[0].x, edges[1].x);
+        if (y >= 0)
+            FillSpan(static_cast<int>(y), static_cast<int>(std::max<std::int64_t>((x0 + XY_HALF) >> XY_SHIFT, -1)), static_cast<int>(std::min<std::int64_t>((x1 + XY_HALF) >> XY_SHIFT, buffer.cols)), colour);
+
+        edges[0].x += edges[0].dx;
+        edges[1].x += edges[1].dx;
+    }
+}
+
+void SpanRasterizer::FillCapsuleAA(const Vector& a, const Vector& b, const double rho, const Colour& colour)
+{
+    const int y0 = std::max(static_cast<int>(std::floor(std::min(a.y, b.y) - rho - 0.5)), 0);
+    const int y1 = std::min(static_cast<int>(std::ceil(std::max(a.y, b.y) + rho + 0.5)), buffer.rows - 1);
+    for (int y = y0; y <= y1; ++y)
+    {
+        double outerLo, outerHi, innerLo, innerHi;
+        if (!CapsuleRow(a, b, rho + 0.5, y, outerLo, outerHi))
+            continue;
+
+        const bool hasInner = CapsuleRow(a, b, rho - 0.5, y, innerLo, innerHi);
+        FillRow(y, outerLo, outerHi, hasInner, innerLo, innerHi, colour, [&](const int x)
+        {
+            return rho + 0.5 - SegmentDistance(a, b, x, y);
+        });
+    }
+}
+
+void SpanRasterizer::FillPolygonAA(const std::vector<Vector>& points, const Colour& colour)
+{
+    const std::vector<HalfPlane> planes = ToHalfPlanes(points);
+    if (planes.empty())
+        return;
+
+    double yMin = points[0].y, yMax = points[0].y;
+    for (const Vector& p : points)
+    {
+        yMin = std::min(yMin, p.y);
+        yMax = std::max(yMax, p.y);
+    }
+
+    const int y0 = std::max(static_cast<int>(std::floor(yMin - 0.5)), 0);
+    const int y1 = std::min(static_cast<int>(std::ceil(yMax + 0.5)), buffer.rows - 1);
+    for (int y = y0; y <= y1; ++y)
+    {
+        double outerLo, outerHi, innerLo, innerHi;
+        if (!RowInterval(planes, y, 0.5, outerLo, outerHi))
+            continue;
+
+        const bool hasInner = RowInterval(planes, y, -0.5, innerLo, innerHi);
+        FillRow(y, outerLo, outerHi, hasInner, innerLo, innerHi, colour, [&](const int x)
+        {
+            return 0.5 - SignedDistance(planes, x, y);
+        });
+    }
+}
+
+void SpanRasterizer::FillCircle(const Vector& center, const int radius, const Colour& colour)
+{
+    if (radius < 0)
+        return;
+
+    // NOTE: pixel (x, y) covers the square [x, x + 1) x [y, y + 1) like the truncation of cv::Point
+    if (antialias)
+    {
+        const Vector c(center.x - 0.5, center.y - 0.5);
+        FillCapsuleAA(c, c, (radius == 0) ? 0.5 : radius, colour);
+        return;
+    }
+
+    const int cx = PixelOf(center.x), cy = PixelOf(center.y);
+    const std::vector<int>& spans = CircleSpans(radius);
+    for (int dy = -radius; dy <= radius; ++dy)
+    {
+        const int w = spans[std::abs(dy)];
+        FillSpan(cy + dy, cx - w, cx + w, colour);
+    }
+}
+
+void SpanRasterizer::DrawLine(const Vector& start, const Vector& end, const int width, const Colour& colour)
+{
+    if (width <= 0)
+        return;
+
+    const double rho = LineHalfWidth(width);
+
+    if (antialias)
+    {
+        FillCapsuleAA(Vector(start.x - 0.5, start.y - 0.5), Vector(end.x - 0.5, end.y - 0.5), rho, colour);
+        return;
+    }
+
+    const int ax = PixelOf(start.x), ay = PixelOf(start.y);
+    const int bx = PixelOf(end.x), by = PixelOf(end.y);
+
+    // a one pixel wide line steps along its major axis like Bresenham's algorithm
+    if (width == 1)
+    {
+        const int n = std::max(std::abs(bx - ax), std::abs(by - ay));
+        for (int i = 0; i <= n; ++i)
+        {
+            const int x = ax + ((n == 0) ? 0 : static_cast<int>(std::lround(static_cast<double>(i) * (bx - ax) / n)));
+            const int y = ay + ((n == 0) ? 0 : static_cast<int>(std::lround(static_cast<double>(i) * (by - ay) / n)));
+            FillSpan(y, x, x, colour);
+        }
+
+        return;
+    }
+
+    // like cv::line: a rectangle along the segment (in sub-pixels) and a disc at both ends
+    const FixedPoint p0{static_cast<std::int64_t>(ax) << XY_SHIFT, static_cast<std::int64_t>(ay) << XY_SHIFT};
+    const FixedPoint p1{static_cast<std::int64_t>(bx) << XY_SHIFT, static_cast<std::int64_t>(by) << XY_SHIFT};
+    const double dx = ax - bx, dy = by - ay;
+    const double length2 = dx * dx + dy * dy;
+    if (length2 > 0)
+    {
+        const double r = rho * XY_ONE / std::sqrt(length2);
+        const FixedPoint offset{std::llrint(dy * r), std::llrint(dx * r)};
+        FillPolygonSolid({{p0.x + offset.x, p0.y + offset.y}, {p0.x - offset.x, p0.y - offset.y}, {p1.x - offset.x, p1.y - offset.y}, {p1.x + offset.x, p1.y + offset.y}}, colour);
+    }
+
+    FillCircle(Vector(ax, ay), static_cast<int>(rho), colour);
+    FillCircle(Vector(bx, by), static_cast<int>(rho), colour);
+}
+
+void SpanRasterizer::FillConvexPolygon(const std::vector<Vector>& points, const Colour& colour)
+{
+    if (antialias)
+    {
+        std::vector<Vector> vertices(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            vertices[i] = Vector(points[i].x - 0.5, points[i].y - 0.5);
+        }
+
+        FillPolygonAA(vertices, colour);
+        return;
+    }
+
+    std::vector<FixedPoint> vertices(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        vertices[i] = FixedPoint{static_cast<std::int64_t>(PixelOf(points[i].x)) << XY_SHIFT, static_cast<std::int64_t>(PixelOf(points[i].y)) << XY_SHIFT};
+    }
+
+    FillPolygonSolid(vertices, colour);
+}
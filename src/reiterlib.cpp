@@ -0,0 +1,313 @@
+#include "coordinate/reiterlib.hpp"
+
+#include <algorithm>    // std::min, std::max, std::sort
+#include <numeric>  // std::iota
+#include <utility>  // std::swap
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#include "coordinate/vectorlib.hpp"
+#include "helper/profilelib.hpp"
+#include "helper/threadlib.hpp"
+
+// the number of cells updated at a time
+#define REITER_LANES 8
+
+// the water at which a cell freezes
+#define REITER_FROZEN 1.0f
+
+// the active region reaches this many cells (and as far again as the crystal) beyond the crystal
+#define REITER_ACTIVE_MARGIN 32
+
+/// @brief The neighbours of a cell in axial coordinates
+static const int NEIGHBOURS[6][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, -1}, {-1, 1}};
+
+#if defined(__AVX2__)
+
+/// @brief Updates a run of cells of a row, 8 at a time (AVX2)
+/// @note the sums are in the same order as in the scalar tail
+static int UpdateLanes(const float* up, const float* row, const float* down, const float* s, const float* d, float* out, float* outU, const int count, const float c0, const float c1, const float gamma)
+{
+    const __m256 vc0 = _mm256_set1_ps(c0), vc1 = _mm256_set1_ps(c1), vgamma = _mm256_set1_ps(gamma), one = _mm256_set1_ps(1.0f);
+    int i = 0;
+    for (; i + REITER_LANES <= count; i += REITER_LANES)
+    {
+        __m256 sum = _mm256_add_ps(_mm256_loadu_ps(row + i - 1), _mm256_loadu_ps(row + i + 1));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(up + i));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(up + i + 1));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(down + i - 1));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(down + i));
+
+        const __m256 self = _mm256_loadu_ps(s + i), selfD = _mm256_loadu_ps(d + i);
+        const __m256 kept = _mm256_mul_ps(_mm256_sub_ps(one, selfD), _mm256_add_ps(self, vgamma));
+        const __m256 diffused = _mm256_add_ps(_mm256_mul_ps(vc0, _mm256_loadu_ps(row + i)), _mm256_mul_ps(vc1, sum));
+        const __m256 result = _mm256_add_ps(diffused, kept);
+        _mm256_storeu_ps(out + i, result);
+        _mm256_storeu_ps(outU + i, _mm256_mul_ps(result, selfD));
+    }
+
+    return i;
+}
+
+#else
+
+/// @brief Leaves the whole row to the scalar loop, which the compiler vectorizes with SSE2 or NEON
+static int UpdateLanes(const float*, const float*, const float*, const float*, const float*, float*, float*, const int, const float, const float, const float)
+{
+    return 0;
+}
+
+#endif
+
+/// @brief Updates a run of cells of a row
+/// @param up the diffusing water of the cells above (row r - 1) from the column of the first cell
+/// @param row the diffusing water of the cells of the row from the first cell
+/// @param down the diffusing water of the cells below (row r + 1) from the column of the first cell
+/// @param s the water of the cells of the row
+/// @param d whether the cells of the row diffuse
+/// @param out the next water of the cells of the row
+/// @param outU the next diffusing water of the cells of the row
+/// @param count the number of cells
+/// @param c0 the weight of the cell
+/// @param c1 the weight of each neighbour
+/// @param gamma the water added to the receptive cells
+/// @note the outputs never overlap the inputs, which lets the compiler vectorize the loop
+static void UpdateRun(const float* up, const float* row, const float* down, const float* s, const float* d, float* __restrict out, float* __restrict outU, const int count, const float c0, const float c1, const float gamma)
+{
+    for (int i = UpdateLanes(up, row, down, s, d, out, outU, count, c0, c1, gamma); i < count; ++i)
+    {
+        float sum = row[i - 1] + row[i + 1];
+        sum = sum + up[i];
+        sum = sum + up[i + 1];
+        sum = sum + down[i - 1];
+        sum = sum + down[i];
+
+        const float kept = (1.0f - d[i]) * (s[i] + gamma);
+        const float result = (c0 * row[i] + c1 * sum) + kept;
+        out[i] = result;
+        outU[i] = result * d[i];
+    }
+}
+
+ReiterLattice::ReiterLattice(const int radius, const float alpha, const float beta, const float gamma) : radius(std::max(radius, 2)), alpha(alpha), beta(beta), gamma(gamma)
+{
+    // the rows -1 to radius / 2 + 1 of the columns -2 to radius + 1, padded to whole lanes
+    numRows = this->radius / 2 + 3;
+    width = (this->radius + 4 + REITER_LANES - 1) / REITER_LANES * REITER_LANES;
+    const std::size_t numCells = static_cast<std::size_t>(numRows) * width;
+    s.assign(numCells, beta);
+    next.assign(numCells, beta);
+    u.assign(numCells, beta);
+    nextU.assign(numCells, beta);
+    diffusing.assign(numCells, 1.0f);
+    frozen.assign(numCells, 0);
+
+    // the ghost cells next to the edges of the sector and the cells they mirror
+    auto addGhost = [&](const int q, const int r)
+    {
+        const auto [sq, sr] = Fold(q, r);
+        if (sq + sr <= this->radius)
+            ghosts.emplace_back(IndexOf(q, r), IndexOf(sq, sr)), ghostRings.push_back(sq + sr);
+    };
+    for (int q = -2; q <= this->radius + 1; ++q)
+    {
+        addGhost(q, -1);
+    }
+    for (int r = 0; r < numRows - 1; ++r)
+    {
+        for (int q = std::max(r - 2, -2); q < r; ++q)
+        {
+            addGhost(q, r);
+        }
+    }
+
+    // orders the ghosts by the distance of their sources, so a step only copies the ones of the active region
+    std::vector<std::size_t> order(ghosts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return ghostRings[a] < ghostRings[b]; });
+    std::vector<std::pair<std::size_t, std::size_t>> sortedGhosts(ghosts.size());
+    std::vector<int> sortedRings(ghosts.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        sortedGhosts[i] = ghosts[order[i]];
+        sortedRings[i] = ghostRings[order[i]];
+    }
+    ghosts = std::move(sortedGhosts);
+    ghostRings = std::move(sortedRings);
+
+    // freezes the center
+    s[IndexOf(0, 0)] = REITER_FROZEN;
+    frozen[IndexOf(0, 0)] = 1;
+    MakeReceptive(0, 0);
+    for (const auto& neighbour : NEIGHBOURS)
+    {
+        const auto [q, r] = Fold(neighbour[0], neighbour[1]);
+        MakeReceptive(q, r);
+    }
+
+    for (std::size_t i = 0; i < ghosts.size() && ghostRings[i] <= active + 1; ++i)
+    {
+        u[ghosts[i].first] = u[ghosts[i].second];
+    }
+}
+
+std::pair<int, int> ReiterLattice::Fold(int q, int r)
+{
+    // tries the six rotations of the cell and of its mirror image
+    for (int mirror = 0; mirror < 2; ++mirror)
+    {
+        for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+        {
+            if (0 <= r && r <= q)
+                return {q, r};
+
+            // rotates by 60°
+            const int rotated = -r;
+            r = q + r;
+            q = rotated;
+        }
+
+        std::swap(q, r);
+    }
+
+    return {q, r};
+}
+
+std::size_t ReiterLattice::IndexOf(const int q, const int r) const
+{
+    return static_cast<std::size_t>(r + 1) * width + (q + 2);
+}
+
+float ReiterLattice::State(const int q, const int r) const
+{
+    const auto [sq, sr] = Fold(q, r);
+    return (sq + sr <= radius) ? s[IndexOf(sq, sr)] : beta;
+}
+
+bool ReiterLattice::IsFrozen(const int q, const int r) const
+{
+    const auto [sq, sr] = Fold(q, r);
+    return (sq + sr <= radius) && frozen[IndexOf(sq, sr)];
+}
+
+void ReiterLattice::MakeReceptive(const int q, const int r)
+{
+    const std::size_t index = IndexOf(q, r);
+    if (diffusing[index] == 0.0f)
+        return;
+
+    diffusing[index] = 0.0f;
+    u[index] = 0.0f;
+    if (!frozen[index])
+        boundary.emplace_back(q, r);
+}
+
+void ReiterLattice::UpdateRows(const int first, const int last)
+{
+    // u' = u + alpha / 2 * (mean of the neighbours - u)
+    const float c0 = 1.0f - 0.5f * alpha, c1 = alpha / 12.0f;
+    for (int r = first; r < last; ++r)
+    {
+        // the cells of the sector inside the active region
+        const int count = active - 2 * r;
+        const std::size_t row = IndexOf(r, r), up = IndexOf(r, r - 1), down = IndexOf(r, r + 1);
+        UpdateRun(&u[up], &u[row], &u[down], &s[row], &diffusing[row], &next[row], &nextU[row], count, c0, c1, gamma);
+    }
+}
+
+void ReiterLattice::FinishStep()
+{
+    s.swap(next);
+    u.swap(nextU);
+    ++numSteps;
+
+    // freezes the boundary cells that have reached 1 and makes their neighbours receptive
+    std::vector<std::pair<int, int>> freezing;
+    auto itr = std::partition(boundary.begin(), boundary.end(), [&](const std::pair<int, int>& cell) { return s[IndexOf(cell.first, cell.second)] < REITER_FROZEN; });
+    freezing.assign(itr, boundary.end());
+    boundary.erase(itr, boundary.end());
+    for (const auto& [q, r] : freezing)
+    {
+        frozen[IndexOf(q, r)] = 1;
+        frozenRadius = std::max(frozenRadius, q + r);
+        for (const auto& neighbour : NEIGHBOURS)
+        {
+            const auto [nq, nr] = Fold(q + neighbour[0], r + neighbour[1]);
+            if (nq + nr < radius)
+                MakeReceptive(nq, nr);
+        }
+    }
+
+    // the water spreads by a cell per step, so the cells further than the number of steps still hold beta
+    active = std::max(active, std::min({radius, numSteps + 2, 2 * frozenRadius + REITER_ACTIVE_MARGIN}));
+
+    for (std::size_t i = 0; i < ghosts.size() && ghostRings[i] <= active + 1; ++i)
+    {
+        u[ghosts[i].first] = u[ghosts[i].second];
+    }
+}
+
+int ReiterLattice::Run(const double maturity, const int maxSteps, unsigned int numJobs)
+{
+    PROFILE_SCOPE("run reiter automaton");
+    const int mature = std::max(1, static_cast<int>(maturity * radius));
+    auto isDone = [&]() { return frozenRadius >= std::min(mature, radius - 1) || numSteps >= maxSteps; };
+    auto numActiveRows = [&]() { return (active + 1) / 2; };
+
+    numJobs = std::max(1u, std::min(numJobs, static_cast<unsigned int>(numRows)));
+    if (numJobs == 1)
+    {
+        while (!isDone())
+        {
+            UpdateRows(0, numActiveRows());
+            FinishStep();
+        }
+
+        return numSteps;
+    }
+
+    // splits the active rows into bands of about as many cells
+    std::vector<int> bands(numJobs + 1);
+    auto split = [&]()
+    {
+        const int rows = numActiveRows();
+        const long long total = static_cast<long long>(rows) * (active - rows + 1);
+        long long cells = 0;
+        int r = 0;
+        for (unsigned int job = 0; job < numJobs; ++job)
+        {
+            bands[job] = r;
+            while (r < rows && cells * numJobs < total * job + total)
+            {
+                cells += active - 2 * r;
+                ++r;
+            }
+        }
+        bands[numJobs] = rows;
+    };
+
+    // every thread updates its band, then one thread finishes the step while the others wait
+    // NOTE: there is one task per thread, so all of them meet at the barrier
+    SpinBarrier barrier(numJobs);
+    bool done = isDone();
+    split();
+    ParallelFor(numJobs, numJobs, [&](unsigned int job)
+    {
+        while (!done)
+        {
+            UpdateRows(bands[job], bands[job + 1]);
+            barrier.ArriveAndWait();
+            if (job == 0)
+            {
+                FinishStep();
+                done = isDone();
+                split();
+            }
+            barrier.ArriveAndWait();
+        }
+    });
+
+    return numSteps;
+}
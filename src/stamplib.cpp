@@ -0,0 +1,196 @@
+#include "graph/stamplib.hpp"
+
+#include <algorithm>    // std::min, std::max
+#include <cmath>    // std::floor, std::ceil, std::sqrt, std::abs
+#include <cstdint>  // std::uint32_t
+#include <tuple>    // std::tie
+
+#include "graph/rasterlib.hpp"
+#include "graph/displaylistlib.hpp"
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+#include "helper/profilelib.hpp"
+
+// the empty pixels around a mask, which keep the rounded sizes of the scaled primitives inside it
+#define STAMP_MARGIN 2
+
+// two scales closer than this (relative) share a mask
+#define STAMP_SCALE_TOLERANCE 1e-6
+
+Stamp::Stamp(const DisplayList& shape) : shape(shape)
+{
+    // the box around every primitive (and around the boxes of the stamps inside)
+    bool isEmpty = true;
+    auto include = [&](const Vector& p, const double margin)
+    {
+        const Vector lo = p - Vector(margin, margin), hi = p + Vector(margin, margin);
+        lower = isEmpty ? lo : Vector(std::min(lower.x, lo.x), std::min(lower.y, lo.y));
+        upper = isEmpty ? hi : Vector(std::max(upper.x, hi.x), std::max(upper.y, hi.y));
+        isEmpty = false;
+    };
+
+    for (const DrawCommand& command : shape.Commands())
+    {
+        const Vector* p = shape.PointsOf(command);
+        switch (command.op)
+        {
+        case DrawOp::Circle:
+            include(p[0], command.size + 1);
+            break;
+        case DrawOp::Line:
+            include(p[0], LineHalfWidth(std::max(command.size, 1)) + 1);
+            include(p[1], LineHalfWidth(std::max(command.size, 1)) + 1);
+            break;
+        case DrawOp::Polygon:
+            for (std::uint32_t k = 0; k < command.count; ++k)
+            {
+                include(p[k], 1);
+            }
+            break;
+        case DrawOp::Replicate:
+            break;
+        case DrawOp::Stamp:
+        {
+            const Stamp& inner = *shape.Stamps()[command.size];
+            const Mat2 transform = shape.TransformOf(command);
+            for (const Vector& corner : {inner.Lower(), Vector(inner.Upper().x, inner.Lower().y), inner.Upper(), Vector(inner.Lower().x, inner.Upper().y)})
+            {
+                include(transform * corner + p[0], 0);
+            }
+            break;
+        }
+        }
+    }
+}
+
+std::size_t Stamp::MaskBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t bytes = 0;
+    for (const Mask& mask : masks)
+    {
+        bytes += mask.coverage.size();
+    }
+    return bytes;
+}
+
+std::pair<int, int> Stamp::MaskSize(const double scale, Vector& origin) const
+{
+    origin = Vector(std::floor(scale * lower.x) - STAMP_MARGIN, std::floor(scale * lower.y) - STAMP_MARGIN);
+    const int cols = static_cast<int>(std::ceil(scale * upper.x) - origin.x) + STAMP_MARGIN + 1;
+    const int rows = static_cast<int>(std::ceil(scale * upper.y) - origin.y) + STAMP_MARGIN + 1;
+    return {rows, cols};
+}
+
+const Stamp::Mask& Stamp::MaskOf(const double scale, const bool antialias) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Mask& mask : masks)
+    {
+        if (mask.antialias == antialias && std::abs(mask.scale - scale) <= STAMP_SCALE_TOLERANCE * scale)
+            return mask;
+    }
+
+    // rasterizes the shape (and the stamps inside it) once for this scale
+    PROFILE_SCOPE("rasterize stamp");
+    Mask& mask = masks.emplace_back();
+    mask.scale = scale;
+    mask.antialias = antialias;
+    std::tie(mask.rows, mask.cols) = MaskSize(scale, mask.origin);
+    mask.coverage.assign(static_cast<std::size_t>(mask.rows) * mask.cols, 0);
+
+    RasterBuffer buffer;
+    buffer.data = mask.coverage.data();
+    buffer.rows = mask.rows;
+    buffer.cols = mask.cols;
+    buffer.channels = 1;
+    buffer.step = static_cast<std::size_t>(mask.cols);
+    SpanRasterizer rasterizer(buffer, antialias);
+    shape.Execute(rasterizer, scale, mask.origin);
+
+    return mask;
+}
+
+void Stamp::Draw(Rasterizer& target, const Mat2& transform, const Vector& offset, const Colour& colour, const bool antialias) const
+{
+    const double scale = std::sqrt(std::abs(transform.a * transform.d - transform.b * transform.c));
+    Vector origin;
+    const auto [rows, cols] = MaskSize(scale, origin);
+    if (static_cast<double>(rows) * cols <= STAMP_MAX_MASK_BYTES)
+    {
+        Blit(target.Pixels(), transform, offset, colour, antialias);
+        return;
+    }
+
+    // the stamps inside the shape get their own masks if they are small enough
+    PROFILE_SCOPE("expand stamp");
+    shape.Execute(target, transform, offset, colour);
+}
+
+/// @brief Interpolates the coverage of a mask at the point u (the center of the pixel (i, j) is at (i + 0.5, j + 0.5))
+static unsigned int Interpolate(const std::vector<unsigned char>& coverage, const int rows, const int cols, const Vector& u)
+{
+    const double x = u.x - 0.5, y = u.y - 0.5;
+    const int i = static_cast<int>(std::floor(x)), j = static_cast<int>(std::floor(y));
+    const double wx = x - i, wy = y - j;
+    auto at = [&](const int col, const int row) -> double
+    {
+        return (col < 0 || row < 0 || col >= cols || row >= rows) ? 0.0 : coverage[static_cast<std::size_t>(row) * cols + col];
+    };
+
+    const double value = (1 - wy) * ((1 - wx) * at(i, j) + wx * at(i + 1, j)) + wy * ((1 - wx) * at(i, j + 1) + wx * at(i + 1, j + 1));
+    return static_cast<unsigned int>(value + 0.5);
+}
+
+void Stamp::Blit(const RasterBuffer& pixels, const Mat2& transform, const Vector& offset, const Colour& colour, const bool antialias) const
+{
+    const double det = transform.a * transform.d - transform.b * transform.c;
+    if (!pixels.data || det == 0.0)
+        return;
+
+    const double scale = std::sqrt(std::abs(det));
+    const Mask& mask = MaskOf(scale, antialias);
+
+    // the box of the copy on the canvas
+    double x0 = 0.0, x1 = 0.0, y0 = 0.0, y1 = 0.0;
+    const Vector corners[] = {Vector(0, 0), Vector(mask.cols, 0), Vector(mask.cols, mask.rows), Vector(0, mask.rows)};
+    for (int k = 0; k < 4; ++k)
+    {
+        const Vector corner = transform * ((1.0 / scale) * (corners[k] + mask.origin)) + offset;
+        x0 = (k == 0) ? corner.x : std::min(x0, corner.x);
+        x1 = (k == 0) ? corner.x : std::max(x1, corner.x);
+        y0 = (k == 0) ? corner.y : std::min(y0, corner.y);
+        y1 = (k == 0) ? corner.y : std::max(y1, corner.y);
+    }
+    const int first = std::max(static_cast<int>(std::floor(x0)), 0), last = std::min(static_cast<int>(std::ceil(x1)), pixels.cols - 1);
+    const int top = std::max(static_cast<int>(std::floor(y0)), 0), bottom = std::min(static_cast<int>(std::ceil(y1)), pixels.rows - 1);
+    if (first > last || top > bottom)
+        return;
+
+    // the center of the pixel (x, y) of the canvas is at inverse * ((x, y) + 0.5 - offset) - origin in the mask, where
+    // inverse = scale * transform^-1 keeps the lengths, so the nearest pixel of the mask is the one it falls in
+    const Mat2 inverse{scale * transform.d / det, -scale * transform.b / det, -scale * transform.c / det, scale * transform.a / det};
+    const unsigned char bytes[3] = {colour.b, colour.g, colour.r};
+    const int channels = std::min(pixels.channels, 3);
+    for (int y = top; y <= bottom; ++y)
+    {
+        unsigned char* row = pixels.data + y * pixels.step;
+        Vector u = inverse * (Vector(first + 0.5, y + 0.5) - offset) - mask.origin;
+        for (int x = first; x <= last; ++x, u.x += inverse.a, u.y += inverse.c)
+        {
+            if (u.x < 0.0 || u.y < 0.0 || u.x >= mask.cols || u.y >= mask.rows)
+                continue;
+
+            const unsigned int coverage = antialias ? Interpolate(mask.coverage, mask.rows, mask.cols, u) : mask.coverage[static_cast<std::size_t>(u.y) * mask.cols + static_cast<std::size_t>(u.x)];
+            if (!coverage)
+                continue;
+
+            // paints the pixel by its coverage (solid masks are fully covered or empty)
+            unsigned char* p = row + static_cast<std::size_t>(x) * pixels.channels;
+            for (int k = 0; k < channels; ++k)
+            {
+                p[k] = static_cast<unsigned char>((p[k] * (255 - coverage) + bytes[k] * coverage + 127) / 255);
+            }
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#include "helper/streamlib.hpp"
+
+#include <cerrno>   // errno
+#include <cstdint>  // UINT32_MAX
+#include <cstring>  // std::strerror
+#include <string>
+#include <vector>
+
+FrameStream::~FrameStream()
+{
+    std::string error;
+    Close(error);
+}
+
+bool FrameStream::IsKind(const std::string& kind)
+{
+    return kind == "raw" || kind == "y4m" || kind == "frames";
+}
+
+bool FrameStream::Open(const std::string& path, const std::string& kind, std::string& error)
+{
+    if (!IsKind(kind))
+    {
+        error = "unknown stream " + kind;
+        return false;
+    }
+
+    file = (path == "-") ? stdout : std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    // NOTE: a large buffer turns the rows into a few big writes to the pipe
+    std::setvbuf(file, nullptr, _IOFBF, STREAM_BUFFER_SIZE);
+    this->path = path;
+    this->kind = kind;
+    rows = cols = channels = 0;
+    numFrames = 0;
+    return true;
+}
+
+bool FrameStream::WriteFrame(const unsigned char* data, const int rows, const int cols, const int channels, const std::size_t step, std::string& error)
+{
+    if (numFrames == 0)
+    {
+        this->rows = rows;
+        this->cols = cols;
+        this->channels = channels;
+
+        if (kind == "y4m")
+        {
+            const std::string header = "YUV4MPEG2 W" + std::to_string(cols) + " H" + std::to_string(rows) + " F" + std::to_string(STREAM_FRAME_RATE)
+                                     + ":1 Ip A1:1 " + (channels == 1 ? "Cmono" : "C444 XCOLORRANGE=LIMITED") + "\n";
+            if (!Write(header.data(), header.size(), error))
+                return false;
+        }
+    }
+    else if (rows != this->rows || cols != this->cols || channels != this->channels)
+    {
+        error = path + ": the frames of a " + kind + " stream must have the same size";
+        return false;
+    }
+
+    const std::size_t rowSize = static_cast<std::size_t>(cols) * channels;
+    if (kind == "y4m")
+    {
+        if (!Write("FRAME\n", 6, error))
+            return false;
+    }
+
+    // writes the pixels straight from the canvas (a mono Y4M frame is its Y plane)
+    if (kind == "raw" || channels == 1)
+    {
+        if (step == rowSize && !Write(data, rowSize * rows, error))
+            return false;
+
+        for (int y = 0; step != rowSize && y < rows; ++y)
+        {
+            if (!Write(data + y * step, rowSize, error))
+                return false;
+        }
+
+        ++numFrames;
+        return true;
+    }
+
+    // converts B, G, R to the Y, U and V planes (BT.601 limited range in integers)
+    const std::size_t planeSize = static_cast<std::size_t>(rows) * cols;
+    planes.resize(3 * planeSize);
+    unsigned char* yPlane = planes.data();
+    unsigned char* uPlane = yPlane + planeSize;
+    unsigned char* vPlane = uPlane + planeSize;
+    for (int y = 0; y < rows; ++y)
+    {
+        const unsigned char* pixel = data + y * step;
+        const std::size_t offset = static_cast<std::size_t>(y) * cols;
+        for (int x = 0; x < cols; ++x, pixel += 3)
+        {
+            const int b = pixel[0], g = pixel[1], r = pixel[2];
+            yPlane[offset + x] = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            uPlane[offset + x] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[offset + x] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    if (!Write(planes.data(), planes.size(), error))
+        return false;
+
+    ++numFrames;
+    return true;
+}
+
+bool FrameStream::WriteEncoded(const std::vector<unsigned char>& bytes, std::string& error)
+{
+    if (bytes.size() > UINT32_MAX)
+    {
+        error = path + ": a frame is too large for its length";
+        return false;
+    }
+
+    const std::uint32_t size = static_cast<std::uint32_t>(bytes.size());
+    const unsigned char length[4] = {static_cast<unsigned char>(size), static_cast<unsigned char>(size >> 8), static_cast<unsigned char>(size >> 16), static_cast<unsigned char>(size >> 24)};
+    if (!Write(length, sizeof(length), error) || !Write(bytes.data(), bytes.size(), error))
+        return false;
+
+    ++numFrames;
+    return true;
+}
+
+bool FrameStream::Close(std::string& error)
+{
+    if (!file)
+        return true;
+
+    const bool isFlushed = std::fflush(file) == 0;
+    if (!isFlushed)
+        error = "cannot write " + path + ": " + std::strerror(errno);
+    if (file != stdout)
+        std::fclose(file);
+    file = nullptr;
+    return isFlushed;
+}
+
+bool FrameStream::Write(const void* data, const std::size_t size, std::string& error)
+{
+    if (std::fwrite(data, 1, size, file) != size)
+    {
+        error = "cannot write " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,225 @@
+#include "graph/svglib.hpp"
+
+#include <cstdio>   // std::snprintf
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "graph/displaylistlib.hpp"
+#include "graph/rasterlib.hpp"
+#include "graph/stamplib.hpp"
+#include "coordinate/vectorlib.hpp"
+#include "coordinate/symmetrylib.hpp"
+#include "helper/filelib.hpp"
+
+// the number of significant digits of the coordinates
+#define COORD_PRECISION 6
+
+// colours
+#define WHITE Colour(255, 255, 255)
+#define LIGHT_SKY_BLUE Colour(153, 204, 255)
+
+// the font size of the label (about the size of the label of PutLabel)
+#define LABEL_FONT_SIZE 24
+
+/// @brief Get the hex code of a colour, e.g. #ffffff
+static std::string ToHex(const Colour& colour)
+{
+    char hex[8];
+    std::snprintf(hex, sizeof(hex), "#%02x%02x%02x", colour.r, colour.g, colour.b);
+    return hex;
+}
+
+/// @brief Checks if a colour is white (the default colour of the elements)
+static bool IsWhite(const Colour& colour)
+{
+    return colour.r == 255 && colour.g == 255 && colour.b == 255;
+}
+
+/// @brief Escapes the characters that are special in XML
+static std::string EscapeXml(const std::string& text)
+{
+    std::string escaped;
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '&': escaped += "&amp;"; break;
+        case '<': escaped += "&lt;"; break;
+        case '>': escaped += "&gt;"; break;
+        case '"': escaped += "&quot;"; break;
+        default: escaped += c; break;
+        }
+    }
+
+    return escaped;
+}
+
+/// @brief The ids of the groups of the stamps
+using StampIds = std::map<const Stamp*, std::string>;
+
+/// @brief Writes a command that draws something (not Replicate)
+static void WriteElement(std::ostream& out, const DisplayList& list, const DrawCommand& command, const StampIds& ids)
+{
+    const Vector* p = list.PointsOf(command);
+    switch (command.op)
+    {
+    case DrawOp::Stamp:
+    {
+        // SVG matrices are given column by column
+        const Mat2 m = list.TransformOf(command);
+        out << "<use href=\"#" << ids.at(list.Stamps()[command.size].get()) << "\" transform=\"matrix(" << m.a << " " << m.c << " " << m.b << " " << m.d << " " << p[0].x << " " << p[0].y << ")\"";
+        if (!IsWhite(command.colour))
+            out << " fill=\"" << ToHex(command.colour) << "\" stroke=\"" << ToHex(command.colour) << "\"";
+        out << "/>\n";
+        break;
+    }
+    case DrawOp::Circle:
+        // NOTE: a circle of radius 0 is still one pixel on the raster backends
+        out << "<circle cx=\"" << p[0].x << "\" cy=\"" << p[0].y << "\" r=\"" << ((command.size > 0) ? command.size : 0.5) << "\"";
+        if (!IsWhite(command.colour))
+            out << " fill=\"" << ToHex(command.colour) << "\"";
+        out << "/>\n";
+        break;
+    case DrawOp::Line:
+        if (command.size <= 0)
+            break;
+        out << "<line x1=\"" << p[0].x << "\" y1=\"" << p[0].y << "\" x2=\"" << p[1].x << "\" y2=\"" << p[1].y << "\" stroke-width=\"" << 2 * LineHalfWidth(command.size) << "\"";
+        if (!IsWhite(command.colour))
+            out << " stroke=\"" << ToHex(command.colour) << "\"";
+        out << "/>\n";
+        break;
+    case DrawOp::Polygon:
+        out << "<polygon points=\"";
+        for (std::uint32_t i = 0; i < command.count; ++i)
+        {
+            out << (i ? " " : "") << p[i].x << "," << p[i].y;
+        }
+        out << "\"";
+        if (!IsWhite(command.colour))
+            out << " fill=\"" << ToHex(command.colour) << "\"";
+        out << "/>\n";
+        break;
+    default:
+        break;
+    }
+}
+
+/// @brief Writes a group in <defs> for every stamp of a list (after the stamps inside it), so every copy is a <use>
+static void WriteStamps(std::ostream& out, const DisplayList& list, StampIds& ids)
+{
+    for (const auto& stamp : list.Stamps())
+    {
+        if (ids.count(stamp.get()))
+            continue;
+
+        WriteStamps(out, stamp->Shape(), ids);
+        const std::string id = "stamp" + std::to_string(ids.size());
+        out << "<defs><g id=\"" << id << "\">\n";
+        for (const DrawCommand& command : stamp->Shape().Commands())
+        {
+            WriteElement(out, stamp->Shape(), command, ids);
+        }
+        out << "</g></defs>\n";
+        ids[stamp.get()] = id;
+    }
+}
+
+/// @brief Writes one <use> per element of the symmetry group (rotations about the center of the canvas, then mirrors)
+static void WriteReplicas(std::ostream& out, const std::string& id, const Symmetry& symmetry, const double cx, const double cy)
+{
+    for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+    {
+        out << "<use href=\"#" << id << "\"";
+        if (rotation)
+            out << " transform=\"rotate(" << 360 / NUM_ARMS * rotation << " " << cx << " " << cy << ")\"";
+        out << "/>\n";
+    }
+
+    if (!symmetry.dihedral)
+        return;
+
+    // the mirror along the axis through the center
+    const Vector& a = symmetry.axis;
+    const double m11 = a.x * a.x - a.y * a.y, m12 = 2 * a.x * a.y;
+    for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+    {
+        out << "<use href=\"#" << id << "\" transform=\"";
+        if (rotation)
+            out << "rotate(" << 360 / NUM_ARMS * rotation << " " << cx << " " << cy << ") ";
+        out << "matrix(" << m11 << " " << m12 << " " << m12 << " " << -m11 << " " << cx - m11 * cx - m12 * cy << " " << cy - m12 * cx + m11 * cy << ")\"/>\n";
+    }
+}
+
+bool WriteSvg(std::ostream& out, const DisplayList& list, const std::string& label)
+{
+    const int cols = list.Cols(), rows = list.Rows();
+    const double cx = cols / 2, cy = rows / 2;
+    out.precision(COORD_PRECISION);
+
+    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << cols << "\" height=\"" << rows << "\" viewBox=\"0 0 " << cols << " " << rows << "\">\n";
+    out << "<rect width=\"100%\" height=\"100%\" fill=\"#000000\"/>\n";
+
+    // white by default; lines are strokes with round caps like the raster backends
+    out << "<g fill=\"" << ToHex(WHITE) << "\" stroke=\"" << ToHex(WHITE) << "\" stroke-width=\"0\" stroke-linecap=\"round\">\n";
+
+    // the stamps are defined once
+    StampIds ids;
+    WriteStamps(out, list, ids);
+
+    // every run of commands that ends with a Replicate command becomes a group that is placed for every element of the symmetry group
+    const auto& commands = list.Commands();
+    std::size_t begin = 0;
+    int numGroups = 0;
+    while (begin < commands.size())
+    {
+        std::size_t end = begin;
+        while (end < commands.size() && commands[end].op != DrawOp::Replicate)
+        {
+            ++end;
+        }
+
+        if (end == commands.size())
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                WriteElement(out, list, commands[i], ids);
+            }
+
+            break;
+        }
+
+        const std::string id = "wedge" + std::to_string(numGroups++);
+        out << "<defs><g id=\"" << id << "\">\n";
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            WriteElement(out, list, commands[i], ids);
+        }
+        out << "</g></defs>\n";
+        WriteReplicas(out, id, list.Symmetries()[commands[end].first], cx, cy);
+
+        begin = end + 1;
+    }
+
+    out << "</g>\n";
+
+    if (!label.empty())
+        out << "<text x=\"" << cx << "\" y=\"" << 50 + LABEL_FONT_SIZE / 2 << "\" fill=\"" << ToHex(LIGHT_SKY_BLUE) << "\" font-family=\"monospace\" font-size=\"" << LABEL_FONT_SIZE << "\" text-anchor=\"middle\">" << EscapeXml(label) << "</text>\n";
+
+    out << "</svg>\n";
+
+    return static_cast<bool>(out);
+}
+
+bool SaveSvg(const std::string& filename, const DisplayList& list, const std::string& label)
+{
+    // checks if the folder exists
+    std::filesystem::path p(filename);
+    if (!std::filesystem::exists(p.parent_path()))
+        return false;
+
+    std::ofstream file;
+    return OpenNewFile(file, filename) && WriteSvg(file, list, label);
+}
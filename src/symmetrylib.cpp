@@ -0,0 +1,35 @@
+#include "coordinate/symmetrylib.hpp"
+
+#include <cmath>    // std::sqrt, std::fabs
+#include <algorithm>    // std::min
+
+#include "coordinate/vectorlib.hpp"
+
+Symmetry::Symmetry(const Vector& axis, const bool dihedral) : axis(axis.Unit()), dihedral(dihedral) {}
+
+double Symmetry::DistanceToWedge(const Vector& p) const
+{
+    // coordinates along and across the axis
+    const double u = p.x * axis.x + p.y * axis.y;
+    const double w = p.y * axis.x - p.x * axis.y;
+
+    // the second edge of the wedge
+    const double cosEdge = dihedral ? SQRT3_OVER_2 : 0.5;
+    const double sinEdge = dihedral ? 0.5 : SQRT3_OVER_2;
+    const double cross = cosEdge * w - sinEdge * u;
+
+    // inside the wedge
+    if (w >= 0 && cross <= 0)
+        return 0.0;
+
+    // the closest point is on one of the two edges (or the apex)
+    const double norm = std::sqrt(u * u + w * w);
+    const double toFirst = (u >= 0) ? std::fabs(w) : norm;
+    const double toSecond = (cosEdge * u + sinEdge * w >= 0) ? std::fabs(cross) : norm;
+    return std::min(toFirst, toSecond);
+}
+
+bool Symmetry::Touches(const Vector& c, const double r) const
+{
+    return DistanceToWedge(c) <= r;
+}
@@ -0,0 +1,88 @@
+#include "graph/tilelib.hpp"
+
+#include <algorithm>    // std::min, std::max
+#include <cmath>    // std::lround
+#include <cstddef>  // std::size_t
+#include <map>
+#include <string>
+#include <utility>  // std::move
+
+#include "graph/displaylistlib.hpp"
+#include "graph/rasterlib.hpp"
+#include "coordinate/vectorlib.hpp"
+#include "helper/pipelinelib.hpp"
+#include "helper/pnglib.hpp"
+#include "helper/poollib.hpp"
+
+/// @brief A rasterized strip of the image on its way to the file
+struct Strip
+{
+    int index = 0;
+    int numRows = 0;
+    BufferPool::Handle pixels;
+};
+
+bool RenderTiledPng(const DisplayList& list, const int size, const int channels, const bool antialias, const std::string& filename, const unsigned int numJobs, std::string& error)
+{
+    if (size <= 0 || list.Cols() <= 0 || (channels != 1 && channels != 3))
+    {
+        error = filename + ": invalid image size";
+        return false;
+    }
+
+    const double scale = static_cast<double>(size) / list.Cols();
+    const int rows = std::max(1, static_cast<int>(std::lround(list.Rows() * scale)));
+    const int cols = size;
+    const std::size_t step = static_cast<std::size_t>(cols) * channels;
+    const int stripRows = static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(rows, STRIP_BYTES / step)));
+    const int numStrips = (rows + stripRows - 1) / stripRows;
+
+    PngWriter writer;
+    if (!writer.Open(filename, rows, cols, channels, error))
+        return false;
+
+    // the workers rasterize the strips and the consumer writes them in order
+    // NOTE: a strip that is done early waits in the map, and its buffer goes back to the pool once it has been written
+    BufferPool strips(stripRows * step);
+    std::map<int, Strip> pending;
+    int next = 0;
+    Pipeline<int, Strip> pipeline(numJobs, 2 * numJobs,
+        [&](int& index, Strip& strip, std::string&)
+        {
+            strip.index = index;
+            strip.numRows = std::min(stripRows, rows - index * stripRows);
+            strip.pixels = strips.Acquire();
+
+            RasterBuffer buffer;
+            buffer.data = strip.pixels.Data();
+            buffer.rows = strip.numRows;
+            buffer.cols = cols;
+            buffer.channels = channels;
+            buffer.step = step;
+            SpanRasterizer canvas(buffer, antialias);
+            list.Execute(canvas, scale, Vector(0, index * stripRows));
+            return true;
+        },
+        [&](Strip& strip, std::string& message)
+        {
+            pending.emplace(strip.index, std::move(strip));
+            for (auto itr = pending.find(next); itr != pending.end(); itr = pending.find(next))
+            {
+                if (!writer.WriteRows(itr->second.pixels.Data(), itr->second.numRows, step, message))
+                    return false;
+                pending.erase(itr);
+                ++next;
+            }
+            return true;
+        });
+
+    for (int index = 0; index < numStrips && pipeline.Submit(index); ++index) {}
+
+    if (!pipeline.Finish())
+    {
+        error = pipeline.Errors().front();
+        return false;
+    }
+
+    return writer.Close(error);
+}
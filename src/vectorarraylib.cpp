@@ -0,0 +1,86 @@
+#include "coordinate/vectorarraylib.hpp"
+
+#include <cmath>    // std::cos, std::sin
+
+#include "coordinate/vectorlib.hpp"
+
+/// @brief The kernel of all bulk transforms
+/// @note in and out may be the same arrays since every point only depends on itself
+static void Transform(const Mat2& m, const double* inX, const double* inY, double* outX, double* outY, const std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const double px = inX[i], py = inY[i];
+        outX[i] = m.a * px + m.b * py;
+        outY[i] = m.c * px + m.d * py;
+    }
+}
+
+Mat2 Mat2::Rotation(const double theta)
+{
+    const double c = std::cos(theta), s = std::sin(theta);
+    return Mat2{c, -s, s, c};
+}
+
+Mat2 Mat2::ArmRotation(const int k)
+{
+    const Vector root = Vector::RotateArm(Vector(1, 0), k);
+    return Mat2{root.x, -root.y, root.y, root.x};
+}
+
+Mat2 Mat2::Reflection(const Vector& axis)
+{
+    // 2 * w * w^T / |w|^2 - I
+    const double n = axis.x * axis.x + axis.y * axis.y;
+    const double xx = axis.x * axis.x / n, yy = axis.y * axis.y / n, xy = axis.x * axis.y / n;
+    return Mat2{xx - yy, 2 * xy, 2 * xy, yy - xx};
+}
+
+Mat2 Mat2::operator*(const Mat2& other) const
+{
+    return Mat2{a * other.a + b * other.c, a * other.b + b * other.d, c * other.a + d * other.c, c * other.b + d * other.d};
+}
+
+Vector Mat2::operator*(const Vector& v) const
+{
+    return Vector(a * v.x + b * v.y, c * v.x + d * v.y);
+}
+
+VectorArray::VectorArray(const std::size_t n) : x(n), y(n) {}
+
+VectorArray::VectorArray(const std::vector<Vector>& points) : x(points.size()), y(points.size())
+{
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+    }
+}
+
+void VectorArray::PushBack(const Vector& v)
+{
+    x.push_back(v.x);
+    y.push_back(v.y);
+}
+
+void VectorArray::RotateAll(const double theta)
+{
+    TransformAll(Mat2::Rotation(theta));
+}
+
+void VectorArray::MirrorAll(const Vector& axis)
+{
+    TransformAll(Mat2::Reflection(axis));
+}
+
+void VectorArray::TransformAll(const Mat2& m)
+{
+    Transform(m, x.data(), y.data(), x.data(), y.data(), Size());
+}
+
+void VectorArray::TransformTo(const Mat2& m, VectorArray& out) const
+{
+    out.x.resize(Size());
+    out.y.resize(Size());
+    Transform(m, x.data(), y.data(), out.x.data(), out.y.data(), Size());
+}
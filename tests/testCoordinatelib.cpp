@@ -1,10 +1,18 @@
 #define CATCH_CONFIG_MAIN
 
 #include <cmath>   // round, sqrt
+#include <algorithm>    // std::min
+#include <vector>
 #include <catch2/catch.hpp>
 
 #include "coordinate/vectorlib.hpp"
 #include "coordinate/generatorlib.hpp"
+#include "coordinate/symmetrylib.hpp"
+#include "coordinate/vectorarraylib.hpp"
+#include "coordinate/gridlib.hpp"
+#include "coordinate/dlalib.hpp"
+#include "coordinate/reiterlib.hpp"
+#include "math/mathlib.hpp"
 
 #define PI 3.14159265
 
@@ -199,6 +207,38 @@ TEST_CASE( "Coordinate", "Vector" )
         REQUIRE (v7.Magnitude() == Approx(l));
     }
 
+    SECTION("Rotate a Vector by Arms")
+    {
+        const Vector v(3.5, -1.25);
+        for (int k = -NUM_ARMS; k <= NUM_ARMS; k++)
+        {
+            auto ret = Vector::RotateArm(v, k);
+            auto ans = Vector::Rotate(v, k * 60 * PI / 180);
+            REQUIRE (ret.x == Approx(ans.x));
+            REQUIRE (ret.y == Approx(ans.y));
+        }
+
+        // the table is exact at compile time
+        static_assert(Vector::RotateArm(Vector(1, 0), 3) == Vector(-1, 0));
+        static_assert(Vector::RotateArm(Vector(2, 0), -NUM_ARMS) == Vector(2, 0));
+        static_assert(Vector::Mirror(Vector(1, 2), Vector(1, 0)) == Vector(1, -2));
+        for (const auto& root : SIXTH_ROOTS_OF_UNITY<double>)
+        {
+            REQUIRE (root.Magnitude() == Approx(1));
+        }
+    }
+
+    SECTION("Single Precision")
+    {
+        const Vector2f f(2.5f, -4.0f);
+        const Vector d(f);
+        REQUIRE (d == Vector(2.5, -4.0));
+        REQUIRE (Vector2f(d) == f);
+        REQUIRE ((2 * f).x == 5.0f);
+        REQUIRE (Vector2f::RotateArm(f, 2).x == Approx(Vector::RotateArm(d, 2).x));
+        REQUIRE (f.ToString() == std::string("(2.5, -4)"));
+    }
+
     SECTION("Projecting a Vector Along Another Vector")
     {
         constexpr double x7 = 10, y7 = 10;
@@ -270,3 +310,240 @@ TEST_CASE( "GeneratorLib", "Generator" )
         REQUIRE (d == Approx(r.Magnitude()));
     }
 }
+
+TEST_CASE( "SymmetryLib", "Symmetry" )
+{
+    SECTION("Distance to the Wedge")
+    {
+        const Symmetry g(Vector(1, 0), true);
+
+        // inside, on the far side of the first edge and beyond the apex
+        REQUIRE (g.DistanceToWedge(Vector(10, 1)) == Approx(0.0));
+        REQUIRE (g.DistanceToWedge(Vector(10, -3)) == Approx(3.0));
+        REQUIRE (g.DistanceToWedge(Vector(-3, -4)) == Approx(5.0));
+
+        // above the 30° edge
+        auto p = Vector::Rotate(Vector(10, 0), 50 * PI / 180);
+        REQUIRE (g.DistanceToWedge(p) == Approx(10 * sin(20 * PI / 180)));
+        REQUIRE (g.Touches(p, 3.5));
+        REQUIRE_FALSE (g.Touches(p, 3.0));
+    }
+}
+
+TEST_CASE( "VectorArrayLib", "VectorArray" )
+{
+    std::vector<Vector> points;
+    for (int i = 0; i < 37; i++)
+    {
+        points.push_back(Vector(1.5 * i - 20, 0.25 * i * i - 3));
+    }
+    const VectorArray original(points);
+    const Vector axis(0.97, 1.01);
+    constexpr double theta = 60 * PI / 180;
+
+    SECTION("Rotating All Points")
+    {
+        VectorArray arr = original;
+        arr.RotateAll(theta);
+        REQUIRE (arr.Size() == points.size());
+        for (std::size_t i = 0; i < points.size(); i++)
+        {
+            auto ans = Vector::Rotate(points[i], theta);
+            REQUIRE (arr.x[i] == Approx(ans.x));
+            REQUIRE (arr.y[i] == Approx(ans.y));
+        }
+    }
+
+    SECTION("Mirroring All Points")
+    {
+        VectorArray arr = original;
+        arr.MirrorAll(axis);
+        for (std::size_t i = 0; i < points.size(); i++)
+        {
+            auto ans = Vector::Mirror(points[i], axis);
+            REQUIRE (arr[i].x == Approx(ans.x));
+            REQUIRE (arr[i].y == Approx(ans.y));
+        }
+    }
+
+    SECTION("Composing Transforms")
+    {
+        // mirrors first, then rotates
+        const Mat2 m = Mat2::Rotation(theta) * Mat2::Reflection(axis);
+        VectorArray arr;
+        original.TransformTo(m, arr);
+        for (std::size_t i = 0; i < points.size(); i++)
+        {
+            auto ans = Vector::Rotate(Vector::Mirror(points[i], axis), theta);
+            REQUIRE (arr[i].x == Approx(ans.x));
+            REQUIRE (arr[i].y == Approx(ans.y));
+
+            // the single point version
+            auto ret = m * points[i];
+            REQUIRE (ret.x == Approx(ans.x));
+            REQUIRE (ret.y == Approx(ans.y));
+        }
+
+        // the source stays the same
+        REQUIRE (original[5] == points[5]);
+    }
+}
+
+TEST_CASE( "GridLib", "SpatialGrid" )
+{
+    // points all over the grid and a few outside of it
+    RandomEngine rng(3);
+    SpatialGrid grid(100, 10);
+    for (int i = 0; i < 500; ++i)
+    {
+        grid.Insert(Vector(260 * rng.Uniform() - 130, 260 * rng.Uniform() - 130));
+    }
+
+    SECTION("Finds Every Point Within the Radius")
+    {
+        for (const Vector& center : {Vector(0, 0), Vector(-95, 42.5), Vector(99, 99), Vector(125, -120)})
+        {
+            for (const double radius : {3.0, 10.0, 37.5})
+            {
+                int expected = 0;
+                double nearest = radius;
+                for (const Vector& point : grid.Points())
+                {
+                    const double distance = point.Distance(center);
+                    expected += (distance < radius) ? 1 : 0;
+                    nearest = std::min(nearest, distance);
+                }
+
+                int found = 0;
+                grid.ForEachNear(center, radius, [&](std::size_t i)
+                {
+                    found += (grid.Point(i).Distance(center) < radius) ? 1 : 0;
+                    return true;
+                });
+                REQUIRE (found == expected);
+                REQUIRE (grid.NearestDistance(center, radius) == Approx(nearest));
+            }
+        }
+    }
+
+    SECTION("Stops When Asked")
+    {
+        int visited = 0;
+        grid.ForEachNear(Vector(0, 0), 200, [&](std::size_t) { return ++visited < 5; });
+        REQUIRE (visited == 5);
+    }
+
+    SECTION("Can Be Reused")
+    {
+        grid.Clear();
+        REQUIRE (grid.Size() == 0);
+        REQUIRE (grid.NearestDistance(Vector(0, 0), 50) == Approx(50));
+
+        REQUIRE (grid.Insert(Vector(1, 1)) == 0);
+        REQUIRE (grid.NearestDistance(Vector(0, 0), 50) == Approx(std::sqrt(2.0)));
+    }
+}
+
+TEST_CASE( "DlaLib", "DLA" )
+{
+    const Vector mirror(1, 0.9);
+    const double radius = 1.5;
+    RandomEngine rng(11);
+    const std::vector<Vector> particles = GenerateDlaCluster(400, radius, 400, mirror, rng, 4);
+
+    SECTION("Sticks Every Particle")
+    {
+        REQUIRE (particles.size() == 400);
+        REQUIRE (particles[0] == Vector(0, 0));
+    }
+
+    SECTION("Is the Same for Any Number of Jobs")
+    {
+        RandomEngine other(11);
+        REQUIRE (GenerateDlaCluster(400, radius, 400, mirror, other, 1) == particles);
+    }
+
+    SECTION("Touches Without Overlapping")
+    {
+        // every particle touches an earlier one (or one of its images), and none overlaps another one
+        SpatialGrid images(500, 2 * radius);
+        images.Insert(particles[0]);
+        for (std::size_t i = 1; i < particles.size(); ++i)
+        {
+            const double nearest = images.NearestDistance(particles[i], 4 * radius);
+            REQUIRE (nearest >= 2 * radius);
+            REQUIRE (nearest < 2.5 * radius);
+
+            for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+            {
+                images.Insert(Vector::RotateArm(particles[i], rotation));
+                images.Insert(Vector::RotateArm(Vector::Mirror(particles[i], mirror), rotation));
+            }
+        }
+    }
+
+    SECTION("Stops at the Largest Radius")
+    {
+        RandomEngine other(11);
+        const std::vector<Vector> small = GenerateDlaCluster(100000, radius, 60, mirror, other, 4);
+        REQUIRE (small.size() < 100000);
+        for (const Vector& p : small)
+        {
+            REQUIRE (p.Magnitude() < 60 + 3 * radius);
+        }
+    }
+}
+
+TEST_CASE( "ReiterLib", "Reiter" )
+{
+    ReiterLattice lattice(60, 1.0f, 0.4f, 0.001f);
+    const int steps = lattice.Run(0.8, 5000);
+
+    SECTION("Folds Into the Sector")
+    {
+        for (int q = -10; q <= 10; ++q)
+        {
+            for (int r = -10; r <= 10; ++r)
+            {
+                const auto [sq, sr] = ReiterLattice::Fold(q, r);
+                REQUIRE (0 <= sr);
+                REQUIRE (sr <= sq);
+                REQUIRE (2 * (sq + sr) == std::abs(q) + std::abs(r) + std::abs(q + r));
+            }
+        }
+    }
+
+    SECTION("Grows a Mature Crystal")
+    {
+        REQUIRE (steps < 5000);
+        REQUIRE (lattice.FrozenRadius() >= 48);
+        REQUIRE (lattice.IsFrozen(0, 0));
+        REQUIRE (!lattice.IsFrozen(lattice.Radius(), 0));
+    }
+
+    SECTION("Keeps the Symmetry of a Snowflake")
+    {
+        // the rotations by 60° and the mirror image of every cell
+        for (int q = -30; q <= 30; ++q)
+        {
+            for (int r = -30; r <= 30; ++r)
+            {
+                REQUIRE (lattice.State(q, r) == lattice.State(-r, q + r));
+                REQUIRE (lattice.State(q, r) == lattice.State(r, q));
+            }
+        }
+    }
+
+    SECTION("Is the Same for Any Number of Jobs")
+    {
+        ReiterLattice other(60, 1.0f, 0.4f, 0.001f);
+        REQUIRE (other.Run(0.8, 5000, 3) == steps);
+        for (int q = -60; q <= 60; ++q)
+        {
+            for (int r = -60; r <= 60; ++r)
+            {
+                REQUIRE (other.State(q, r) == lattice.State(q, r));
+            }
+        }
+    }
+}
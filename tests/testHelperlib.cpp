@@ -1,8 +1,33 @@
 #define CATCH_CONFIG_MAIN
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include <catch2/catch.hpp>
 
 #include "helper/fmtlib.hpp"
+#include "helper/threadlib.hpp"
+#include "helper/pipelinelib.hpp"
+#include "helper/filelib.hpp"
+#include "helper/poollib.hpp"
+#include "helper/pnglib.hpp"
+#include "helper/packlib.hpp"
+#include "helper/jsonlib.hpp"
+#include "helper/profilelib.hpp"
+#include "helper/cachelib.hpp"
+#include "helper/streamlib.hpp"
+
+#include <zlib.h>
 
 TEST_CASE( "Formatter", "[main]" )
 {
@@ -21,4 +46,602 @@ TEST_CASE( "Formatter", "[main]" )
         REQUIRE (Formatter(x, p) == "1.123");
         REQUIRE (Formatter(y, p) == "125.1");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "ParallelFor", "[main]" )
+{
+    constexpr unsigned int NUM_TASKS = 1000;
+
+    SECTION("Runs Every Task Exactly Once")
+    {
+        for (unsigned int numJobs : {1u, 4u, 2 * NUM_TASKS})
+        {
+            std::vector<std::atomic<int>> visited(NUM_TASKS);
+            ParallelFor(NUM_TASKS, numJobs, [&](unsigned int i) { ++visited[i]; });
+
+            for (const auto& cnt : visited)
+            {
+                REQUIRE (cnt == 1);
+            }
+        }
+    }
+
+    SECTION("Rethrows the Error of a Task")
+    {
+        REQUIRE_THROWS_AS (ParallelFor(NUM_TASKS, 4, [](unsigned int i) { if (i == 42) throw std::runtime_error("42"); }), std::runtime_error);
+    }
+}
+
+TEST_CASE( "BoundedQueue", "[main]" )
+{
+    SECTION("First In First Out")
+    {
+        BoundedQueue<int> queue(4);
+        REQUIRE (queue.Push(1));
+        REQUIRE (queue.Push(2));
+
+        int item = 0;
+        REQUIRE (queue.Pop(item));
+        REQUIRE (item == 1);
+        REQUIRE (queue.Pop(item));
+        REQUIRE (item == 2);
+    }
+
+    SECTION("Drains after Being Closed")
+    {
+        BoundedQueue<int> queue(4);
+        queue.Push(1);
+        queue.Close();
+        REQUIRE_FALSE (queue.Push(2));
+
+        int item = 0;
+        REQUIRE (queue.Pop(item));
+        REQUIRE (item == 1);
+        REQUIRE_FALSE (queue.Pop(item));
+    }
+
+    SECTION("Passes Every Item through a Small Queue in Order")
+    {
+        constexpr int NUM_ITEMS = 1000;
+        BoundedQueue<int> queue(2);
+        std::thread producer([&]()
+        {
+            for (int i = 0; i < NUM_ITEMS; ++i)
+            {
+                queue.Push(i);
+            }
+            queue.Close();
+        });
+
+        std::vector<int> items;
+        int item = 0;
+        while (queue.Pop(item))
+        {
+            items.push_back(item);
+        }
+        producer.join();
+
+        REQUIRE (items.size() == NUM_ITEMS);
+        for (int i = 0; i < NUM_ITEMS; ++i)
+        {
+            REQUIRE (items[i] == i);
+        }
+    }
+}
+
+TEST_CASE( "Pipeline", "[main]" )
+{
+    constexpr int NUM_ITEMS = 200;
+    auto square = [](int& in, long& out, std::string&) { out = static_cast<long>(in) * in; return true; };
+
+    SECTION("Consumes Every Item Exactly Once")
+    {
+        long sum = 0;
+        Pipeline<int, long> pipeline(4, 3, square, [&](long& out, std::string&) { sum += out; return true; });
+        for (int i = 0; i < NUM_ITEMS; ++i)
+        {
+            REQUIRE (pipeline.Submit(i));
+        }
+
+        REQUIRE (pipeline.Finish());
+        REQUIRE (sum == static_cast<long>(NUM_ITEMS - 1) * NUM_ITEMS * (2 * NUM_ITEMS - 1) / 6);
+        REQUIRE (pipeline.Errors().empty());
+    }
+
+    SECTION("Reports Failures and Exceptions")
+    {
+        auto fail = [](int& in, long&, std::string& error) { error = "odd " + std::to_string(in); return false; };
+        auto panic = [](int&, long&, std::string&) -> bool { throw std::runtime_error("unlucky"); };
+        auto full = [](long&, std::string& error) { error = "full"; return false; };
+        auto ignore = [](long&, std::string&) { return true; };
+
+        Pipeline<int, long> failing(2, 2, fail, ignore);
+        REQUIRE (failing.Submit(7));
+        REQUIRE_FALSE (failing.Finish());
+        REQUIRE (failing.Errors() == std::vector<std::string>({"odd 7"}));
+        REQUIRE_FALSE (failing.Submit(8));
+
+        Pipeline<int, long> throwing(2, 2, panic, ignore);
+        throwing.Submit(7);
+        REQUIRE_FALSE (throwing.Finish());
+        REQUIRE (throwing.Errors() == std::vector<std::string>({"unlucky"}));
+
+        Pipeline<int, long> consuming(2, 2, square, full);
+        consuming.Submit(7);
+        REQUIRE_FALSE (consuming.Finish());
+        REQUIRE (consuming.Errors() == std::vector<std::string>({"full"}));
+    }
+
+    SECTION("Keeps the Number of Items in Flight Bounded")
+    {
+        constexpr unsigned int NUM_WORKERS = 3;
+        constexpr std::size_t CAPACITY = 2;
+        std::atomic<int> consumed{0};
+        int maxInFlight = 0;
+        Pipeline<int, long> pipeline(NUM_WORKERS, CAPACITY, square, [&](long&, std::string&)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            ++consumed;
+            return true;
+        });
+        for (int i = 0; i < NUM_ITEMS; ++i)
+        {
+            pipeline.Submit(i);
+            maxInFlight = std::max(maxInFlight, i + 1 - consumed);
+        }
+
+        REQUIRE (pipeline.Finish());
+        REQUIRE (consumed == NUM_ITEMS);
+        REQUIRE (maxInFlight <= static_cast<int>(2 * CAPACITY + NUM_WORKERS + 1));
+    }
+}
+
+TEST_CASE( "WriteFile", "[main]" )
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::vector<unsigned char> bytes = {0, 1, 2, 255, 'a'};
+    std::string error;
+
+    SECTION("Writes the Bytes")
+    {
+        const std::string filename = (dir / "testHelperlib-WriteFile.bin").string();
+        REQUIRE (WriteFile(filename, bytes, error));
+
+        std::ifstream file(filename, std::ios::binary);
+        const std::vector<unsigned char> read((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        REQUIRE (read == bytes);
+        std::filesystem::remove(filename);
+    }
+
+    SECTION("Reports a Missing Folder")
+    {
+        REQUIRE_FALSE (WriteFile((dir / "no-such-folder" / "file.bin").string(), bytes, error));
+        REQUIRE_FALSE (error.empty());
+    }
+}
+
+TEST_CASE( "BufferPool", "[main]" )
+{
+    constexpr std::size_t SIZE = 1 << 16;
+    BufferPool pool(SIZE);
+
+    SECTION("Recycles Zeroed Buffers")
+    {
+        unsigned char* data = nullptr;
+        {
+            BufferPool::Handle buffer = pool.Acquire();
+            REQUIRE (buffer.Size() == SIZE);
+            REQUIRE (std::all_of(buffer.Data(), buffer.Data() + SIZE, [](unsigned char c) { return c == 0; }));
+
+            data = buffer.Data();
+            std::fill(data, data + SIZE, 255);
+        }
+
+        BufferPool::Handle buffer = pool.Acquire();
+        REQUIRE (buffer.Data() == data);
+        REQUIRE (std::all_of(buffer.Data(), buffer.Data() + SIZE, [](unsigned char c) { return c == 0; }));
+        REQUIRE (pool.NumAllocated() == 1);
+
+        buffer.Reset();
+        REQUIRE (buffer.Size() == 0);
+        REQUIRE (pool.Acquire().Data() == data);
+    }
+
+    SECTION("Moves Buffers between Handles")
+    {
+        BufferPool::Handle first = pool.Acquire();
+        unsigned char* data = first.Data();
+        BufferPool::Handle second = std::move(first);
+        REQUIRE (second.Data() == data);
+
+        first = pool.Acquire();
+        second = std::move(first);
+        REQUIRE (pool.NumAllocated() == 2);
+        second.Reset();
+
+        BufferPool::Handle a = pool.Acquire(), b = pool.Acquire();
+        REQUIRE (pool.NumAllocated() == 2);
+    }
+
+    SECTION("Only Grows to the Peak Number of Buffers in Use")
+    {
+        constexpr unsigned int NUM_JOBS = 4;
+        ParallelFor(1000, NUM_JOBS, [&](unsigned int i)
+        {
+            BufferPool::Handle buffer = pool.Acquire();
+            buffer.Data()[i % SIZE] = 1;
+        });
+
+        REQUIRE (pool.NumAllocated() <= NUM_JOBS);
+    }
+}
+
+/// @brief Reads a big-endian 32-bit integer
+static std::uint32_t GetUint32(const unsigned char* in)
+{
+    return (std::uint32_t(in[0]) << 24) | (std::uint32_t(in[1]) << 16) | (std::uint32_t(in[2]) << 8) | std::uint32_t(in[3]);
+}
+
+TEST_CASE( "PngWriter", "[main]" )
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "testHelperlib-PngWriter.png").string();
+    constexpr int ROWS = 7, COLS = 5;
+    std::string error;
+
+    SECTION("Streams Rows into a Valid File")
+    {
+        // B, G, R pixels with 2 bytes of padding per row
+        constexpr std::size_t STEP = 3 * COLS + 2;
+        std::vector<unsigned char> pixels(ROWS * STEP);
+        for (std::size_t i = 0; i < pixels.size(); ++i)
+        {
+            pixels[i] = static_cast<unsigned char>(i * 7);
+        }
+
+        PngWriter writer;
+        REQUIRE (writer.Open(filename, ROWS, COLS, 3, error));
+        REQUIRE (writer.WriteRows(pixels.data(), 3, STEP, error));
+        REQUIRE (writer.WriteRows(pixels.data() + 3 * STEP, ROWS - 3, STEP, error));
+        REQUIRE (writer.RowsWritten() == ROWS);
+        REQUIRE (writer.Close(error));
+
+        std::ifstream file(filename, std::ios::binary);
+        const std::vector<unsigned char> png((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        REQUIRE (png.size() > 8);
+        REQUIRE (png[1] == 'P');
+
+        // walks the chunks, checks their CRCs and collects the compressed data
+        std::vector<std::string> types;
+        std::vector<unsigned char> compressed;
+        for (std::size_t pos = 8; pos + 12 <= png.size();)
+        {
+            const std::uint32_t size = GetUint32(&png[pos]);
+            const unsigned char* chunk = &png[pos + 4];
+            REQUIRE (GetUint32(chunk + 4 + size) == crc32(0L, chunk, 4 + size));
+
+            types.emplace_back(reinterpret_cast<const char*>(chunk), 4);
+            if (types.back() == "IHDR")
+            {
+                REQUIRE (GetUint32(chunk + 4) == COLS);
+                REQUIRE (GetUint32(chunk + 8) == ROWS);
+                REQUIRE (chunk[13] == 2);
+            }
+            if (types.back() == "IDAT")
+                compressed.insert(compressed.end(), chunk + 4, chunk + 4 + size);
+            pos += 12 + size;
+        }
+        REQUIRE (types.front() == "IHDR");
+        REQUIRE (types.back() == "IEND");
+
+        // every row is the filter byte 0 and the pixels as R, G, B
+        std::vector<unsigned char> expected;
+        for (int y = 0; y < ROWS; ++y)
+        {
+            expected.push_back(0);
+            for (int x = 0; x < COLS; ++x)
+            {
+                const unsigned char* p = &pixels[y * STEP + 3 * x];
+                expected.insert(expected.end(), {p[2], p[1], p[0]});
+            }
+        }
+
+        std::vector<unsigned char> raw(expected.size());
+        uLongf rawSize = raw.size();
+        REQUIRE (uncompress(raw.data(), &rawSize, compressed.data(), compressed.size()) == Z_OK);
+        REQUIRE (rawSize == expected.size());
+        REQUIRE (raw == expected);
+        std::filesystem::remove(filename);
+    }
+
+    SECTION("Reports Missing Rows")
+    {
+        const std::vector<unsigned char> row(COLS, 255);
+        PngWriter writer;
+        REQUIRE (writer.Open(filename, ROWS, COLS, 1, error));
+        REQUIRE (writer.WriteRows(row.data(), 1, 0, error));
+        REQUIRE_FALSE (writer.WriteRows(row.data(), ROWS, 0, error));
+        REQUIRE_FALSE (writer.Close(error));
+        REQUIRE_FALSE (error.empty());
+        std::filesystem::remove(filename);
+    }
+}
+
+TEST_CASE( "Pack Files", "[main]" )
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "testHelperlib-Pack.pack").string();
+    const std::vector<std::vector<unsigned char>> contents = {{1, 2, 3}, {}, std::vector<unsigned char>(1000, 'x')};
+    std::string error;
+
+    PackWriter writer;
+    REQUIRE (writer.Open(filename, error));
+    for (std::size_t i = 0; i < contents.size(); ++i)
+    {
+        REQUIRE (writer.Append("file_" + std::to_string(i), contents[i], error));
+    }
+    REQUIRE (writer.Close(error));
+
+    SECTION("Reads Every Entry Back by Index")
+    {
+        PackReader reader;
+        REQUIRE (reader.Open(filename, error));
+        REQUIRE (reader.Size() == contents.size());
+
+        // in any order
+        std::vector<unsigned char> bytes;
+        for (std::size_t i : {2, 0, 1})
+        {
+            REQUIRE (reader.Read(i, bytes, error));
+            REQUIRE (bytes == contents[i]);
+            REQUIRE (reader.Entries()[i].name == "file_" + std::to_string(i));
+        }
+
+        REQUIRE_FALSE (reader.Read(contents.size(), bytes, error));
+        REQUIRE_FALSE (error.empty());
+    }
+
+    SECTION("Rejects an Incomplete File")
+    {
+        std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 1);
+        PackReader reader;
+        REQUIRE_FALSE (reader.Open(filename, error));
+        REQUIRE_FALSE (error.empty());
+    }
+
+    std::filesystem::remove(filename);
+}
+
+TEST_CASE( "JsonWriter", "[main]" )
+{
+    std::ostringstream out;
+    JsonWriter json(out);
+
+    SECTION("Separates Nested Values")
+    {
+        json.BeginObject().Key("a").Value(1).Key("b").BeginArray().Value(0.5).Value(true).Value("x").BeginObject().EndObject().EndArray();
+        json.Key("c").BeginArray().EndArray().EndObject();
+        REQUIRE (out.str() == "{\"a\":1,\"b\":[0.5,true,\"x\",{}],\"c\":[]}");
+    }
+
+    SECTION("Escapes Strings and Writes Invalid Numbers as null")
+    {
+        json.BeginArray().Value("a \"b\"\\\n\x01").Value(std::numeric_limits<double>::infinity()).EndArray();
+        REQUIRE (out.str() == "[\"a \\\"b\\\"\\\\\\n\\u0001\",null]");
+    }
+
+    SECTION("Parses What It Writes")
+    {
+        json.BeginObject().Key("seed").Value(18446744073709551615ull).Key("x").Value(-0.125).Key("s").Value("a \"b\"\n\x01");
+        json.Key("a").BeginArray().Value(true).Value(false).BeginObject().EndObject().EndArray().EndObject();
+
+        JsonValue value;
+        std::string error;
+        REQUIRE (ParseJson(" " + out.str() + "\n", value, error));
+        REQUIRE (value.type == JsonValue::Type::Object);
+        REQUIRE (value.members.size() == 4);
+        REQUIRE (value.Find("seed")->text == "18446744073709551615");
+        REQUIRE (value.Find("x")->number == -0.125);
+        REQUIRE (value.Find("s")->text == "a \"b\"\n\x01");
+        REQUIRE (value.Find("a")->elements.size() == 3);
+        REQUIRE (value.Find("a")->elements[1].type == JsonValue::Type::Bool);
+        REQUIRE (value.Find("a")->elements[2].type == JsonValue::Type::Object);
+        REQUIRE (value.Find("missing") == nullptr);
+    }
+
+    SECTION("Rejects Invalid Documents")
+    {
+        JsonValue value;
+        std::string error;
+        for (const std::string& text : std::vector<std::string>{"", "{", "[1,]", "{\"a\" 1}", "\"abc", "nul", "1.2.3", "[] []", std::string(JSON_MAX_DEPTH + 2, '[')})
+        {
+            REQUIRE_FALSE (ParseJson(text, value, error));
+            REQUIRE_FALSE (error.empty());
+        }
+    }
+}
+
+TEST_CASE( "Profiler", "[main]" )
+{
+    // NOTE: the profiler is global, so the spans are only recorded once
+    Profiler::Enable();
+    REQUIRE (Profiler::IsEnabled());
+
+    ParallelFor(8, 4, [](unsigned int)
+    {
+        const std::int64_t started = Profiler::Now();
+        ScopedTimer timer("stage");
+        Profiler::RecordLatency("item", started);
+    });
+
+    ScopedTimer stopped("stopped");
+    stopped.Stop();
+    stopped.Stop();
+
+    auto count = [](const std::string& text, const std::string& pattern)
+    {
+        std::size_t n = 0;
+        for (std::size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        {
+            ++n;
+        }
+        return n;
+    };
+
+    // writes every span of every thread as a complete event
+    const std::string filename = (std::filesystem::temp_directory_path() / "testHelperlib-Trace.json").string();
+    std::string error;
+    REQUIRE (Profiler::WriteTrace(filename, error));
+    std::ifstream file(filename);
+    const std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    REQUIRE (trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+    REQUIRE (count(trace, "{\"name\":\"stage\",\"ph\":\"X\"") == 8);
+    REQUIRE (count(trace, "{\"name\":\"stopped\",\"ph\":\"X\"") == 1);
+    REQUIRE (count(trace, "\"thread_name\"") >= 1);
+    std::filesystem::remove(filename);
+
+    // sums up the latencies and the stages
+    std::ostringstream summary;
+    Profiler::PrintSummary(summary);
+    REQUIRE (summary.str().find("Profile: 8 items in ") == 0);
+    REQUIRE (summary.str().find("item latency") != std::string::npos);
+    REQUIRE (summary.str().find("stage") != std::string::npos);
+}
+
+TEST_CASE( "RenderCache", "[main]" )
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "testHelperlib-Cache";
+    const std::string filename = (std::filesystem::temp_directory_path() / "testHelperlib-Cache.bin").string();
+    std::filesystem::remove_all(directory);
+    std::string error, metadata;
+    std::vector<unsigned char> bytes;
+
+    RenderCache cache;
+    REQUIRE (cache.Open(directory.string(), 250, error));
+    REQUIRE (cache.Store("a", std::vector<unsigned char>(100, 'a'), "{\"x\":1}", error));
+    REQUIRE (WriteFile(filename, std::vector<unsigned char>(100, 'b'), error));
+    REQUIRE (cache.Store("b", filename, "", error));
+
+    SECTION("Fetches the Files and Their Metadata")
+    {
+        REQUIRE (cache.Fetch("a", bytes, metadata));
+        REQUIRE (bytes == std::vector<unsigned char>(100, 'a'));
+        REQUIRE (metadata == "{\"x\":1}");
+
+        // replaces the file
+        REQUIRE (WriteFile(filename, {1, 2, 3}, error));
+        REQUIRE (cache.Fetch("a", filename, metadata));
+        REQUIRE (std::filesystem::file_size(filename) == 100);
+
+        REQUIRE_FALSE (cache.Fetch("c", bytes, metadata));
+        REQUIRE (cache.Hits() == 2);
+        REQUIRE (cache.Misses() == 1);
+    }
+
+    SECTION("Does Not Write through the Links of Fetched Files")
+    {
+        REQUIRE (cache.Fetch("b", filename, metadata));
+        REQUIRE (WriteFile(filename, {1, 2, 3}, error));
+        REQUIRE (cache.Fetch("b", bytes, metadata));
+        REQUIRE (bytes == std::vector<unsigned char>(100, 'b'));
+
+        // the tiled images are streamed by the PNG writer instead
+        const std::vector<unsigned char> pixels(4, 0);
+        PngWriter writer;
+        REQUIRE (cache.Fetch("b", filename, metadata));
+        REQUIRE (writer.Open(filename, 2, 2, 1, error));
+        REQUIRE (writer.WriteRows(pixels.data(), 2, 2, error));
+        REQUIRE (writer.Close(error));
+        REQUIRE (cache.Fetch("b", bytes, metadata));
+        REQUIRE (bytes == std::vector<unsigned char>(100, 'b'));
+    }
+
+    SECTION("Evicts the Least Recently Used Files")
+    {
+        // "a" becomes more recent than "b"
+        REQUIRE (cache.Fetch("a", bytes, metadata));
+        REQUIRE (cache.Store("c", std::vector<unsigned char>(100, 'c'), "", error));
+        REQUIRE (cache.Size() == 200);
+        REQUIRE (cache.Fetch("a", bytes, metadata));
+        REQUIRE_FALSE (cache.Fetch("b", bytes, metadata));
+        REQUIRE (cache.Fetch("c", bytes, metadata));
+    }
+
+    SECTION("Keeps the Files of Closed Runs Only")
+    {
+        REQUIRE (cache.Close(error));
+
+        RenderCache next;
+        REQUIRE (next.Open(directory.string(), 250, error));
+        REQUIRE (next.Size() == 200);
+        REQUIRE (next.Store("c", std::vector<unsigned char>(10, 'c'), "", error));
+
+        // a run that does not close the cache leaves its files out of the index
+        RenderCache last;
+        REQUIRE (last.Open(directory.string(), 150, error));
+        REQUIRE (last.Size() == 100);
+        REQUIRE (last.Fetch("b", bytes, metadata));
+        REQUIRE_FALSE (last.Fetch("a", bytes, metadata));
+        REQUIRE_FALSE (last.Fetch("c", bytes, metadata));
+        REQUIRE (std::distance(std::filesystem::directory_iterator(directory / CACHE_OBJECTS_NAME), std::filesystem::directory_iterator()) == 1);
+    }
+
+    cache.Close(error);
+    std::filesystem::remove_all(directory);
+    std::filesystem::remove(filename);
+}
+
+TEST_CASE( "FrameStream", "[main]" )
+{
+    const std::string filename = (std::filesystem::temp_directory_path() / "testHelperlib-Stream.bin").string();
+    std::string error;
+
+    // a white 2x2 colour frame with a padded step
+    const std::vector<unsigned char> pixels = {255, 255, 255, 255, 255, 255, 0, 0, 255, 255, 255, 255, 255, 255, 0, 0};
+    auto read = [&filename]()
+    {
+        std::ifstream file(filename, std::ios::binary);
+        return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+
+    REQUIRE (FrameStream::IsKind("raw"));
+    REQUIRE_FALSE (FrameStream::IsKind("mp4"));
+
+    SECTION("Writes Raw Frames without Padding")
+    {
+        FrameStream stream;
+        REQUIRE (stream.Open(filename, "raw", error));
+        REQUIRE (stream.WriteFrame(pixels.data(), 2, 2, 3, 8, error));
+        REQUIRE (stream.WriteFrame(pixels.data(), 2, 2, 3, 8, error));
+        REQUIRE_FALSE (stream.WriteFrame(pixels.data(), 1, 2, 3, 8, error));
+        REQUIRE (stream.Close(error));
+        REQUIRE (stream.NumFrames() == 2);
+        REQUIRE (read() == std::vector<unsigned char>(24, 255));
+    }
+
+    SECTION("Writes Y4M Frames")
+    {
+        FrameStream stream;
+        REQUIRE (stream.Open(filename, "y4m", error));
+        REQUIRE (stream.WriteFrame(pixels.data(), 2, 2, 3, 8, error));
+        REQUIRE (stream.Close(error));
+
+        const std::string header = "YUV4MPEG2 W2 H2 F30:1 Ip A1:1 C444 XCOLORRANGE=LIMITED\nFRAME\n";
+        const std::vector<unsigned char> bytes = read();
+        REQUIRE (bytes.size() == header.size() + 12);
+        REQUIRE (std::string(bytes.begin(), bytes.begin() + header.size()) == header);
+
+        // white is Y = 235 and U = V = 128 in limited range
+        REQUIRE (std::vector<unsigned char>(bytes.begin() + header.size(), bytes.end()) == std::vector<unsigned char>{235, 235, 235, 235, 128, 128, 128, 128, 128, 128, 128, 128});
+    }
+
+    SECTION("Writes Length-Prefixed Frames")
+    {
+        FrameStream stream;
+        REQUIRE (stream.Open(filename, "frames", error));
+        REQUIRE (stream.WriteEncoded({1, 2, 3}, error));
+        REQUIRE (stream.WriteEncoded({}, error));
+        REQUIRE (stream.Close(error));
+        REQUIRE (read() == std::vector<unsigned char>{3, 0, 0, 0, 1, 2, 3, 0, 0, 0, 0});
+    }
+
+    std::filesystem::remove(filename);
+}
@@ -0,0 +1,655 @@
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>    // std::min
+#include <cmath>    // std::abs
+#include <cstring>  // std::memcmp
+#include <filesystem>
+#include <fstream>
+#include <memory>   // std::make_shared
+#include <sstream>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+
+#include "coordinate/vectorlib.hpp"
+#include "graph/rasterlib.hpp"
+#include "graph/displaylistlib.hpp"
+#include "graph/svglib.hpp"
+#include "graph/tilelib.hpp"
+#include "graph/stamplib.hpp"
+#include "coordinate/symmetrylib.hpp"
+#include "graph/graphlib.hpp"
+#include "math/mathlib.hpp"
+
+#define PI 3.14159265
+
+/// @brief A blank canvas for the tests
+struct TestCanvas
+{
+    std::vector<unsigned char> data;
+    RasterBuffer buffer;
+
+    TestCanvas(const int rows, const int cols, const int channels) : data(static_cast<std::size_t>(rows) * cols * channels, 0)
+    {
+        buffer.data = data.data();
+        buffer.rows = rows;
+        buffer.cols = cols;
+        buffer.channels = channels;
+        buffer.step = static_cast<std::size_t>(cols) * channels;
+    }
+
+    /// @brief The number of pixels that are not black
+    int CountLit() const
+    {
+        int count = 0;
+        for (std::size_t i = 0; i < data.size(); i += buffer.channels)
+        {
+            for (int c = 0; c < buffer.channels; ++c)
+            {
+                if (data[i + c] != 0)
+                {
+                    ++count;
+                    break;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    /// @brief The sum of the first channel divided by 255, i.e. the covered area
+    double Coverage() const
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < data.size(); i += buffer.channels)
+        {
+            sum += data[i];
+        }
+
+        return sum / 255.0;
+    }
+};
+
+// the expected pixel counts are the ones of the same primitives drawn by OpenCV
+
+TEST_CASE( "Native Rasterizer", "Solid" )
+{
+    const Colour white(255, 255, 255);
+
+    SECTION("Circles Match the Midpoint Spans of cv::circle")
+    {
+        const std::vector<std::pair<int, int>> expected = {{0, 1}, {1, 5}, {2, 13}, {5, 81}, {10, 317}, {37, 4293}};
+        for (const auto& [radius, count] : expected)
+        {
+            TestCanvas canvas(100, 100, 3);
+            SpanRasterizer rasterizer(canvas.buffer);
+            rasterizer.FillCircle(Vector(50, 50), radius, white);
+            REQUIRE (canvas.CountLit() == count);
+        }
+    }
+
+    SECTION("Circles Are Clipped to the Canvas")
+    {
+        TestCanvas canvas(20, 20, 1);
+        SpanRasterizer rasterizer(canvas.buffer);
+        rasterizer.FillCircle(Vector(0, 0), 5, white);
+        REQUIRE (canvas.CountLit() == 26);
+
+        rasterizer.FillCircle(Vector(-100, 300), 5, white);
+        REQUIRE (canvas.CountLit() == 26);
+    }
+
+    SECTION("Polygons Include Their Outline")
+    {
+        TestCanvas rectangle(20, 20, 3);
+        SpanRasterizer(rectangle.buffer).FillConvexPolygon({Vector(2, 2), Vector(6, 2), Vector(6, 5), Vector(2, 5)}, white);
+        REQUIRE (rectangle.CountLit() == 20);
+
+        TestCanvas triangle(100, 100, 3);
+        SpanRasterizer(triangle.buffer).FillConvexPolygon({Vector(10, 10), Vector(80, 20), Vector(40, 90)}, white);
+        REQUIRE (triangle.CountLit() == 2766);
+    }
+
+    SECTION("Lines")
+    {
+        TestCanvas thin(20, 20, 3);
+        SpanRasterizer(thin.buffer).DrawLine(Vector(2, 3), Vector(12, 3), 1, white);
+        REQUIRE (thin.CountLit() == 11);
+
+        TestCanvas thick(40, 40, 3);
+        SpanRasterizer(thick.buffer).DrawLine(Vector(10, 20), Vector(30, 20), 4, white);
+        REQUIRE (thick.CountLit() == 113);
+
+        TestCanvas empty(20, 20, 3);
+        SpanRasterizer(empty.buffer).DrawLine(Vector(2, 3), Vector(12, 3), 0, white);
+        REQUIRE (empty.CountLit() == 0);
+    }
+
+    SECTION("Only the Channels of the Canvas Are Written")
+    {
+        TestCanvas canvas(10, 10, 3);
+        SpanRasterizer(canvas.buffer).FillCircle(Vector(5, 5), 0, Colour(1, 2, 3));
+        const unsigned char* pixel = canvas.data.data() + 5 * canvas.buffer.step + 5 * 3;
+        REQUIRE (pixel[0] == 3);
+        REQUIRE (pixel[1] == 2);
+        REQUIRE (pixel[2] == 1);
+        REQUIRE (canvas.CountLit() == 1);
+    }
+}
+
+TEST_CASE( "Native Anti-Aliased Rasterizer", "Anti-Aliased" )
+{
+    const Colour white(255, 255, 255);
+
+    SECTION("Circle Coverage Is Close to the Area")
+    {
+        TestCanvas canvas(100, 100, 1);
+        SpanRasterizer(canvas.buffer, true).FillCircle(Vector(50.3, 49.6), 20, white);
+        REQUIRE (canvas.Coverage() == Approx(PI * 20 * 20).epsilon(0.01));
+    }
+
+    SECTION("Polygon Coverage Is Close to the Area")
+    {
+        TestCanvas canvas(100, 100, 1);
+        SpanRasterizer(canvas.buffer, true).FillConvexPolygon({Vector(10.5, 10.25), Vector(80.75, 20), Vector(40, 90.5)}, white);
+        const double area = std::abs((80.75 - 10.5) * (90.5 - 10.25) - (40 - 10.5) * (20 - 10.25)) / 2;
+        REQUIRE (canvas.Coverage() == Approx(area).epsilon(0.01));
+    }
+
+    SECTION("Line Coverage Is Close to the Area of the Capsule")
+    {
+        TestCanvas canvas(100, 100, 1);
+        SpanRasterizer(canvas.buffer, true).DrawLine(Vector(20, 30), Vector(70, 60), 6, white);
+        const double length = Vector(20, 30).Distance(Vector(70, 60));
+        REQUIRE (canvas.Coverage() == Approx(2 * 3 * length + PI * 3 * 3).epsilon(0.01));
+    }
+}
+
+TEST_CASE( "Display List", "DisplayList" )
+{
+    const Colour white(255, 255, 255);
+    auto draw = [&](Rasterizer& canvas)
+    {
+        canvas.FillCircle(Vector(30.7, 40.2), 9, Colour(10, 20, 30));
+        canvas.DrawLine(Vector(50, 50), Vector(60.5, 58.25), 5, white);
+        canvas.FillConvexPolygon({Vector(50, 45), Vector(58, 47), Vector(54, 56)}, white);
+    };
+
+    DisplayList list(100, 100);
+    draw(list);
+    list.ReplicateWedge(Symmetry(Vector(1, 0.2), true));
+
+    SECTION("Records Every Primitive")
+    {
+        REQUIRE (list.Size() == 4);
+        REQUIRE (list.Points().size() == 1 + 2 + 3);
+        REQUIRE (list.Symmetries().size() == 1);
+        REQUIRE (list.Commands()[0].op == DrawOp::Circle);
+        REQUIRE (list.Commands()[0].size == 9);
+        REQUIRE (list.Commands()[1].op == DrawOp::Line);
+        REQUIRE (list.PointsOf(list.Commands()[1])[1] == Vector(60.5, 58.25));
+        REQUIRE (list.Commands()[2].count == 3);
+        REQUIRE (list.Commands()[3].op == DrawOp::Replicate);
+    }
+
+    SECTION("Replays the Same Pixels")
+    {
+        DisplayList wedge(100, 100);
+        draw(wedge);
+
+        TestCanvas direct(100, 100, 3), replayed(100, 100, 3);
+        SpanRasterizer directRasterizer(direct.buffer), replayedRasterizer(replayed.buffer);
+        draw(directRasterizer);
+        wedge.Execute(replayedRasterizer);
+        REQUIRE (direct.CountLit() > 0);
+        REQUIRE (direct.data == replayed.data);
+    }
+
+    SECTION("Draws the Wedge once per Element of the Symmetry Group")
+    {
+        TestCanvas wedge(100, 100, 3), replayed(100, 100, 3), scaled(100, 100, 3);
+        SpanRasterizer wedgeRasterizer(wedge.buffer), replayedRasterizer(replayed.buffer), scaledRasterizer(scaled.buffer);
+        draw(wedgeRasterizer);
+        list.Execute(replayedRasterizer);
+        list.Execute(scaledRasterizer, 1.0, Vector(0, 0));
+        REQUIRE (replayed.CountLit() > 6 * wedge.CountLit());
+        REQUIRE (replayed.data == scaled.data);
+    }
+
+    SECTION("Masks Match Every Channel of a White Snowflake")
+    {
+        for (const bool antialias : {false, true})
+        {
+            DisplayList white(100, 100);
+            white.DrawLine(Vector(50, 50), Vector(60.5, 58.25), 5, Colour(255, 255, 255));
+            white.FillConvexPolygon({Vector(50, 45), Vector(58, 47), Vector(54, 56)}, Colour(255, 255, 255));
+            white.ReplicateWedge(Symmetry(Vector(1, 0.2), true));
+
+            TestCanvas colour(100, 100, 3), mask(100, 100, 1);
+            SpanRasterizer colourRasterizer(colour.buffer, antialias), maskRasterizer(mask.buffer, antialias);
+            white.Execute(colourRasterizer);
+            white.Execute(maskRasterizer);
+            REQUIRE (mask.CountLit() > 0);
+            for (std::size_t i = 0; i < mask.data.size(); ++i)
+            {
+                REQUIRE (colour.data[3 * i] == mask.data[i]);
+                REQUIRE (colour.data[3 * i + 1] == mask.data[i]);
+                REQUIRE (colour.data[3 * i + 2] == mask.data[i]);
+            }
+        }
+    }
+
+    SECTION("Can Be Reused")
+    {
+        list.Clear();
+        REQUIRE (list.Size() == 0);
+        REQUIRE (list.Points().empty());
+
+        list.FillCircle(Vector(5, 5), 1, white);
+        REQUIRE (list.Size() == 1);
+        REQUIRE (list.Commands()[0].first == 0);
+    }
+}
+
+TEST_CASE( "Scaled Display List", "DisplayList" )
+{
+    const Colour white(255, 255, 255);
+    DisplayList list(100, 100);
+    list.FillCircle(Vector(70, 52), 3, white);
+    list.DrawLine(Vector(55, 50), Vector(75.5, 53.25), 2, white);
+    list.FillConvexPolygon({Vector(60, 48), Vector(66, 50), Vector(62, 55)}, Colour(10, 20, 30));
+    list.ReplicateWedge(Symmetry(Vector(1, 0.2), true));
+    list.FillCircle(Vector(30.7, 40.2), 9, Colour(10, 20, 30));
+
+    SECTION("Scale 1 Replays the Same Pixels without Replication")
+    {
+        DisplayList flat(100, 100);
+        flat.FillCircle(Vector(30.7, 40.2), 9, Colour(10, 20, 30));
+        flat.DrawLine(Vector(50, 50), Vector(60.5, 58.25), 5, white);
+        flat.FillConvexPolygon({Vector(50, 45), Vector(58, 47), Vector(54, 56)}, white);
+
+        TestCanvas direct(100, 100, 3), scaled(100, 100, 3);
+        SpanRasterizer directRasterizer(direct.buffer), scaledRasterizer(scaled.buffer);
+        flat.Execute(directRasterizer);
+        flat.Execute(scaledRasterizer, 1.0, Vector(0, 0));
+        REQUIRE (direct.CountLit() > 0);
+        REQUIRE (direct.data == scaled.data);
+    }
+
+    SECTION("Replicated Copies Land on Every Arm")
+    {
+        TestCanvas canvas(200, 200, 1);
+        SpanRasterizer rasterizer(canvas.buffer);
+        list.Execute(rasterizer, 2.0, Vector(0, 0));
+        for (int k = 0; k < NUM_ARMS; ++k)
+        {
+            const Vector p = 2.0 * (Vector::RotateArm(Vector(20, 2), k) + Vector(50, 50));
+            REQUIRE (canvas.data[static_cast<int>(p.y) * 200 + static_cast<int>(p.x)] != 0);
+        }
+    }
+
+    SECTION("Strips Match the Whole Image")
+    {
+        for (const bool antialias : {false, true})
+        {
+            constexpr int SIZE = 250, STRIP_ROWS = 40;
+            TestCanvas whole(SIZE, SIZE, 3);
+            SpanRasterizer wholeRasterizer(whole.buffer, antialias);
+            list.Execute(wholeRasterizer, 2.5, Vector(0, 0));
+            REQUIRE (whole.CountLit() > 0);
+
+            for (int y0 = 0; y0 < SIZE; y0 += STRIP_ROWS)
+            {
+                const int rows = std::min(STRIP_ROWS, SIZE - y0);
+                TestCanvas strip(rows, SIZE, 3);
+                SpanRasterizer stripRasterizer(strip.buffer, antialias);
+                list.Execute(stripRasterizer, 2.5, Vector(0, y0));
+                REQUIRE (std::memcmp(strip.data.data(), whole.data.data() + y0 * whole.buffer.step, strip.data.size()) == 0);
+            }
+        }
+    }
+
+    SECTION("Streams Strips to a PNG File")
+    {
+        const std::string filename = (std::filesystem::temp_directory_path() / "testRasterlib-Tiled.png").string();
+        std::string error;
+        REQUIRE (RenderTiledPng(list, 300, 3, false, filename, 2, error));
+
+        std::ifstream file(filename, std::ios::binary);
+        char signature[8] = {};
+        file.read(signature, sizeof(signature));
+        REQUIRE (std::string(signature + 1, 3) == "PNG");
+        std::filesystem::remove(filename);
+
+        REQUIRE_FALSE (RenderTiledPng(list, 300, 2, false, filename, 2, error));
+        REQUIRE_FALSE (error.empty());
+    }
+}
+
+/// @brief Counts the occurrences of a pattern
+static int CountOf(const std::string& text, const std::string& pattern)
+{
+    int count = 0;
+    for (std::size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+TEST_CASE( "SVG Output", "SvgLib" )
+{
+    const Colour white(255, 255, 255);
+    DisplayList list(100, 100);
+
+    SECTION("Writes One Element per Primitive")
+    {
+        list.FillCircle(Vector(30, 40), 9, Colour(10, 20, 30));
+        list.DrawLine(Vector(50, 50), Vector(60, 58), 5, white);
+        list.FillConvexPolygon({Vector(50, 45), Vector(58, 47), Vector(54, 56)}, white);
+
+        std::ostringstream out;
+        REQUIRE (WriteSvg(out, list, "a < b & c"));
+        const std::string svg = out.str();
+        REQUIRE (svg.rfind("<svg", 0) == 0);
+        REQUIRE (CountOf(svg, "<circle cx=\"30\" cy=\"40\" r=\"9\" fill=\"#0a141e\"/>") == 1);
+        REQUIRE (CountOf(svg, "stroke-width=\"6\"/>") == 1);
+        REQUIRE (CountOf(svg, "<polygon points=\"50,45 58,47 54,56\"/>") == 1);
+        REQUIRE (CountOf(svg, "a &lt; b &amp; c") == 1);
+        REQUIRE (CountOf(svg, "<use") == 0);
+    }
+
+    SECTION("Places a Wedge once per Element of the Symmetry Group")
+    {
+        list.FillCircle(Vector(60, 52), 3, white);
+        list.ReplicateWedge(Symmetry(Vector(1, 0), true));
+        list.FillCircle(Vector(70, 52), 3, white);
+        list.ReplicateWedge(Symmetry(Vector(1, 0), false));
+
+        std::ostringstream out;
+        REQUIRE (WriteSvg(out, list));
+        const std::string svg = out.str();
+        REQUIRE (CountOf(svg, "<use href=\"#wedge0\"") == 12);
+        REQUIRE (CountOf(svg, "<use href=\"#wedge1\"") == 6);
+        REQUIRE (CountOf(svg, "<circle") == 2);
+        REQUIRE (CountOf(svg, "rotate(60 50 50)") == 3);
+        REQUIRE (CountOf(svg, "<text") == 0);
+    }
+}
+
+TEST_CASE( "Crystal Growth", "GraphLib" )
+{
+    RandomEngine rng(7, 0, 1);
+    const std::vector<Circle> arm = GenerateCrystalArm(40, 7, 2, rng);
+    const Vector mirror(1, 1.1);
+
+    SECTION("Records the 12 Copies of the New Circles")
+    {
+        DisplayList list(WORLD_SIZE, WORLD_SIZE);
+        DrawCrystalGrowth(list, arm, 10, 15, mirror);
+        REQUIRE (list.Size() == 5 * 2 * NUM_ARMS);
+
+        list.Clear();
+        DrawCrystalGrowth(list, arm, 15, 15, mirror);
+        REQUIRE (list.Size() == 0);
+    }
+
+    SECTION("Grows Into the Whole Snowflake")
+    {
+        TestCanvas whole(WORLD_SIZE, WORLD_SIZE, 3), grown(WORLD_SIZE, WORLD_SIZE, 3);
+        SpanRasterizer wholeRasterizer(whole.buffer), grownRasterizer(grown.buffer);
+        DrawCrystalSnowflake(wholeRasterizer, arm, mirror);
+
+        std::size_t numDrawn = 0;
+        for (const std::size_t numGrown : {1, 9, 10, 27, 40})
+        {
+            DrawCrystalGrowth(grownRasterizer, arm, numDrawn, numGrown, mirror);
+            numDrawn = numGrown;
+        }
+
+        REQUIRE (whole.CountLit() > 0);
+        REQUIRE (whole.data == grown.data);
+    }
+}
+
+TEST_CASE( "Symmetric Drawing", "GraphLib" )
+{
+    RandomEngine rng(7, 0, 1);
+    const std::vector<Circle> arm = GenerateCrystalArm(45, 7, 2, rng);
+
+    // the pixels of a canvas that no pixel of the other canvas within one pixel matches (the copies of the wedge are
+    // rotated by matrices instead of Vector::RotateArm, which may move their edges by a pixel)
+    auto countMismatched = [](const TestCanvas& a, const TestCanvas& b)
+    {
+        const int rows = a.buffer.rows, cols = a.buffer.cols, channels = a.buffer.channels;
+        int count = 0;
+        for (int y = 1; y < rows - 1; ++y)
+        {
+            for (int x = 1; x < cols - 1; ++x)
+            {
+                const unsigned char* p = &a.data[(static_cast<std::size_t>(y) * cols + x) * channels];
+                bool isMatched = false;
+                for (int dy = -1; dy <= 1 && !isMatched; ++dy)
+                {
+                    for (int dx = -1; dx <= 1 && !isMatched; ++dx)
+                    {
+                        isMatched = std::memcmp(p, &b.data[(static_cast<std::size_t>(y + dy) * cols + x + dx) * channels], channels) == 0;
+                    }
+                }
+                count += !isMatched;
+            }
+        }
+        return count;
+    };
+
+    SECTION("D6 Matches Every Primitive up to the Edges")
+    {
+        DisplayList list(WORLD_SIZE, WORLD_SIZE);
+        DrawCrystalSnowflake(list, arm, Vector(0.97, 1.01), true);
+        REQUIRE (list.Commands().back().op == DrawOp::Replicate);
+        REQUIRE (list.Size() < 3 * arm.size());
+
+        TestCanvas direct(WORLD_SIZE, WORLD_SIZE, 1), replicated(WORLD_SIZE, WORLD_SIZE, 1);
+        SpanRasterizer directRasterizer(direct.buffer), replicatedRasterizer(replicated.buffer);
+        DrawCrystalSnowflake(directRasterizer, arm, Vector(0.97, 1.01));
+        list.Execute(replicatedRasterizer);
+        REQUIRE (direct.CountLit() > 0);
+
+        // raster canvases draw every primitive anyway
+        TestCanvas raster(WORLD_SIZE, WORLD_SIZE, 1);
+        SpanRasterizer rasterRasterizer(raster.buffer);
+        DrawCrystalSnowflake(rasterRasterizer, arm, Vector(0.97, 1.01), true);
+        REQUIRE (raster.data == direct.data);
+        REQUIRE (countMismatched(direct, replicated) < direct.CountLit() / 200);
+        REQUIRE (countMismatched(replicated, direct) < direct.CountLit() / 200);
+    }
+
+    SECTION("C6 Matches Every Primitive up to the Edges")
+    {
+        DisplayList list(WORLD_SIZE, WORLD_SIZE);
+        DrawRadiatingDendriteSnowflake(list, Vector(0.97, 1.01), 200, 5, 20, 50, PI / 3, 0.8, true);
+        REQUIRE (list.Commands().back().op == DrawOp::Replicate);
+
+        TestCanvas direct(WORLD_SIZE, WORLD_SIZE, 3), replicated(WORLD_SIZE, WORLD_SIZE, 3);
+        SpanRasterizer directRasterizer(direct.buffer), replicatedRasterizer(replicated.buffer);
+        DrawRadiatingDendriteSnowflake(directRasterizer, Vector(0.97, 1.01), 200, 5, 20, 50, PI / 3, 0.8);
+        list.Execute(replicatedRasterizer);
+        REQUIRE (direct.CountLit() > 0);
+        REQUIRE (countMismatched(direct, replicated) < direct.CountLit() / 200);
+        REQUIRE (countMismatched(replicated, direct) < direct.CountLit() / 200);
+    }
+}
+
+TEST_CASE( "Collision-Free Crystal", "GraphLib" )
+{
+    const Vector mirror(1, 1.1);
+    RandomEngine rng(7, 0, 1);
+    const std::vector<Circle> arm = GenerateCrystalArm(60, 7, 2, mirror, rng);
+
+    // the 12 copies of every circle
+    std::vector<Circle> copies;
+    for (const Circle& circle : arm)
+    {
+        for (int rotation = 0; rotation < NUM_ARMS; ++rotation)
+        {
+            Circle copy = circle;
+            copy.c = Vector::RotateArm(circle.c, rotation);
+            copies.push_back(copy);
+            copy.c = Vector::RotateArm(Vector::Mirror(circle.c, mirror), rotation);
+            copies.push_back(copy);
+        }
+    }
+
+    SECTION("Keeps the Chain")
+    {
+        REQUIRE (arm.size() > 10);
+        REQUIRE (arm[0].c == Vector(0, 0));
+        for (std::size_t i = 1; i < arm.size(); ++i)
+        {
+            REQUIRE ((arm[i].c - arm[i - 1].c).Magnitude() == Approx(arm[i].radius + arm[i - 1].radius));
+        }
+    }
+
+    SECTION("Never Overlaps Outside the Hub")
+    {
+        for (std::size_t i = 0; i < copies.size(); ++i)
+        {
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                if (copies[i].c.Magnitude() < 4 * 7 && copies[j].c.Magnitude() < 4 * 7)
+                    continue;
+
+                REQUIRE ((copies[i].c - copies[j].c).Magnitude() > copies[i].radius + copies[j].radius - 1e-3);
+            }
+        }
+    }
+
+    SECTION("Is the Normal Arm Until the First Collision")
+    {
+        RandomEngine other(7, 0, 1);
+        const std::vector<Circle> normal = GenerateCrystalArm(60, 7, 2, other);
+        REQUIRE (arm[1].c == normal[1].c);
+        REQUIRE (arm[1].radius == normal[1].radius);
+    }
+}
+
+TEST_CASE( "Stamps", "StampLib" )
+{
+    const Colour white(255, 255, 255);
+    auto draw = [&](Rasterizer& canvas, const Vector& offset)
+    {
+        canvas.DrawLine(offset, offset + Vector(20, 0), 3, white);
+        canvas.FillCircle(offset + Vector(20, 0), 4, white);
+    };
+
+    DisplayList shape(100, 100);
+    draw(shape, Vector(0, 0));
+    const auto stamp = std::make_shared<const Stamp>(shape);
+    const Mat2 identity{1, 0, 0, 1};
+
+    SECTION("Boxes the Shape")
+    {
+        REQUIRE (stamp->Lower().x <= -2);
+        REQUIRE (stamp->Lower().y <= -5);
+        REQUIRE (stamp->Upper().x >= 25);
+        REQUIRE (stamp->Upper().y >= 5);
+    }
+
+    SECTION("A Copy without Rotation Is the Shape Itself")
+    {
+        TestCanvas direct(100, 100, 3), stamped(100, 100, 3);
+        SpanRasterizer directRasterizer(direct.buffer), stampedRasterizer(stamped.buffer);
+        draw(directRasterizer, Vector(40, 30));
+        stampedRasterizer.DrawStamp(stamp, identity, Vector(40, 30), white);
+        REQUIRE (direct.CountLit() > 0);
+        REQUIRE (direct.data == stamped.data);
+    }
+
+    SECTION("Display Lists Record and Replay the Copies")
+    {
+        DisplayList list(100, 100);
+        const Mat2 rotation{0, -1, 1, 0};
+        list.DrawStamp(stamp, rotation, Vector(50, 50), Colour(10, 20, 30));
+        list.DrawStamp(stamp, identity, Vector(20, 80), white);
+        REQUIRE (list.Size() == 2);
+        REQUIRE (list.Stamps().size() == 2);
+        REQUIRE (list.Commands()[0].op == DrawOp::Stamp);
+        REQUIRE (list.TransformOf(list.Commands()[0]).b == -1);
+
+        TestCanvas direct(100, 100, 3), replayed(100, 100, 3);
+        SpanRasterizer replayedRasterizer(replayed.buffer);
+        stamp->Blit(direct.buffer, rotation, Vector(50, 50), Colour(10, 20, 30), false);
+        stamp->Blit(direct.buffer, identity, Vector(20, 80), white, false);
+        list.Execute(replayedRasterizer);
+        REQUIRE (direct.CountLit() > 0);
+        REQUIRE (direct.data == replayed.data);
+
+        // scaled replays rasterize the mask at the new scale
+        TestCanvas scaled(200, 200, 3);
+        SpanRasterizer scaledRasterizer(scaled.buffer);
+        list.Execute(scaledRasterizer, 2.0, Vector(0, 0));
+        REQUIRE (scaled.CountLit() > 3 * direct.CountLit());
+    }
+
+    SECTION("SVG Output Refers to One Definition per Stamp")
+    {
+        DisplayList list(100, 100);
+        list.DrawStamp(stamp, identity, Vector(50, 50), white);
+        list.DrawStamp(stamp, identity, Vector(20, 80), white);
+
+        std::ostringstream out;
+        REQUIRE (WriteSvg(out, list));
+        const std::string svg = out.str();
+        REQUIRE (CountOf(svg, "<g id=\"stamp") == 1);
+        REQUIRE (CountOf(svg, "<use href=\"#stamp") == 2);
+        REQUIRE (CountOf(svg, "<circle") == 1);
+    }
+
+    SECTION("Recursive Dendrites Draw Six Copies of One Arm")
+    {
+        const DendriteRule rule{6, 3, {PI / 3}, {0.3}, 0.6};
+        DisplayList list(200, 200);
+        DrawRecursiveDendriteSnowflake(list, Vector(1, 1), 80, 5, rule);
+        REQUIRE (list.Size() == NUM_ARMS);
+        REQUIRE (list.Stamps().size() == NUM_ARMS);
+        REQUIRE (list.Stamps()[0] == list.Stamps()[5]);
+
+        TestCanvas canvas(200, 200, 3);
+        SpanRasterizer rasterizer(canvas.buffer);
+        list.Execute(rasterizer);
+        REQUIRE (canvas.CountLit() > 0);
+    }
+
+    SECTION("Huge Copies Keep the Masks Small")
+    {
+        const DendriteRule rule{3, 4, {PI / 3}, {0.3}, 0.65};
+        DisplayList list(1024, 1024);
+        DrawRecursiveDendriteSnowflake(list, Vector(1, 0), 360, 6, rule);
+
+        // every level copies one stamp of the level below
+        std::vector<const Stamp*> levels;
+        for (const Stamp* s = list.Stamps()[0].get(); s; s = s->Shape().Stamps().empty() ? nullptr : s->Shape().Stamps()[0].get())
+        {
+            levels.push_back(s);
+        }
+
+        // a strip through the center of a 65536 x 65536 image, in both modes
+        const double scale = 64;
+        for (const bool antialias : {false, true})
+        {
+            TestCanvas strip(64, 8192, 1);
+            SpanRasterizer rasterizer(strip.buffer, antialias);
+            list.Execute(rasterizer, scale, Vector(scale * 512 - 1024, scale * 512 - 32));
+            REQUIRE (strip.CountLit() > 0);
+        }
+
+        // the arm is drawn from its primitives, and no level holds more than a mask per mode
+        REQUIRE (levels.size() == 4);
+        REQUIRE (levels[0]->MaskBytes() == 0);
+        for (const Stamp* level : levels)
+        {
+            REQUIRE (level->MaskBytes() <= 2 * STAMP_MAX_MASK_BYTES);
+        }
+    }
+}
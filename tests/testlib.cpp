@@ -1,6 +1,12 @@
 #define CATCH_CONFIG_MAIN
 
+#include <algorithm>  // std::equal
+#include <array>
+#include <cstdint>
+#include <cmath>    // std::sqrt
+#include <cstdlib>  // std::abs
 #include <map>
+#include <vector>
 #include <math.h>   // round
 #include <catch2/catch.hpp>
 
@@ -63,4 +69,205 @@ TEST_CASE( "Boost Normal Distribution", "[main]" )
         REQUIRE (threeSDCnt >= expectedThreeSDCntLow);
         REQUIRE (threeSDCnt <= (expectedThreeSDCnt + TOLERANCE));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Philox4x32", "[main]" )
+{
+    // known answers from the Random123 test vectors
+    SECTION("Zero Counter and Key")
+    {
+        auto ret = Philox4x32({0, 0, 0, 0}, {0, 0});
+        REQUIRE (ret == std::array<std::uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    }
+
+    SECTION("Digits of π")
+    {
+        auto ret = Philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+        REQUIRE (ret == std::array<std::uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+    }
+
+    SECTION("Batch Matches Consecutive Blocks")
+    {
+        // starts right below the carry into the second word
+        constexpr std::size_t NUM_BLOCKS = 19;
+        const std::array<std::uint32_t, 4> counter{0xfffffff8, 0, 3, 1};
+        const std::array<std::uint32_t, 2> key{0xa4093822, 0x299f31d0};
+        std::vector<std::uint32_t> out(4 * NUM_BLOCKS);
+        Philox4x32Batch(counter, key, NUM_BLOCKS, out.data());
+
+        std::uint64_t block = counter[0];
+        for (std::size_t i = 0; i < NUM_BLOCKS; ++i, ++block)
+        {
+            auto ret = Philox4x32({static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32), counter[2], counter[3]}, key);
+            REQUIRE (std::equal(ret.begin(), ret.end(), out.begin() + 4 * i));
+        }
+    }
+}
+
+TEST_CASE( "Random Engine", "[main]" )
+{
+    constexpr int NUM_SAMPLES = 1000;
+    constexpr std::uint64_t seed = 42;
+
+    SECTION("Same Key Gives the Same Sequence")
+    {
+        RandomEngine a(seed, 7, 1), b(seed, 7, 1);
+        for (int i = 0; i < NUM_SAMPLES; i++)
+        {
+            REQUIRE (a.Normal(1, 0.1) == b.Normal(1, 0.1));
+            REQUIRE (a.UniformInt(65, 20) == b.UniformInt(65, 20));
+        }
+    }
+
+    SECTION("Different Keys Give Different Sequences")
+    {
+        RandomEngine a(seed, 7, 1), b(seed, 8, 1), c(seed, 7, 2), d(seed + 1, 7, 1);
+        const auto x = a();
+        REQUIRE (x != b());
+        REQUIRE (x != c());
+        REQUIRE (x != d());
+    }
+
+    SECTION("Uniform Integers Are Within Bounds")
+    {
+        constexpr int low = 15, high = 25;
+        std::map<int, int> hist{};
+        RandomEngine rng(seed);
+        for (int i = 0; i < NUM_SAMPLES; i++)
+        {
+            auto number = rng.UniformInt(high, low);
+            REQUIRE (number >= low);
+            REQUIRE (number <= high);
+            ++hist[number];
+        }
+
+        // every value shows up
+        REQUIRE (hist.size() == high - low + 1);
+    }
+
+    SECTION("Uniform Doubles Are Within [0, 1)")
+    {
+        RandomEngine rng(seed);
+        double sum = 0.0;
+        for (int i = 0; i < NUM_SAMPLES; i++)
+        {
+            auto number = rng.Uniform();
+            REQUIRE (number >= 0.0);
+            REQUIRE (number < 1.0);
+            sum += number;
+        }
+
+        REQUIRE (sum / NUM_SAMPLES == Approx(0.5).margin(0.05));
+    }
+
+    SECTION("Normal Doubles Follow the 68-95-99.7 Rule")
+    {
+        const double mean = 1.0, sd = 0.3;
+        unsigned int oneSDCnt = 0, twoSDCnt = 0, threeSDCnt = 0;
+        RandomEngine rng(seed);
+        for (int i = 0; i < NUM_SAMPLES; i++)
+        {
+            auto z = std::abs(rng.Normal(mean, sd) - mean) / sd;
+            oneSDCnt += (z < 1);
+            twoSDCnt += (z < 2);
+            threeSDCnt += (z < 3);
+        }
+
+        constexpr int TOLERANCE = 0.05 * NUM_SAMPLES;
+        REQUIRE (std::abs(static_cast<int>(oneSDCnt) - static_cast<int>(0.68 * NUM_SAMPLES)) <= TOLERANCE);
+        REQUIRE (std::abs(static_cast<int>(twoSDCnt) - static_cast<int>(0.95 * NUM_SAMPLES)) <= TOLERANCE);
+        REQUIRE (std::abs(static_cast<int>(threeSDCnt) - static_cast<int>(0.997 * NUM_SAMPLES)) <= TOLERANCE);
+    }
+}
+
+TEST_CASE( "Batched Sampling", "[main]" )
+{
+    constexpr int NUM_SAMPLES = 10000;
+    constexpr std::uint64_t seed = 7;
+
+    SECTION("Batched Normals Match the Scalar Ones")
+    {
+        RandomEngine scalar(seed), batched(seed);
+
+        // mixes odd lengths and integers so pairs straddle calls and batches
+        std::vector<double> out(NUM_SAMPLES);
+        std::size_t i = 0;
+        for (std::size_t n : {1, 3, 64, 1, 1000, 7})
+        {
+            batched.FillNormal(out.data() + i, n, 1.0, 0.3);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                REQUIRE (out[i + k] == scalar.Normal(1.0, 0.3));
+            }
+            i += n;
+
+            REQUIRE (batched.UniformInt(65, 20) == scalar.UniformInt(65, 20));
+        }
+    }
+
+    SECTION("Batched Integers Match the Scalar Ones")
+    {
+        RandomEngine scalar(seed), batched(seed);
+        std::vector<int> out(NUM_SAMPLES);
+        batched.FillUniformInt(out.data(), NUM_SAMPLES, 6, 0);
+        for (const auto number : out)
+        {
+            REQUIRE (number == scalar.UniformInt(6, 0));
+        }
+    }
+
+    SECTION("Batched Normals Follow the 68-95-99.7 Rule")
+    {
+        const double mean = 45.0, sd = 10.0;
+        std::vector<double> out(NUM_SAMPLES);
+        RandomEngine(seed).FillNormal(out.data(), NUM_SAMPLES, mean, sd);
+
+        unsigned int oneSDCnt = 0, twoSDCnt = 0, threeSDCnt = 0;
+        double sum = 0.0, sumSq = 0.0;
+        for (const auto number : out)
+        {
+            auto z = std::abs(number - mean) / sd;
+            oneSDCnt += (z < 1);
+            twoSDCnt += (z < 2);
+            threeSDCnt += (z < 3);
+            sum += number;
+            sumSq += number * number;
+        }
+
+        constexpr int TOLERANCE = 0.02 * NUM_SAMPLES;
+        REQUIRE (std::abs(static_cast<int>(oneSDCnt) - static_cast<int>(0.6827 * NUM_SAMPLES)) <= TOLERANCE);
+        REQUIRE (std::abs(static_cast<int>(twoSDCnt) - static_cast<int>(0.9545 * NUM_SAMPLES)) <= TOLERANCE);
+        REQUIRE (std::abs(static_cast<int>(threeSDCnt) - static_cast<int>(0.9973 * NUM_SAMPLES)) <= TOLERANCE);
+
+        const double sampleMean = sum / NUM_SAMPLES;
+        REQUIRE (sampleMean == Approx(mean).margin(0.05 * sd));
+        REQUIRE (std::sqrt(sumSq / NUM_SAMPLES - sampleMean * sampleMean) == Approx(sd).epsilon(0.05));
+    }
+
+    SECTION("Batched Integers Are Uniform")
+    {
+        constexpr int low = 2, high = 7;
+        constexpr int NUM_BINS = high - low + 1;
+        std::vector<int> out(NUM_SAMPLES);
+        RandomEngine(seed).FillUniformInt(out.data(), NUM_SAMPLES, high, low);
+
+        std::map<int, int> hist{};
+        for (const auto number : out)
+        {
+            REQUIRE (number >= low);
+            REQUIRE (number <= high);
+            ++hist[number];
+        }
+
+        // Pearson's chi-squared test with 5 degrees of freedom (critical value 20.5 at p = 0.001)
+        const double expected = static_cast<double>(NUM_SAMPLES) / NUM_BINS;
+        double chiSq = 0.0;
+        for (const auto& [number, cnt] : hist)
+        {
+            chiSq += (cnt - expected) * (cnt - expected) / expected;
+        }
+
+        REQUIRE (hist.size() == NUM_BINS);
+        REQUIRE (chiSq < 20.5);
+    }
+}